@@ -0,0 +1,799 @@
+// Developer Bastian © 2024
+// License Creative Commons DEED 4.0 (https://creativecommons.org/licenses/by-sa/4.0/deed.en)
+
+#include "ContainerBenchmark.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Async/ParallelFor.h"
+#include "ContainerGroupBy.h"
+#include "TArray.h"
+#include "TColumnarArray.h"
+#include "TMap.h"
+#include "TBucketedMultiMap.h"
+#include "TMultiMap.h"
+#include "TQueue.h"
+#include "TRingQueue.h"
+#include "TSet.h"
+#include "TSortedSet.h"
+#include "TStack.h"
+#include "Timer.h"
+
+namespace
+{
+	// hash based lookups and removes are timed on this many rows
+	constexpr int32 HashSamples = 10000;
+	// Array_Contains and Array_Remove scan the whole array, so they only get a few samples
+	constexpr int32 LinearSamples = 100;
+
+	template <typename FunctionType>
+	double MeasureMilliseconds(FunctionType&& Function)
+	{
+		Timer t;
+		t.Start();
+		Function();
+		return t.StopNanoseconds() / 1000000.0;
+	}
+
+	void AddResult(TArray<FContainerBenchmarkResult>& Results, const TCHAR* Container, const TCHAR* Operation
+		, int32 Rows, int32 Calls, double Milliseconds)
+	{
+		FContainerBenchmarkResult& Result = Results.AddDefaulted_GetRef();
+		Result.Container = Container;
+		Result.Operation = Operation;
+		Result.Rows = Rows;
+		Result.Calls = Calls;
+		Result.TotalMilliseconds = Milliseconds;
+		Result.NanosecondsPerElement = Calls > 0 ? Milliseconds * 1000000.0 / Calls : 0.0;
+		UE_LOG(LogTemp, Display, TEXT("ContainerBenchmark: %-16s %-20s rows %9d calls %9d %12.3f ms %12.1f ns/element")
+			, Container, Operation, Rows, Calls, Milliseconds, Result.NanosecondsPerElement);
+	}
+
+	// spreads Samples indices evenly over [0, Num)
+	FORCEINLINE int32 SampleIndex(int32 Sample, int32 Samples, int32 Num)
+	{
+		return (int32)(((int64)Sample * Num) / Samples);
+	}
+
+	FString ResolveBenchmarkPath(const FString& FilePath)
+	{
+		if (FPaths::IsRelative(FilePath))
+			return FPaths::Combine(FPaths::ProjectSavedDir(), FilePath);
+		return FilePath;
+	}
+}
+
+#pragma region Dataset
+FString FContainerBenchmark::GetDefaultDatasetPath()
+{
+	return FContainerCsvLoader::ResolvePath(FString());
+}
+
+bool FContainerBenchmark::LoadDataset(const FString& Path, TArray<FContainerCsvRow>& OutRows)
+{
+	FContainerCsvLoadReport Report;
+	return FContainerCsvLoader::Load(Path, OutRows, Report) && OutRows.Num() > 0;
+}
+
+void FContainerBenchmark::ScaleDataset(const TArray<FContainerCsvRow>& Source, int32 Rows, TArray<FContainerCsvRow>& OutRows)
+{
+	OutRows.Reset(Rows);
+	if (Source.Num() == 0)
+		return;
+	for (int32 i = 0; i < Rows; ++i)
+	{
+		const int32 Copy = i / Source.Num();
+		const FContainerCsvRow& Original = Source[i % Source.Num()];
+		FContainerCsvRow& Row = OutRows.AddDefaulted_GetRef();
+		Row.Name = Copy == 0 ? Original.Name : FString::Printf(TEXT("%s#%d"), *Original.Name, Copy);
+		Row.Number = Original.Number + Copy;
+	}
+}
+#pragma endregion Dataset
+
+#pragma region Benchmarks
+void FContainerBenchmark::RunArray(const TArray<FContainerCsvRow>& Rows, TArray<FContainerBenchmarkResult>& Results)
+{
+	const int32 Num = Rows.Num();
+	TArray<FTArrayTestStruct> Values;
+	Values.SetNum(Num);
+	for (int32 i = 0; i < Num; ++i)
+	{
+		Values[i].Name = Rows[i].Name;
+		Values[i].Number = Rows[i].Number;
+	}
+	UTArray* Array = NewObject<UTArray>();
+	FString Prefix = TEXT("x");
+	const int32 Samples = FMath::Min(Num, LinearSamples);
+
+	AddResult(Results, TEXT("UTArray"), TEXT("Add"), Num, Num, MeasureMilliseconds([&]()
+	{
+		for (FTArrayTestStruct& Value : Values)
+			Array->Array_Add(Value, false);
+	}));
+	AddResult(Results, TEXT("UTArray"), TEXT("Lookup"), Num, Samples, MeasureMilliseconds([&]()
+	{
+		for (int32 i = 0; i < Samples; ++i)
+			Array->Array_Contains(Values[SampleIndex(i, Samples, Num)]);
+	}));
+	// the first prefix query builds the name index, the second one is served by it
+	AddResult(Results, TEXT("UTArray"), TEXT("Filter"), Num, Num, MeasureMilliseconds([&]()
+	{
+		Array->Array_GetNamesStartingWith(TEXT("San"));
+	}));
+	AddResult(Results, TEXT("UTArray"), TEXT("FilterNumber"), Num, Num, MeasureMilliseconds([&]()
+	{
+		Array->Array_FilterByNumber(1000000, MAX_int32);
+	}));
+	AddResult(Results, TEXT("UTArray"), TEXT("FilterIndexed"), Num, Num, MeasureMilliseconds([&]()
+	{
+		Array->Array_GetNamesStartingWith(TEXT("San"));
+	}));
+	AddResult(Results, TEXT("UTArray"), TEXT("SortByNumber"), Num, Num, MeasureMilliseconds([&]()
+	{
+		Array->Array_Sort(ETestArraySorting::E_NumberAsc);
+	}));
+	AddResult(Results, TEXT("UTArray"), TEXT("SortByName"), Num, Num, MeasureMilliseconds([&]()
+	{
+		Array->Array_Sort(ETestArraySorting::E_NameAsc);
+	}));
+	AddResult(Results, TEXT("UTArray"), TEXT("ParallelSortByNumber"), Num, Num, MeasureMilliseconds([&]()
+	{
+		Array->Array_Sort(ETestArraySorting::E_NumberAsc, EContainerSortBackend::E_Parallel);
+	}));
+	AddResult(Results, TEXT("UTArray"), TEXT("ParallelSortByName"), Num, Num, MeasureMilliseconds([&]()
+	{
+		Array->Array_Sort(ETestArraySorting::E_NameAsc, EContainerSortBackend::E_Parallel);
+	}));
+	AddResult(Results, TEXT("UTArray"), TEXT("Iterate"), Num, Num, MeasureMilliseconds([&]()
+	{
+		Array->Array_Iterate(Prefix);
+	}));
+	// the names carry the prefix now, so this measures the parallel pass that only checks them
+	AddResult(Results, TEXT("UTArray"), TEXT("Rename"), Num, Num, MeasureMilliseconds([&]()
+	{
+		Array->Array_TransformNames(EContainerStringTransform::E_Prefix, Prefix, FString(), true);
+	}));
+	AddResult(Results, TEXT("UTArray"), TEXT("Remove"), Num, Samples, MeasureMilliseconds([&]()
+	{
+		for (int32 i = 0; i < Samples; ++i)
+			Array->Array_Remove(Values[SampleIndex(i, Samples, Num)], false);
+	}));
+	Array->Array_Empty(0, false);
+
+	// the copy is made outside of the measurement, only the move into the container is timed
+	TArray<FTArrayTestStruct> Batch = Values;
+	AddResult(Results, TEXT("UTArray"), TEXT("BulkAdd"), Num, Num, MeasureMilliseconds([&]()
+	{
+		Array->Array_AppendMoved(MoveTemp(Batch), false);
+	}));
+	TArray<int32> Positions;
+	for (int32 i = 0; i < Samples; ++i)
+		Positions.Add(SampleIndex(i, Samples, Num));
+	AddResult(Results, TEXT("UTArray"), TEXT("BulkRemove"), Num, Samples, MeasureMilliseconds([&]()
+	{
+		Array->Array_RemoveAtBatch(Positions, false);
+	}));
+	Array->Array_Empty(0, false);
+}
+
+void FContainerBenchmark::RunMap(const TArray<FContainerCsvRow>& Rows, TArray<FContainerBenchmarkResult>& Results)
+{
+	const int32 Num = Rows.Num();
+	TArray<FMapTestStruct> Values;
+	Values.SetNum(Num);
+	for (int32 i = 0; i < Num; ++i)
+	{
+		Values[i].Guid = FGuid::NewGuid();
+		Values[i].Name = Rows[i].Name;
+		Values[i].Number = Rows[i].Number;
+	}
+	UTMap* Map = NewObject<UTMap>();
+	FString Prefix = TEXT("x");
+	const int32 Samples = FMath::Min(Num, HashSamples);
+
+	AddResult(Results, TEXT("UTMap"), TEXT("Add"), Num, Num, MeasureMilliseconds([&]()
+	{
+		for (FMapTestStruct& Value : Values)
+			Map->Map_Add(Value, false);
+	}));
+	AddResult(Results, TEXT("UTMap"), TEXT("Lookup"), Num, Samples, MeasureMilliseconds([&]()
+	{
+		for (int32 i = 0; i < Samples; ++i)
+			Map->Map_GetValue(Values[SampleIndex(i, Samples, Num)].Guid);
+	}));
+	AddResult(Results, TEXT("UTMap"), TEXT("Filter"), Num, Num, MeasureMilliseconds([&]()
+	{
+		Map->Map_FilterCities(1000000);
+	}));
+	AddResult(Results, TEXT("UTMap"), TEXT("IndexBuild"), Num, Num, MeasureMilliseconds([&]()
+	{
+		Map->Map_SetPopulationIndexEnabled(true);
+	}));
+	AddResult(Results, TEXT("UTMap"), TEXT("FilterIndexed"), Num, Num, MeasureMilliseconds([&]()
+	{
+		Map->Map_FilterCities(1000000);
+	}));
+	AddResult(Results, TEXT("UTMap"), TEXT("RangeIndexed"), Num, Num, MeasureMilliseconds([&]()
+	{
+		Map->Map_GetKeysInPopulationRange(100000, 500000);
+	}));
+	Map->Map_SetPopulationIndexEnabled(false);
+	AddResult(Results, TEXT("UTMap"), TEXT("SortByNumber"), Num, Num, MeasureMilliseconds([&]()
+	{
+		Map->Map_ValueSort(ETestMapSorting::E_NumberAsc);
+	}));
+	AddResult(Results, TEXT("UTMap"), TEXT("SortByName"), Num, Num, MeasureMilliseconds([&]()
+	{
+		Map->Map_ValueSort(ETestMapSorting::E_NameAsc);
+	}));
+	AddResult(Results, TEXT("UTMap"), TEXT("ParallelSortByNumber"), Num, Num, MeasureMilliseconds([&]()
+	{
+		Map->Map_ValueSort(ETestMapSorting::E_NumberAsc, EContainerSortBackend::E_Parallel);
+	}));
+	AddResult(Results, TEXT("UTMap"), TEXT("ParallelSortByName"), Num, Num, MeasureMilliseconds([&]()
+	{
+		Map->Map_ValueSort(ETestMapSorting::E_NameAsc, EContainerSortBackend::E_Parallel);
+	}));
+	AddResult(Results, TEXT("UTMap"), TEXT("SortByKey"), Num, Num, MeasureMilliseconds([&]()
+	{
+		Map->Map_KeySort();
+	}));
+	AddResult(Results, TEXT("UTMap"), TEXT("Iterate"), Num, Num, MeasureMilliseconds([&]()
+	{
+		Map->Map_Iterate(Prefix);
+	}));
+	AddResult(Results, TEXT("UTMap"), TEXT("Remove"), Num, Samples, MeasureMilliseconds([&]()
+	{
+		for (int32 i = 0; i < Samples; ++i)
+			Map->Map_Remove(Values[SampleIndex(i, Samples, Num)].Guid, false);
+	}));
+	Map->Map_Empty(0);
+
+	TArray<FMapTestStruct> Batch = Values;
+	AddResult(Results, TEXT("UTMap"), TEXT("BulkAdd"), Num, Num, MeasureMilliseconds([&]()
+	{
+		Map->Map_AppendMoved(MoveTemp(Batch), false);
+	}));
+	TArray<FGuid> Keys;
+	for (int32 i = 0; i < Samples; ++i)
+		Keys.Add(Values[SampleIndex(i, Samples, Num)].Guid);
+	AddResult(Results, TEXT("UTMap"), TEXT("BulkRemove"), Num, Samples, MeasureMilliseconds([&]()
+	{
+		Map->Map_RemoveBatch(Keys, false);
+	}));
+	Map->Map_Empty(0);
+}
+
+// UTMultiMap and UTBucketedMultiMap share their interface, so both run the same operations
+template <typename MultiMapType>
+void FContainerBenchmark::RunMultiMap(const TCHAR* Container, const TArray<FContainerCsvRow>& Rows, TArray<FContainerBenchmarkResult>& Results)
+{
+	const int32 Num = Rows.Num();
+	// about ten values per key
+	const int32 NumKeys = FMath::Max(1, Num / 10);
+	TArray<FGuid> Keys;
+	Keys.SetNum(NumKeys);
+	for (FGuid& Key : Keys)
+		Key = FGuid::NewGuid();
+	TArray<FTMultiMapTestStruct> Values;
+	Values.SetNum(Num);
+	for (int32 i = 0; i < Num; ++i)
+	{
+		Values[i].Guid = Keys[i % NumKeys];
+		Values[i].Name = Rows[i].Name;
+		Values[i].Number = Rows[i].Number;
+	}
+	MultiMapType* MultiMap = NewObject<MultiMapType>();
+	const int32 Samples = FMath::Min(NumKeys, HashSamples);
+
+	AddResult(Results, Container, TEXT("Add"), Num, Num, MeasureMilliseconds([&]()
+	{
+		for (FTMultiMapTestStruct& Value : Values)
+			MultiMap->MM_Add(Value.Guid, Value);
+	}));
+	AddResult(Results, Container, TEXT("Lookup"), Num, Samples, MeasureMilliseconds([&]()
+	{
+		for (int32 i = 0; i < Samples; ++i)
+			MultiMap->MM_MultiFind(Keys[SampleIndex(i, Samples, NumKeys)]);
+	}));
+	AddResult(Results, Container, TEXT("CountPerKey"), Num, Samples, MeasureMilliseconds([&]()
+	{
+		for (int32 i = 0; i < Samples; ++i)
+			MultiMap->MM_NumberOfValues(Keys[SampleIndex(i, Samples, NumKeys)]);
+	}));
+	AddResult(Results, Container, TEXT("Iterate"), Num, Num, MeasureMilliseconds([&]()
+	{
+		MultiMap->MM_GetAllValues();
+	}));
+	AddResult(Results, Container, TEXT("Remove"), Num, Samples, MeasureMilliseconds([&]()
+	{
+		for (int32 i = 0; i < Samples; ++i)
+			MultiMap->MM_RemoveAll(Keys[SampleIndex(i, Samples, NumKeys)]);
+	}));
+	MultiMap->MM_Empty(0);
+
+	TArray<FTMultiMapTestStruct> Batch = Values;
+	AddResult(Results, Container, TEXT("BulkAdd"), Num, Num, MeasureMilliseconds([&]()
+	{
+		MultiMap->MM_AppendMoved(MoveTemp(Batch));
+	}));
+	TArray<FGuid> RemoveKeys;
+	for (int32 i = 0; i < Samples; ++i)
+		RemoveKeys.Add(Keys[SampleIndex(i, Samples, NumKeys)]);
+	AddResult(Results, Container, TEXT("BulkRemove"), Num, Samples, MeasureMilliseconds([&]()
+	{
+		MultiMap->MM_RemoveBatch(RemoveKeys, false);
+	}));
+	MultiMap->MM_Empty(0);
+
+	Batch = Values;
+	AddResult(Results, Container, TEXT("GroupBy"), Num, Num, MeasureMilliseconds([&]()
+	{
+		FContainerGroupBy::IntoMultiMap(*MultiMap, MoveTemp(Batch), [](const FTMultiMapTestStruct& Value) { return Value.Guid; }, false);
+	}));
+	MultiMap->MM_Empty(0);
+}
+
+void FContainerBenchmark::RunSet(const TArray<FContainerCsvRow>& Rows, TArray<FContainerBenchmarkResult>& Results)
+{
+	const int32 Num = Rows.Num();
+	TArray<FTSetTestStruct> Values;
+	Values.SetNum(Num);
+	for (int32 i = 0; i < Num; ++i)
+	{
+		Values[i].Name = Rows[i].Name;
+		Values[i].Number = Rows[i].Number;
+	}
+	UTSet* Set = NewObject<UTSet>();
+	const int32 Samples = FMath::Min(Num, HashSamples);
+
+	AddResult(Results, TEXT("UTSet"), TEXT("Add"), Num, Num, MeasureMilliseconds([&]()
+	{
+		for (FTSetTestStruct& Value : Values)
+			Set->Set_Add(Value);
+	}));
+	AddResult(Results, TEXT("UTSet"), TEXT("Lookup"), Num, Samples, MeasureMilliseconds([&]()
+	{
+		for (int32 i = 0; i < Samples; ++i)
+			Set->Set_ItemExists(Values[SampleIndex(i, Samples, Num)]);
+	}));
+	// the complement of a non-negative number is never in the set
+	TArray<FTSetTestStruct> Misses;
+	Misses.SetNum(Samples);
+	for (int32 i = 0; i < Samples; ++i)
+		Misses[i].Number = ~Values[SampleIndex(i, Samples, Num)].Number;
+	AddResult(Results, TEXT("UTSet"), TEXT("LookupMiss"), Num, Samples, MeasureMilliseconds([&]()
+	{
+		for (FTSetTestStruct& Miss : Misses)
+			Set->Set_ItemExists(Miss);
+	}));
+	// the first check fills the filter, so it is filled before the measurement
+	Set->Set_SetBloomFilterEnabled(true);
+	Set->Set_ItemExists(Misses[0]);
+	AddResult(Results, TEXT("UTSet"), TEXT("BloomLookupMiss"), Num, Samples, MeasureMilliseconds([&]()
+	{
+		for (FTSetTestStruct& Miss : Misses)
+			Set->Set_ItemExists(Miss);
+	}));
+	Set->Set_SetBloomFilterEnabled(false);
+	// the first prefix query builds the name index, the second one is served by it
+	AddResult(Results, TEXT("UTSet"), TEXT("Filter"), Num, Num, MeasureMilliseconds([&]()
+	{
+		Set->Set_GetNamesStartingWith(TEXT("San"));
+	}));
+	AddResult(Results, TEXT("UTSet"), TEXT("FilterNumber"), Num, Num, MeasureMilliseconds([&]()
+	{
+		Set->Set_FilterByNumber(1000000, MAX_int32);
+	}));
+	AddResult(Results, TEXT("UTSet"), TEXT("FilterIndexed"), Num, Num, MeasureMilliseconds([&]()
+	{
+		Set->Set_GetNamesStartingWith(TEXT("San"));
+	}));
+	AddResult(Results, TEXT("UTSet"), TEXT("SortByNumber"), Num, Num, MeasureMilliseconds([&]()
+	{
+		Set->Set_Sort(ETestStructSorting::E_NumberAsc);
+	}));
+	AddResult(Results, TEXT("UTSet"), TEXT("SortByName"), Num, Num, MeasureMilliseconds([&]()
+	{
+		Set->Set_Sort(ETestStructSorting::E_NameAsc);
+	}));
+	AddResult(Results, TEXT("UTSet"), TEXT("ParallelSortByNumber"), Num, Num, MeasureMilliseconds([&]()
+	{
+		Set->Set_Sort(ETestStructSorting::E_NumberAsc, EContainerSortBackend::E_Parallel);
+	}));
+	AddResult(Results, TEXT("UTSet"), TEXT("ParallelSortByName"), Num, Num, MeasureMilliseconds([&]()
+	{
+		Set->Set_Sort(ETestStructSorting::E_NameAsc, EContainerSortBackend::E_Parallel);
+	}));
+	AddResult(Results, TEXT("UTSet"), TEXT("Iterate"), Num, Num, MeasureMilliseconds([&]()
+	{
+		Set->Set_GetAllValues();
+	}));
+	AddResult(Results, TEXT("UTSet"), TEXT("Remove"), Num, Samples, MeasureMilliseconds([&]()
+	{
+		for (int32 i = 0; i < Samples; ++i)
+			Set->Set_Remove(Values[SampleIndex(i, Samples, Num)]);
+	}));
+	Set->Set_Empty(0);
+
+	TArray<FTSetTestStruct> Batch = Values;
+	AddResult(Results, TEXT("UTSet"), TEXT("BulkAdd"), Num, Num, MeasureMilliseconds([&]()
+	{
+		Set->Set_AppendMoved(MoveTemp(Batch), false);
+	}));
+	TArray<FTSetTestStruct> RemoveValues;
+	for (int32 i = 0; i < Samples; ++i)
+		RemoveValues.Add(Values[SampleIndex(i, Samples, Num)]);
+	AddResult(Results, TEXT("UTSet"), TEXT("BulkRemove"), Num, Samples, MeasureMilliseconds([&]()
+	{
+		Set->Set_RemoveBatch(RemoveValues, false);
+	}));
+	Set->Set_Empty(0);
+
+	// every second value in the other set, so both operations have work to do
+	Batch = Values;
+	Set->Set_AppendMoved(MoveTemp(Batch), false);
+	UTSet* Other = NewObject<UTSet>();
+	TArray<FTSetTestStruct> OtherValues;
+	for (int32 i = 0; i < Num; i += 2)
+		OtherValues.Add(Values[i]);
+	Other->Set_AppendMoved(MoveTemp(OtherValues), false);
+	AddResult(Results, TEXT("UTSet"), TEXT("Union"), Num, Num, MeasureMilliseconds([&]()
+	{
+		Set->Set_Union(Other);
+	}));
+	AddResult(Results, TEXT("UTSet"), TEXT("Intersect"), Num, Num, MeasureMilliseconds([&]()
+	{
+		Set->Set_Intersect(Other);
+	}));
+	Set->Set_Empty(0);
+}
+
+void FContainerBenchmark::RunSortedSet(const TArray<FContainerCsvRow>& Rows, TArray<FContainerBenchmarkResult>& Results)
+{
+	const int32 Num = Rows.Num();
+	TArray<FTSetTestStruct> Values;
+	Values.SetNum(Num);
+	for (int32 i = 0; i < Num; ++i)
+	{
+		Values[i].Name = Rows[i].Name;
+		Values[i].Number = Rows[i].Number;
+	}
+	UTSortedSet* Set = NewObject<UTSortedSet>();
+	const int32 Samples = FMath::Min(Num, HashSamples);
+
+	AddResult(Results, TEXT("UTSortedSet"), TEXT("Add"), Num, Num, MeasureMilliseconds([&]()
+	{
+		for (FTSetTestStruct& Value : Values)
+			Set->SortedSet_Add(Value);
+	}));
+	AddResult(Results, TEXT("UTSortedSet"), TEXT("Lookup"), Num, Samples, MeasureMilliseconds([&]()
+	{
+		FTSetTestStruct Found;
+		for (int32 i = 0; i < Samples; ++i)
+			Set->SortedSet_LowerBound(Values[SampleIndex(i, Samples, Num)], Found);
+	}));
+	// a tenth of the number range around its middle
+	FTSetTestStruct First, Last;
+	Set->SortedSet_First(First);
+	Set->SortedSet_Last(Last);
+	const int32 Width = (int32)(((int64)Last.Number - First.Number) / 10);
+	const int32 Middle = (int32)(((int64)First.Number + Last.Number) / 2);
+	AddResult(Results, TEXT("UTSortedSet"), TEXT("Range"), Num, Num, MeasureMilliseconds([&]()
+	{
+		Set->SortedSet_GetNumberRange(Middle - Width / 2, Middle + Width / 2);
+	}));
+	AddResult(Results, TEXT("UTSortedSet"), TEXT("Iterate"), Num, Num, MeasureMilliseconds([&]()
+	{
+		Set->SortedSet_GetAllValues();
+	}));
+	AddResult(Results, TEXT("UTSortedSet"), TEXT("Remove"), Num, Samples, MeasureMilliseconds([&]()
+	{
+		for (int32 i = 0; i < Samples; ++i)
+			Set->SortedSet_Remove(Values[SampleIndex(i, Samples, Num)]);
+	}));
+	Set->SortedSet_Empty();
+
+	TArray<FTSetTestStruct> Batch = Values;
+	AddResult(Results, TEXT("UTSortedSet"), TEXT("BulkAdd"), Num, Num, MeasureMilliseconds([&]()
+	{
+		Set->SortedSet_Append(Batch, false);
+	}));
+	Set->SortedSet_Empty();
+}
+
+void FContainerBenchmark::RunQueue(const TArray<FContainerCsvRow>& Rows, TArray<FContainerBenchmarkResult>& Results)
+{
+	const int32 Num = Rows.Num();
+	TArray<FQueueTestStruct> Values;
+	Values.SetNum(Num);
+	for (int32 i = 0; i < Num; ++i)
+	{
+		Values[i].Name = Rows[i].Name;
+		Values[i].Number = Rows[i].Number;
+	}
+	UTQueue* Queue = NewObject<UTQueue>();
+	const int32 Samples = FMath::Min(Num, HashSamples);
+
+	AddResult(Results, TEXT("UTQueue"), TEXT("Add"), Num, Num, MeasureMilliseconds([&]()
+	{
+		for (FQueueTestStruct& Value : Values)
+			Queue->Enqueue(Value);
+	}));
+	AddResult(Results, TEXT("UTQueue"), TEXT("Lookup"), Num, Samples, MeasureMilliseconds([&]()
+	{
+		for (int32 i = 0; i < Samples; ++i)
+			Queue->Peek();
+	}));
+	AddResult(Results, TEXT("UTQueue"), TEXT("Remove"), Num, Num, MeasureMilliseconds([&]()
+	{
+		while (!Queue->IsEmpty())
+			Queue->Dequeue();
+	}));
+}
+
+void FContainerBenchmark::RunStack(const TArray<FContainerCsvRow>& Rows, TArray<FContainerBenchmarkResult>& Results)
+{
+	const int32 Num = Rows.Num();
+	TArray<FStackTestStruct> Values;
+	Values.SetNum(Num);
+	for (int32 i = 0; i < Num; ++i)
+	{
+		Values[i].Name = Rows[i].Name;
+		Values[i].Number = Rows[i].Number;
+	}
+	UTStack* Stack = NewObject<UTStack>();
+
+	AddResult(Results, TEXT("UTStack"), TEXT("Add"), Num, Num, MeasureMilliseconds([&]()
+	{
+		for (FStackTestStruct& Value : Values)
+			Stack->Push(Value);
+	}));
+	AddResult(Results, TEXT("UTStack"), TEXT("Remove"), Num, Num, MeasureMilliseconds([&]()
+	{
+		FStackTestStruct Value;
+		while (Stack->Pop(Value))
+		{
+		}
+	}));
+
+	// every worker pushes and pops its share of the rows, once on the lock-free stack
+	// and once on the array behind a lock that the Blueprint stack amounts to
+	const int32 NumTasks = FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+	AddResult(Results, TEXT("UTStack"), TEXT("ContendedPushPop"), Num, Num, MeasureMilliseconds([&]()
+	{
+		ParallelFor(NumTasks, [&](int32 Task)
+		{
+			FStackTestStruct Value;
+			for (int32 i = Task; i < Num; i += NumTasks)
+			{
+				Stack->Push(Values[i]);
+				Stack->Pop(Value);
+			}
+		});
+	}));
+	TArray<FStackTestStruct> LockedArray;
+	FCriticalSection ArrayLock;
+	AddResult(Results, TEXT("TArray+Lock"), TEXT("ContendedPushPop"), Num, Num, MeasureMilliseconds([&]()
+	{
+		ParallelFor(NumTasks, [&](int32 Task)
+		{
+			FStackTestStruct Value;
+			for (int32 i = Task; i < Num; i += NumTasks)
+			{
+				{
+					FScopeLock Lock(&ArrayLock);
+					LockedArray.Push(Values[i]);
+				}
+				FScopeLock Lock(&ArrayLock);
+				if (LockedArray.Num() > 0)
+					Value = LockedArray.Pop(false);
+			}
+		});
+	}));
+}
+
+void FContainerBenchmark::RunRingQueue(const TArray<FContainerCsvRow>& Rows, TArray<FContainerBenchmarkResult>& Results)
+{
+	const int32 Num = Rows.Num();
+	TArray<FQueueTestStruct> Values;
+	Values.SetNum(Num);
+	for (int32 i = 0; i < Num; ++i)
+	{
+		Values[i].Name = Rows[i].Name;
+		Values[i].Number = Rows[i].Number;
+	}
+	UTRingQueue* Queue = NewObject<UTRingQueue>();
+	// large enough for all rows, so nothing is rejected and the numbers compare with UTQueue
+	Queue->RingQueue_SetCapacity(Num);
+	const int32 Samples = FMath::Min(Num, HashSamples);
+
+	AddResult(Results, TEXT("UTRingQueue"), TEXT("Add"), Num, Num, MeasureMilliseconds([&]()
+	{
+		for (FQueueTestStruct& Value : Values)
+			Queue->Enqueue(Value);
+	}));
+	AddResult(Results, TEXT("UTRingQueue"), TEXT("Lookup"), Num, Samples, MeasureMilliseconds([&]()
+	{
+		for (int32 i = 0; i < Samples; ++i)
+			Queue->Peek();
+	}));
+	AddResult(Results, TEXT("UTRingQueue"), TEXT("Remove"), Num, Num, MeasureMilliseconds([&]()
+	{
+		while (!Queue->IsEmpty())
+			Queue->Dequeue();
+	}));
+
+	TArray<FQueueTestStruct> Batch = Values;
+	AddResult(Results, TEXT("UTRingQueue"), TEXT("BulkAdd"), Num, Num, MeasureMilliseconds([&]()
+	{
+		Queue->EnqueueBatch(Batch);
+	}));
+	AddResult(Results, TEXT("UTRingQueue"), TEXT("BulkRemove"), Num, Num, MeasureMilliseconds([&]()
+	{
+		Queue->DequeueBatch(Num);
+	}));
+}
+
+void FContainerBenchmark::RunColumnarArray(const TArray<FContainerCsvRow>& Rows, TArray<FContainerBenchmarkResult>& Results)
+{
+	const int32 Num = Rows.Num();
+	TArray<FTArrayTestStruct> Values;
+	Values.SetNum(Num);
+	for (int32 i = 0; i < Num; ++i)
+	{
+		Values[i].Name = Rows[i].Name;
+		Values[i].Number = Rows[i].Number;
+	}
+	UTColumnarArray* Array = NewObject<UTColumnarArray>();
+	const int32 Samples = FMath::Min(Num, LinearSamples);
+
+	// the copy is made outside of the measurement, only splitting it into the columns is timed
+	TArray<FTArrayTestStruct> Batch = Values;
+	AddResult(Results, TEXT("UTColumnarArray"), TEXT("BulkAdd"), Num, Num, MeasureMilliseconds([&]()
+	{
+		Array->Columnar_AppendMoved(MoveTemp(Batch), false);
+	}));
+	AddResult(Results, TEXT("UTColumnarArray"), TEXT("Lookup"), Num, Samples, MeasureMilliseconds([&]()
+	{
+		for (int32 i = 0; i < Samples; ++i)
+			Array->Columnar_Contains(Values[SampleIndex(i, Samples, Num)]);
+	}));
+	AddResult(Results, TEXT("UTColumnarArray"), TEXT("Filter"), Num, Num, MeasureMilliseconds([&]()
+	{
+		Array->Columnar_GetRowsWithNumberAbove(1000000);
+	}));
+	AddResult(Results, TEXT("UTColumnarArray"), TEXT("Aggregate"), Num, Num, MeasureMilliseconds([&]()
+	{
+		Array->Columnar_SumNumbers();
+	}));
+	AddResult(Results, TEXT("UTColumnarArray"), TEXT("SortByNumber"), Num, Num, MeasureMilliseconds([&]()
+	{
+		Array->Columnar_Sort(ETestArraySorting::E_NumberAsc);
+	}));
+	AddResult(Results, TEXT("UTColumnarArray"), TEXT("SortByName"), Num, Num, MeasureMilliseconds([&]()
+	{
+		Array->Columnar_Sort(ETestArraySorting::E_NameAsc);
+	}));
+	AddResult(Results, TEXT("UTColumnarArray"), TEXT("Rename"), Num, Num, MeasureMilliseconds([&]()
+	{
+		Array->Columnar_TransformNames(EContainerStringTransform::E_Prefix, TEXT("City_"), FString(), false);
+	}));
+	AddResult(Results, TEXT("UTColumnarArray"), TEXT("Remove"), Num, Samples, MeasureMilliseconds([&]()
+	{
+		for (int32 i = 0; i < Samples; ++i)
+			Array->Columnar_Remove(Values[SampleIndex(i, Samples, Num)], false);
+	}));
+	Array->Columnar_Empty(0, false);
+}
+
+TArray<FContainerBenchmarkResult> FContainerBenchmark::Run(const TArray<FContainerCsvRow>& Dataset, const TArray<int32>& RowCounts)
+{
+	TArray<FContainerBenchmarkResult> Results;
+	TArray<FContainerCsvRow> Rows;
+	for (const int32 RowCount : RowCounts)
+	{
+		if (RowCount <= 0)
+			continue;
+		ScaleDataset(Dataset, RowCount, Rows);
+		// one container at a time, so the largest row counts fit into memory
+		RunArray(Rows, Results);
+		RunColumnarArray(Rows, Results);
+		RunMap(Rows, Results);
+		RunMultiMap<UTMultiMap>(TEXT("UTMultiMap"), Rows, Results);
+		RunMultiMap<UTBucketedMultiMap>(TEXT("UTBucketedMultiMap"), Rows, Results);
+		RunSet(Rows, Results);
+		RunSortedSet(Rows, Results);
+		RunQueue(Rows, Results);
+		RunRingQueue(Rows, Results);
+		RunStack(Rows, Results);
+	}
+	return Results;
+}
+#pragma endregion Benchmarks
+
+#pragma region Results
+FString FContainerBenchmark::ToCSV(const TArray<FContainerBenchmarkResult>& Results)
+{
+	FString CSV = TEXT("Container,Operation,Rows,Calls,TotalMs,NsPerElement\n");
+	for (const FContainerBenchmarkResult& Result : Results)
+	{
+		CSV += FString::Printf(TEXT("%s,%s,%d,%d,%.4f,%.2f\n"), *Result.Container, *Result.Operation
+			, Result.Rows, Result.Calls, Result.TotalMilliseconds, Result.NanosecondsPerElement);
+	}
+	return CSV;
+}
+
+FString FContainerBenchmark::ToJSON(const TArray<FContainerBenchmarkResult>& Results)
+{
+	TArray<FString> Entries;
+	for (const FContainerBenchmarkResult& Result : Results)
+	{
+		Entries.Add(FString::Printf(TEXT("\t{\"container\": \"%s\", \"operation\": \"%s\", \"rows\": %d, \"calls\": %d, \"total_ms\": %.4f, \"ns_per_element\": %.2f}")
+			, *Result.Container, *Result.Operation, Result.Rows, Result.Calls, Result.TotalMilliseconds, Result.NanosecondsPerElement));
+	}
+	return TEXT("[\n") + FString::Join(Entries, TEXT(",\n")) + TEXT("\n]\n");
+}
+
+bool FContainerBenchmark::LoadCSV(const FString& Path, TArray<FContainerBenchmarkResult>& OutResults)
+{
+	TArray<FString> Lines;
+	if (!FFileHelper::LoadFileToStringArray(Lines, *Path))
+		return false;
+	OutResults.Reset();
+	TArray<FString> Columns;
+	for (int32 i = 1; i < Lines.Num(); ++i)
+	{
+		Lines[i].ParseIntoArray(Columns, TEXT(","), false);
+		if (Columns.Num() < 6)
+			continue;
+		FContainerBenchmarkResult& Result = OutResults.AddDefaulted_GetRef();
+		Result.Container = Columns[0];
+		Result.Operation = Columns[1];
+		Result.Rows = FCString::Atoi(*Columns[2]);
+		Result.Calls = FCString::Atoi(*Columns[3]);
+		Result.TotalMilliseconds = FCString::Atod(*Columns[4]);
+		Result.NanosecondsPerElement = FCString::Atod(*Columns[5]);
+	}
+	return true;
+}
+
+int32 FContainerBenchmark::FindRegressions(const TArray<FContainerBenchmarkResult>& Results, const TArray<FContainerBenchmarkResult>& Baseline
+	, double Tolerance, TArray<FString>& OutMessages)
+{
+	int32 Regressions = 0;
+	for (const FContainerBenchmarkResult& Result : Results)
+	{
+		const FContainerBenchmarkResult* Base = Baseline.FindByPredicate([&Result](const FContainerBenchmarkResult& Candidate)
+		{
+			return Candidate.Rows == Result.Rows && Candidate.Container == Result.Container && Candidate.Operation == Result.Operation;
+		});
+		if (Base == nullptr || Base->NanosecondsPerElement <= 0.0)
+			continue;
+		if (Result.NanosecondsPerElement > Base->NanosecondsPerElement * (1.0 + Tolerance))
+		{
+			++Regressions;
+			OutMessages.Add(FString::Printf(TEXT("%s %s at %d rows: %.2f ns/element, baseline %.2f ns/element (+%.0f%%)")
+				, *Result.Container, *Result.Operation, Result.Rows, Result.NanosecondsPerElement, Base->NanosecondsPerElement
+				, (Result.NanosecondsPerElement / Base->NanosecondsPerElement - 1.0) * 100.0));
+		}
+	}
+	return Regressions;
+}
+#pragma endregion Results
+
+TArray<FContainerBenchmarkResult> UContainerBenchmarkLibrary::Benchmark_Run(const TArray<int32>& RowCounts)
+{
+	TArray<FContainerCsvRow> Dataset;
+	if (!FContainerBenchmark::LoadDataset(FContainerBenchmark::GetDefaultDatasetPath(), Dataset))
+		return TArray<FContainerBenchmarkResult>();
+	return FContainerBenchmark::Run(Dataset, RowCounts);
+}
+
+bool UContainerBenchmarkLibrary::Benchmark_Save(const TArray<FContainerBenchmarkResult>& Results, const FString& FilePath)
+{
+	const FString Path = ResolveBenchmarkPath(FilePath);
+	const bool bJson = FPaths::GetExtension(Path).Equals(TEXT("json"), ESearchCase::IgnoreCase);
+	return FFileHelper::SaveStringToFile(bJson ? FContainerBenchmark::ToJSON(Results) : FContainerBenchmark::ToCSV(Results), *Path);
+}
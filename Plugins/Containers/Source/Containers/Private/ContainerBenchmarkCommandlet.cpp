@@ -0,0 +1,71 @@
+// Developer Bastian © 2024
+// License Creative Commons DEED 4.0 (https://creativecommons.org/licenses/by-sa/4.0/deed.en)
+
+#include "ContainerBenchmarkCommandlet.h"
+#include "ContainerBenchmark.h"
+#include "Misc/Paths.h"
+
+UContainerBenchmarkCommandlet::UContainerBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UContainerBenchmarkCommandlet::Main(const FString& Params)
+{
+	// row counts, 10^3 up to 10^7 by default
+	TArray<int32> RowCounts = { 1000, 10000, 100000, 1000000, 10000000 };
+	FString RowsParam;
+	if (FParse::Value(*Params, TEXT("Rows="), RowsParam, false))
+	{
+		TArray<FString> Values;
+		RowsParam.ParseIntoArray(Values, TEXT(","));
+		RowCounts.Reset();
+		for (const FString& Value : Values)
+			RowCounts.Add(FCString::Atoi(*Value));
+	}
+
+	FString DatasetPath = FContainerBenchmark::GetDefaultDatasetPath();
+	FParse::Value(*Params, TEXT("Dataset="), DatasetPath);
+	FString OutputPath = TEXT("Benchmarks/ContainerBenchmark");
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+	FString BaselinePath;
+	FParse::Value(*Params, TEXT("Baseline="), BaselinePath);
+	double Tolerance = 0.2;
+	FParse::Value(*Params, TEXT("Tolerance="), Tolerance);
+
+	TArray<FContainerBenchmarkRow> Dataset;
+	if (!FContainerBenchmark::LoadDataset(DatasetPath, Dataset))
+		return 1;
+	UE_LOG(LogTemp, Display, TEXT("ContainerBenchmark: loaded %d rows from '%s'"), Dataset.Num(), *DatasetPath);
+
+	const TArray<FContainerBenchmarkResult> Results = FContainerBenchmark::Run(Dataset, RowCounts);
+
+	const FString OutputBase = FPaths::Combine(FPaths::GetPath(OutputPath), FPaths::GetBaseFilename(OutputPath));
+	const bool bSaved = UContainerBenchmarkLibrary::Benchmark_Save(Results, OutputBase + TEXT(".csv"))
+		&& UContainerBenchmarkLibrary::Benchmark_Save(Results, OutputBase + TEXT(".json"));
+	if (!bSaved)
+	{
+		UE_LOG(LogTemp, Error, TEXT("ContainerBenchmark: results could not be written to '%s'"), *OutputBase);
+		return 1;
+	}
+
+	if (!BaselinePath.IsEmpty())
+	{
+		TArray<FContainerBenchmarkResult> Baseline;
+		if (!FContainerBenchmark::LoadCSV(BaselinePath, Baseline))
+		{
+			UE_LOG(LogTemp, Error, TEXT("ContainerBenchmark: baseline '%s' could not be read"), *BaselinePath);
+			return 1;
+		}
+		TArray<FString> Messages;
+		const int32 Regressions = FContainerBenchmark::FindRegressions(Results, Baseline, Tolerance, Messages);
+		for (const FString& Message : Messages)
+			UE_LOG(LogTemp, Error, TEXT("ContainerBenchmark regression: %s"), *Message);
+		if (Regressions > 0)
+			return 2;
+	}
+	return 0;
+}
@@ -0,0 +1,29 @@
+// Developer Bastian © 2024
+// License Creative Commons DEED 4.0 (https://creativecommons.org/licenses/by-sa/4.0/deed.en)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+#include "ContainerBenchmarkCommandlet.generated.h"
+
+/**
+ * Runs the container benchmark headless, e.g. on a build machine:
+ *
+ * UnrealEditor-Cmd BA_Containers.uproject -run=ContainerBenchmark -unattended -nullrhi
+ *     [-Rows=1000,10000,100000] [-Dataset=<csv>] [-Output=<file.csv|file.json>] [-Baseline=<file.csv>] [-Tolerance=0.2]
+ *
+ * Results are written both as CSV and JSON next to -Output (default Saved/Benchmarks/ContainerBenchmark).
+ * With -Baseline the run fails with exit code 2 if any operation is slower per element than the baseline plus Tolerance.
+ */
+UCLASS()
+class UContainerBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UContainerBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,69 @@
+// Developer Bastian © 2024
+// License Creative Commons DEED 4.0 (https://creativecommons.org/licenses/by-sa/4.0/deed.en)
+
+#include "ContainerChangeBatch.h"
+
+FContainerChangeBatcher::~FContainerChangeBatcher()
+{
+	RemoveTicker();
+}
+
+void FContainerChangeBatcher::SetMode(EContainerNotifyMode InMode, UObject* InOwner, TFunction<void()> Flush)
+{
+	this->Owner = InOwner;
+	this->FlushFunction = MoveTemp(Flush);
+	// published last, a producer that sees the batched mode also sees the flush function
+	this->Mode.store(InMode, std::memory_order_release);
+	if (InMode == EContainerNotifyMode::E_Immediate)
+	{
+		// mode and ticker first, then the drain: a producer that still saw the batched mode and records
+		// after this flush schedules a new ticker, so nothing recorded is lost
+		RemoveTicker();
+		if (this->FlushFunction)
+			this->FlushFunction();
+	}
+}
+
+bool FContainerChangeBatcher::TakePending(FContainerChangeBatch& OutBatch)
+{
+	UE::TScopeLock<UE::FSpinLock> Lock(this->Mutex);
+	if (this->Pending.IsEmpty())
+		return false;
+	OutBatch = MoveTemp(this->Pending);
+	this->Pending = FContainerChangeBatch();
+	return true;
+}
+
+void FContainerChangeBatcher::ScheduleFlush()
+{
+	// only the first change after a flush registers the ticker
+	if (this->bFlushScheduled.exchange(true))
+		return;
+	// held until the handle is stored, so the ticker cannot reset it before
+	UE::TScopeLock<UE::FSpinLock> Lock(this->Mutex);
+	this->TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([this](float)
+	{
+		{
+			UE::TScopeLock<UE::FSpinLock> Lock(this->Mutex);
+			this->bFlushScheduled = false;
+			this->TickerHandle.Reset();
+		}
+		if (this->Owner.IsValid() && this->FlushFunction)
+			this->FlushFunction();
+		// one-shot, the next change schedules again
+		return false;
+	}));
+}
+
+void FContainerChangeBatcher::RemoveTicker()
+{
+	FTSTicker::FDelegateHandle Handle;
+	{
+		UE::TScopeLock<UE::FSpinLock> Lock(this->Mutex);
+		Handle = this->TickerHandle;
+		this->TickerHandle.Reset();
+		this->bFlushScheduled = false;
+	}
+	if (Handle.IsValid())
+		FTSTicker::GetCoreTicker().RemoveTicker(Handle);
+}
@@ -0,0 +1,158 @@
+// Developer Bastian © 2024
+// License Creative Commons DEED 4.0 (https://creativecommons.org/licenses/by-sa/4.0/deed.en)
+
+#include "ContainerCsvLoader.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Misc/Paths.h"
+
+void FContainerCsvLoader::SplitIntoChunks(const uint8* Data, int64 Size, int32 NumChunks, TArray<FContainerCsvChunk>& OutChunks)
+{
+	OutChunks.Reset();
+	const ANSICHAR* Text = (const ANSICHAR*)Data;
+	const ANSICHAR* End = Text + Size;
+
+	// skip the header line "---,Name,Number"
+	const ANSICHAR* Begin = FindLineEnd(Text, End);
+	if (Begin == End)
+		return;
+	++Begin;
+
+	const int64 Remaining = End - Begin;
+	NumChunks = FMath::Max(1, NumChunks);
+	const int64 TargetSize = FMath::Max<int64>(1, Remaining / NumChunks);
+	const ANSICHAR* ChunkBegin = Begin;
+	while (ChunkBegin < End)
+	{
+		// move the cut to the end of the line it falls into
+		const ANSICHAR* Cut = End - ChunkBegin > TargetSize ? ChunkBegin + TargetSize : End;
+		const ANSICHAR* ChunkEnd = Cut < End ? FindLineEnd(Cut, End) : End;
+
+		FContainerCsvChunk& Chunk = OutChunks.AddDefaulted_GetRef();
+		Chunk.Begin = ChunkBegin - Text;
+		Chunk.End = ChunkEnd - Text;
+		ChunkBegin = ChunkEnd < End ? ChunkEnd + 1 : End;
+	}
+}
+
+int32 FContainerCsvLoader::GetChunkCount(int64 Size)
+{
+	constexpr int64 MinChunkBytes = 64 * 1024;
+	const int32 Workers = FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+	return (int32)FMath::Clamp<int64>(Size / MinChunkBytes, 1, Workers * 4);
+}
+
+bool FContainerCsvLoader::ParseLine(const ANSICHAR* Begin, const ANSICHAR* End, FContainerCsvFields& OutFields)
+{
+	if (End > Begin && *(End - 1) == '\r')
+		--End;
+
+	const ANSICHAR* FirstComma = (const ANSICHAR*)memchr(Begin, ',', End - Begin);
+	if (FirstComma == nullptr)
+		return false;
+	const ANSICHAR* SecondComma = (const ANSICHAR*)memchr(FirstComma + 1, ',', End - FirstComma - 1);
+	if (SecondComma == nullptr)
+		return false;
+
+	OutFields.RowName = Begin;
+	OutFields.RowNameLength = (int32)(FirstComma - Begin);
+	OutFields.Name = FirstComma + 1;
+	OutFields.NameLength = (int32)(SecondComma - FirstComma - 1);
+
+	// parse the number in place, no temporary string
+	const ANSICHAR* Digit = SecondComma + 1;
+	bool bNegative = false;
+	if (Digit < End && (*Digit == '-' || *Digit == '+'))
+	{
+		bNegative = *Digit == '-';
+		++Digit;
+	}
+	if (Digit == End)
+		return false;
+	int64 Number = 0;
+	for (; Digit < End; ++Digit)
+	{
+		if (*Digit < '0' || *Digit > '9')
+			return false;
+		Number = FMath::Min<int64>(Number * 10 + (*Digit - '0'), MAX_int32);
+	}
+	OutFields.Number = (int32)(bNegative ? -Number : Number);
+	return true;
+}
+
+FString FContainerCsvLoader::ToString(const ANSICHAR* Text, int32 Length)
+{
+	FUTF8ToTCHAR Converted(Text, Length);
+	return FString(Converted.Length(), Converted.Get());
+}
+
+void FContainerCsvLoader::ApplyRowKey(FMapTestStruct& Row, const FContainerCsvFields& Fields)
+{
+	Row.Guid = FGuid::NewDeterministicGuid(ToString(Fields.RowName, Fields.RowNameLength));
+}
+
+void FContainerCsvLoader::FinishReport(FContainerCsvLoadReport& Report, uint64 TotalNanoseconds)
+{
+	Report.TotalMilliseconds = TotalNanoseconds / 1000000.0;
+	Report.RowsPerSecond = TotalNanoseconds > 0 ? Report.Rows * 1000000000.0 / TotalNanoseconds : 0.0;
+}
+
+FString FContainerCsvLoader::ResolvePath(const FString& FilePath)
+{
+	if (FilePath.IsEmpty())
+		return FPaths::ConvertRelativePathToFull(
+			FPaths::Combine(FPaths::ProjectPluginsDir(), TEXT("Containers/Resources/WorldCities.csv")));
+	if (FPaths::IsRelative(FilePath))
+		return FPaths::ConvertRelativePathToFull(FPaths::Combine(FPaths::ProjectDir(), FilePath));
+	return FilePath;
+}
+
+bool FContainerCsvLoader::LoadIntoArray(UTArray* Array, const FString& FilePath, FContainerCsvLoadReport& OutReport)
+{
+	if (Array == nullptr)
+		return false;
+	Timer Total;
+	Total.Start();
+	TArray<FTArrayTestStruct> Rows;
+	if (!Load(ResolvePath(FilePath), Rows, OutReport))
+		return false;
+	Timer Insert;
+	Insert.Start();
+	Array->Array_AppendMoved(MoveTemp(Rows), true);
+	OutReport.InsertMilliseconds = Insert.StopNanoseconds() / 1000000.0;
+	FinishReport(OutReport, Total.StopNanoseconds());
+	return true;
+}
+
+bool FContainerCsvLoader::LoadIntoMap(UTMap* Map, const FString& FilePath, FContainerCsvLoadReport& OutReport)
+{
+	if (Map == nullptr)
+		return false;
+	Timer Total;
+	Total.Start();
+	TArray<FMapTestStruct> Rows;
+	if (!Load(ResolvePath(FilePath), Rows, OutReport))
+		return false;
+	Timer Insert;
+	Insert.Start();
+	Map->Map_AppendMoved(MoveTemp(Rows), true);
+	OutReport.InsertMilliseconds = Insert.StopNanoseconds() / 1000000.0;
+	FinishReport(OutReport, Total.StopNanoseconds());
+	return true;
+}
+
+bool FContainerCsvLoader::LoadIntoSet(UTSet* Set, const FString& FilePath, FContainerCsvLoadReport& OutReport)
+{
+	if (Set == nullptr)
+		return false;
+	Timer Total;
+	Total.Start();
+	TArray<FTSetTestStruct> Rows;
+	if (!Load(ResolvePath(FilePath), Rows, OutReport))
+		return false;
+	Timer Insert;
+	Insert.Start();
+	Set->Set_AppendMoved(MoveTemp(Rows), true);
+	OutReport.InsertMilliseconds = Insert.StopNanoseconds() / 1000000.0;
+	FinishReport(OutReport, Total.StopNanoseconds());
+	return true;
+}
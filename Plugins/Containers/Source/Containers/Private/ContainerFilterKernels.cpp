@@ -0,0 +1,306 @@
+// Developer Bastian © 2024
+// License Creative Commons DEED 4.0 (https://creativecommons.org/licenses/by-sa/4.0/deed.en)
+
+#include "ContainerFilterKernels.h"
+#include "Algo/BinarySearch.h"
+#include "Runtime/Core/Public/Async/ParallelFor.h"
+#include "ContainerProfiler.h"
+#include <atomic>
+
+#if PLATFORM_CPU_X86_FAMILY
+	#include <immintrin.h>
+#endif
+
+// AVX2 only where the build allows it (e.g. -mavx2 or /arch:AVX2), SSE2 is part of every x86-64 target
+#if PLATFORM_CPU_X86_FAMILY && defined(__AVX2__)
+	#define BA_FILTER_AVX2 1
+	#define BA_FILTER_SSE2 0
+#elif PLATFORM_CPU_X86_FAMILY
+	#define BA_FILTER_AVX2 0
+	#define BA_FILTER_SSE2 1
+#else
+	#define BA_FILTER_AVX2 0
+	#define BA_FILTER_SSE2 0
+#endif
+
+namespace
+{
+	// values per parallel task, a multiple of 64 so every task writes whole bitmap words
+	constexpr int32 ValuesPerTask = 64 * 1024;
+	// sets up to this size are compared lane by lane, larger ones are binary searched per value
+	constexpr int32 VectorSetLimit = 16;
+
+	/**
+	 * The few vector operations the kernels need, for the instruction set of this build.
+	 * Comparisons return all bits set in every matching lane, Mask packs one bit per lane.
+	 */
+#if BA_FILTER_AVX2
+	struct FLanes
+	{
+		using Type = __m256i;
+		static constexpr int32 Num = 8;
+		static FORCEINLINE Type Load(const int32* Values) { return _mm256_loadu_si256((const __m256i*)Values); }
+		static FORCEINLINE Type Splat(int32 Value) { return _mm256_set1_epi32(Value); }
+		static FORCEINLINE Type Zero() { return _mm256_setzero_si256(); }
+		static FORCEINLINE Type Greater(Type A, Type B) { return _mm256_cmpgt_epi32(A, B); }
+		static FORCEINLINE Type Equal(Type A, Type B) { return _mm256_cmpeq_epi32(A, B); }
+		static FORCEINLINE Type Or(Type A, Type B) { return _mm256_or_si256(A, B); }
+		static FORCEINLINE uint32 Mask(Type A) { return (uint32)_mm256_movemask_ps(_mm256_castsi256_ps(A)); }
+	};
+#elif BA_FILTER_SSE2
+	struct FLanes
+	{
+		using Type = __m128i;
+		static constexpr int32 Num = 4;
+		static FORCEINLINE Type Load(const int32* Values) { return _mm_loadu_si128((const __m128i*)Values); }
+		static FORCEINLINE Type Splat(int32 Value) { return _mm_set1_epi32(Value); }
+		static FORCEINLINE Type Zero() { return _mm_setzero_si128(); }
+		static FORCEINLINE Type Greater(Type A, Type B) { return _mm_cmpgt_epi32(A, B); }
+		static FORCEINLINE Type Equal(Type A, Type B) { return _mm_cmpeq_epi32(A, B); }
+		static FORCEINLINE Type Or(Type A, Type B) { return _mm_or_si128(A, B); }
+		static FORCEINLINE uint32 Mask(Type A) { return (uint32)_mm_movemask_ps(_mm_castsi128_ps(A)); }
+	};
+#else
+	struct FLanes
+	{
+		using Type = int32;
+		static constexpr int32 Num = 1;
+		static FORCEINLINE Type Load(const int32* Values) { return *Values; }
+		static FORCEINLINE Type Splat(int32 Value) { return Value; }
+		static FORCEINLINE Type Zero() { return 0; }
+		static FORCEINLINE Type Greater(Type A, Type B) { return A > B ? -1 : 0; }
+		static FORCEINLINE Type Equal(Type A, Type B) { return A == B ? -1 : 0; }
+		static FORCEINLINE Type Or(Type A, Type B) { return A | B; }
+		static FORCEINLINE uint32 Mask(Type A) { return (uint32)A & 1u; }
+	};
+#endif
+
+	// one bitmap word for exactly 64 contiguous values
+	template <typename CompareType>
+	FORCEINLINE uint64 MatchWord(const int32* Values, CompareType&& Compare)
+	{
+		uint64 Word = 0;
+		for (int32 i = 0; i < 64; i += FLanes::Num)
+		{
+			Word |= (uint64)FLanes::Mask(Compare(FLanes::Load(Values + i))) << i;
+		}
+		return Word;
+	}
+
+	uint64 MatchFullBlock(const int32* Values, const FContainerFilterPredicate& Predicate)
+	{
+		switch (Predicate.Op)
+		{
+		case FContainerFilterPredicate::EOp::Greater:
+		{
+			const FLanes::Type Threshold = FLanes::Splat(Predicate.A);
+			return MatchWord(Values, [Threshold](FLanes::Type X) { return FLanes::Greater(X, Threshold); });
+		}
+		case FContainerFilterPredicate::EOp::Less:
+		{
+			const FLanes::Type Threshold = FLanes::Splat(Predicate.A);
+			return MatchWord(Values, [Threshold](FLanes::Type X) { return FLanes::Greater(Threshold, X); });
+		}
+		case FContainerFilterPredicate::EOp::Between:
+		{
+			// there is no signed >= for integers, so match everything outside and invert
+			const FLanes::Type Min = FLanes::Splat(Predicate.A);
+			const FLanes::Type Max = FLanes::Splat(Predicate.B);
+			return ~MatchWord(Values, [Min, Max](FLanes::Type X) { return FLanes::Or(FLanes::Greater(Min, X), FLanes::Greater(X, Max)); });
+		}
+		case FContainerFilterPredicate::EOp::InSet:
+		{
+			if (Predicate.Set.Num() <= VectorSetLimit)
+			{
+				FLanes::Type Candidates[VectorSetLimit];
+				const int32 NumCandidates = Predicate.Set.Num();
+				for (int32 i = 0; i < NumCandidates; ++i)
+					Candidates[i] = FLanes::Splat(Predicate.Set[i]);
+				return MatchWord(Values, [&Candidates, NumCandidates](FLanes::Type X)
+				{
+					FLanes::Type Hit = FLanes::Zero();
+					for (int32 i = 0; i < NumCandidates; ++i)
+						Hit = FLanes::Or(Hit, FLanes::Equal(X, Candidates[i]));
+					return Hit;
+				});
+			}
+			uint64 Word = 0;
+			for (int32 i = 0; i < 64; ++i)
+			{
+				if (Algo::BinarySearch(Predicate.Set, Values[i]) != INDEX_NONE)
+					Word |= 1ull << i;
+			}
+			return Word;
+		}
+		default:
+			return 0;
+		}
+	}
+
+	// bitmap word for up to 64 values Stride bytes apart
+	FORCEINLINE uint64 MatchStrided(const int32* Values, int32 Count, int32 Stride, const FContainerFilterPredicate& Predicate)
+	{
+		if (Stride == sizeof(int32))
+			return FContainerFilterKernels::MatchBlock(Values, Count, Predicate);
+		int32 Block[64];
+		const uint8* Bytes = (const uint8*)Values;
+		for (int32 i = 0; i < Count; ++i)
+		{
+			Block[i] = *(const int32*)(Bytes + (int64)i * Stride);
+		}
+		return FContainerFilterKernels::MatchBlock(Block, Count, Predicate);
+	}
+
+	// Calls Function(Task, FirstWord, EndWord) for word ranges of the bitmap over Num values, in parallel for large inputs
+	template <typename FunctionType>
+	void ForEachWordRange(int32 Num, FunctionType&& Function)
+	{
+		const int32 NumWords = FMath::DivideAndRoundUp(Num, 64);
+		const int32 WordsPerTask = ValuesPerTask / 64;
+		const int32 NumTasks = FMath::DivideAndRoundUp(NumWords, WordsPerTask);
+		ParallelFor(NumTasks, [&](int32 Task)
+		{
+			Function(Task, Task * WordsPerTask, FMath::Min((Task + 1) * WordsPerTask, NumWords));
+		}, NumTasks > 1 ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+	}
+}
+
+#pragma region Predicate
+FContainerFilterPredicate FContainerFilterPredicate::Greater(int32 Threshold)
+{
+	FContainerFilterPredicate Predicate;
+	Predicate.Op = EOp::Greater;
+	Predicate.A = Threshold;
+	return Predicate;
+}
+
+FContainerFilterPredicate FContainerFilterPredicate::Less(int32 Threshold)
+{
+	FContainerFilterPredicate Predicate;
+	Predicate.Op = EOp::Less;
+	Predicate.A = Threshold;
+	return Predicate;
+}
+
+FContainerFilterPredicate FContainerFilterPredicate::Between(int32 Min, int32 Max)
+{
+	FContainerFilterPredicate Predicate;
+	Predicate.Op = EOp::Between;
+	Predicate.A = Min;
+	Predicate.B = Max;
+	return Predicate;
+}
+
+FContainerFilterPredicate FContainerFilterPredicate::InSet(TConstArrayView<int32> Values)
+{
+	FContainerFilterPredicate Predicate;
+	Predicate.Op = EOp::InSet;
+	Predicate.Set.Append(Values.GetData(), Values.Num());
+	Predicate.Set.Sort();
+	int32 Unique = 0;
+	for (int32 i = 0; i < Predicate.Set.Num(); ++i)
+	{
+		if (Unique == 0 || Predicate.Set[i] != Predicate.Set[Unique - 1])
+			Predicate.Set[Unique++] = Predicate.Set[i];
+	}
+	Predicate.Set.SetNum(Unique, false);
+	return Predicate;
+}
+
+bool FContainerFilterPredicate::Matches(int32 Value) const
+{
+	switch (Op)
+	{
+	case EOp::Greater: return Value > A;
+	case EOp::Less: return Value < A;
+	case EOp::Between: return Value >= A && Value <= B;
+	case EOp::InSet: return Algo::BinarySearch(Set, Value) != INDEX_NONE;
+	default: return false;
+	}
+}
+#pragma endregion Predicate
+
+#pragma region Kernels
+const TCHAR* FContainerFilterKernels::GetInstructionSet()
+{
+#if BA_FILTER_AVX2
+	return TEXT("AVX2");
+#elif BA_FILTER_SSE2
+	return TEXT("SSE2");
+#else
+	return TEXT("Scalar");
+#endif
+}
+
+uint64 FContainerFilterKernels::MatchBlock(const int32* Values, int32 Count, const FContainerFilterPredicate& Predicate)
+{
+	if (Count >= 64)
+		return MatchFullBlock(Values, Predicate);
+	if (Count <= 0)
+		return 0;
+	// short blocks are padded, the padding bits are cut off again
+	int32 Block[64] = {};
+	FMemory::Memcpy(Block, Values, Count * sizeof(int32));
+	return MatchFullBlock(Block, Predicate) & ((1ull << Count) - 1);
+}
+
+int32 FContainerFilterKernels::Select(const int32* Values, int32 Num, int32 Stride, const FContainerFilterPredicate& Predicate, TArray<uint64>& OutBitmap)
+{
+	BA_CONTAINER_SCOPE("FContainerFilterKernels::Select");
+	OutBitmap.SetNumUninitialized(FMath::DivideAndRoundUp(Num, 64));
+	std::atomic<int32> Matches{ 0 };
+	const uint8* Bytes = (const uint8*)Values;
+	ForEachWordRange(Num, [&](int32 Task, int32 FirstWord, int32 EndWord)
+	{
+		int32 TaskMatches = 0;
+		for (int32 Word = FirstWord; Word < EndWord; ++Word)
+		{
+			const int32 First = Word * 64;
+			const uint64 Bits = MatchStrided((const int32*)(Bytes + (int64)First * Stride), FMath::Min(64, Num - First), Stride, Predicate);
+			OutBitmap[Word] = Bits;
+			TaskMatches += FMath::CountBits(Bits);
+		}
+		Matches.fetch_add(TaskMatches, std::memory_order_relaxed);
+	});
+	return Matches.load();
+}
+
+void FContainerFilterKernels::SelectIndices(const int32* Values, int32 Num, int32 Stride, const FContainerFilterPredicate& Predicate, TArray<int32>& OutIndices)
+{
+	TArray<uint64> Bitmap;
+	const int32 Matches = Select(Values, Num, Stride, Predicate, Bitmap);
+	OutIndices.Reset(Matches);
+	BitmapToIndices(Bitmap, OutIndices);
+}
+
+void FContainerFilterKernels::BitmapToIndices(const TArray<uint64>& Bitmap, TArray<int32>& OutIndices)
+{
+	BA_CONTAINER_SCOPE("FContainerFilterKernels::BitmapToIndices");
+	for (int32 Word = 0; Word < Bitmap.Num(); ++Word)
+	{
+		// one iteration per set bit, clearing the lowest one each time
+		for (uint64 Bits = Bitmap[Word]; Bits != 0; Bits &= Bits - 1)
+		{
+			OutIndices.Add(Word * 64 + (int32)FMath::CountTrailingZeros64(Bits));
+		}
+	}
+}
+
+int32 FContainerFilterKernels::CountMatches(const int32* Values, int32 Num, int32 Stride, const FContainerFilterPredicate& Predicate)
+{
+	BA_CONTAINER_SCOPE("FContainerFilterKernels::CountMatches");
+	std::atomic<int32> Matches{ 0 };
+	const uint8* Bytes = (const uint8*)Values;
+	ForEachWordRange(Num, [&](int32 Task, int32 FirstWord, int32 EndWord)
+	{
+		int32 TaskMatches = 0;
+		for (int32 Word = FirstWord; Word < EndWord; ++Word)
+		{
+			const int32 First = Word * 64;
+			TaskMatches += FMath::CountBits(MatchStrided((const int32*)(Bytes + (int64)First * Stride), FMath::Min(64, Num - First), Stride, Predicate));
+		}
+		Matches.fetch_add(TaskMatches, std::memory_order_relaxed);
+	});
+	return Matches.load();
+}
+#pragma endregion Kernels
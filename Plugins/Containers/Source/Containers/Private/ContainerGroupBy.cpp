@@ -0,0 +1,45 @@
+// Developer Bastian © 2024
+// License Creative Commons DEED 4.0 (https://creativecommons.org/licenses/by-sa/4.0/deed.en)
+
+#include "ContainerGroupBy.h"
+
+namespace
+{
+	// Copies Values, as Blueprint hands them over by reference, and groups them into MultiMap
+	template <typename MultiMapType, typename SourceType>
+	int32 GroupIntoMultiMap(MultiMapType* MultiMap, const TArray<SourceType>& Values, EContainerGroupKey GroupKey, bool bBroadcast)
+	{
+		if (MultiMap == nullptr)
+			return 0;
+		TArray<SourceType> Copy = Values;
+		return FContainerGroupBy::IntoMultiMap(*MultiMap, MoveTemp(Copy), [GroupKey](const SourceType& Value)
+		{
+			return FContainerGroupBy::MakeKey(Value.Name, Value.Number, GroupKey);
+		}, bBroadcast);
+	}
+}
+
+int32 UContainerGroupByLibrary::GroupBy_ArrayIntoMultiMap(UTMultiMap* MultiMap, const TArray<FTArrayTestStruct>& Values, EContainerGroupKey GroupKey, bool Broadcast)
+{
+	return GroupIntoMultiMap(MultiMap, Values, GroupKey, Broadcast);
+}
+
+int32 UContainerGroupByLibrary::GroupBy_ArrayIntoBucketedMultiMap(UTBucketedMultiMap* MultiMap, const TArray<FTArrayTestStruct>& Values, EContainerGroupKey GroupKey, bool Broadcast)
+{
+	return GroupIntoMultiMap(MultiMap, Values, GroupKey, Broadcast);
+}
+
+int32 UContainerGroupByLibrary::GroupBy_ValuesIntoMultiMap(UTMultiMap* MultiMap, const TArray<FTMultiMapTestStruct>& Values, EContainerGroupKey GroupKey, bool Broadcast)
+{
+	return GroupIntoMultiMap(MultiMap, Values, GroupKey, Broadcast);
+}
+
+int32 UContainerGroupByLibrary::GroupBy_ValuesIntoBucketedMultiMap(UTBucketedMultiMap* MultiMap, const TArray<FTMultiMapTestStruct>& Values, EContainerGroupKey GroupKey, bool Broadcast)
+{
+	return GroupIntoMultiMap(MultiMap, Values, GroupKey, Broadcast);
+}
+
+FGuid UContainerGroupByLibrary::GroupBy_MakeKey(const FString& Name, int32 Number, EContainerGroupKey GroupKey)
+{
+	return FContainerGroupBy::MakeKey(Name, Number, GroupKey);
+}
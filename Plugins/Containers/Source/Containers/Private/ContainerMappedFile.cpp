@@ -0,0 +1,42 @@
+// Developer Bastian © 2024
+// License Creative Commons DEED 4.0 (https://creativecommons.org/licenses/by-sa/4.0/deed.en)
+
+#include "ContainerMappedFile.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+
+bool FContainerMappedFile::Open(const FString& Path)
+{
+	Close();
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	Handle.Reset(PlatformFile.OpenMapped(*Path));
+	if (Handle.IsValid() && Handle->GetFileSize() > 0)
+	{
+		Region.Reset(Handle->MapRegion(0, Handle->GetFileSize()));
+		if (Region.IsValid())
+		{
+			Data = Region->GetMappedPtr();
+			Size = Region->GetMappedSize();
+			return true;
+		}
+	}
+	Handle.Reset();
+
+	// platform (or file system layer, e.g. pak files) does not support mapping
+	if (!FFileHelper::LoadFileToArray(Buffer, *Path))
+		return false;
+	Data = Buffer.GetData();
+	Size = Buffer.Num();
+	return true;
+}
+
+void FContainerMappedFile::Close()
+{
+	// the region has to be released before its handle
+	Region.Reset();
+	Handle.Reset();
+	Buffer.Empty();
+	Data = nullptr;
+	Size = 0;
+}
@@ -0,0 +1,276 @@
+// Developer Bastian © 2024
+// License Creative Commons DEED 4.0 (https://creativecommons.org/licenses/by-sa/4.0/deed.en)
+
+#include "ContainerProfiler.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+	thread_local int32 GBAProfilerCurrentNode = INDEX_NONE;
+	// child nodes this thread already looked up, keyed by parent node << 32 | operation node
+	thread_local TMap<uint64, int32> GBAProfilerChildCache;
+
+	FString ResolveProfilerPath(const FString& FilePath)
+	{
+		if (FPaths::IsRelative(FilePath))
+			return FPaths::Combine(FPaths::ProjectSavedDir(), FilePath);
+		return FilePath;
+	}
+
+	FString EscapeJson(const FString& Value)
+	{
+		return Value.Replace(TEXT("\\"), TEXT("\\\\")).Replace(TEXT("\""), TEXT("\\\""));
+	}
+}
+
+FContainerProfiler& FContainerProfiler::Get()
+{
+	static FContainerProfiler Instance;
+	return Instance;
+}
+
+FContainerProfiler::FContainerProfiler()
+	: NumNodes(0), bEnabled(false)
+{
+}
+
+int32 FContainerProfiler::GetCurrentNode()
+{
+	return GBAProfilerCurrentNode;
+}
+
+void FContainerProfiler::SetCurrentNode(int32 Node)
+{
+	GBAProfilerCurrentNode = Node;
+}
+
+int32 FContainerProfiler::GetBucketIndex(uint64 Nanoseconds)
+{
+	if (Nanoseconds < 16)
+		return (int32)Nanoseconds;
+	const int32 Exponent = 63 - (int32)FMath::CountLeadingZeros64(Nanoseconds);
+	const int32 SubBucket = (int32)((Nanoseconds >> (Exponent - 3)) & 7);
+	return 16 + (Exponent - 4) * 8 + SubBucket;
+}
+
+uint64 FContainerProfiler::GetBucketLowerBound(int32 Bucket)
+{
+	if (Bucket < 16)
+		return (uint64)Bucket;
+	const int32 Exponent = (Bucket - 16) / 8 + 4;
+	const int32 SubBucket = (Bucket - 16) % 8;
+	return (uint64)(8 + SubBucket) << (Exponent - 3);
+}
+
+int32 FContainerProfiler::AddNode(FName Operation, int32 Parent)
+{
+	// caller holds RegistryLock
+	const int32 Index = NumNodes.load(std::memory_order_relaxed);
+	if (Index >= MaxNodes)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("ContainerProfiler: node limit of %d reached, '%s' is not recorded"), MaxNodes, *Operation.ToString());
+		return INDEX_NONE;
+	}
+	TUniquePtr<FNode> Node = MakeUnique<FNode>();
+	Node->Operation = Operation;
+	Node->Parent = Parent;
+	Node->Depth = Parent == INDEX_NONE ? 0 : Nodes[Parent]->Depth + 1;
+	Nodes[Index] = MoveTemp(Node);
+	// publish the node only after it is fully constructed
+	NumNodes.store(Index + 1, std::memory_order_release);
+	return Index;
+}
+
+int32 FContainerProfiler::RegisterOperation(const TCHAR* Operation)
+{
+	const FName OperationName(Operation);
+	FScopeLock Lock(&RegistryLock);
+	if (const int32* Found = RootNodes.Find(OperationName))
+		return *Found;
+	const int32 Node = AddNode(OperationName, INDEX_NONE);
+	if (Node != INDEX_NONE)
+		RootNodes.Add(OperationName, Node);
+	return Node;
+}
+
+int32 FContainerProfiler::FindOrAddChild(int32 ParentNode, int32 OperationNode)
+{
+	// nodes are never removed, so a cached lookup stays valid and only the first one per thread locks
+	const uint64 CacheKey = ((uint64)(uint32)ParentNode << 32) | (uint32)OperationNode;
+	if (const int32* Cached = GBAProfilerChildCache.Find(CacheKey))
+		return *Cached;
+
+	const TPair<int32, int32> Key(ParentNode, OperationNode);
+	int32 Node;
+	{
+		FScopeLock Lock(&RegistryLock);
+		if (const int32* Found = ChildNodes.Find(Key))
+			Node = *Found;
+		else
+		{
+			Node = AddNode(Nodes[OperationNode]->Operation, ParentNode);
+			if (Node != INDEX_NONE)
+				ChildNodes.Add(Key, Node);
+		}
+	}
+	// a failed add is cached too, the node limit does not go away
+	GBAProfilerChildCache.Add(CacheKey, Node);
+	return Node;
+}
+
+void FContainerProfiler::Record(int32 Node, uint64 Nanoseconds)
+{
+	FNode& Target = *Nodes[Node];
+	const int32 Bucket = GetBucketIndex(Nanoseconds);
+	UE::TScopeLock<UE::FSpinLock> Lock(Target.Lock);
+	++Target.Count;
+	Target.Total += Nanoseconds;
+	Target.Min = FMath::Min(Target.Min, Nanoseconds);
+	Target.Max = FMath::Max(Target.Max, Nanoseconds);
+	++Target.Buckets[Bucket];
+}
+
+void FContainerProfiler::Reset()
+{
+	const int32 Num = NumNodes.load(std::memory_order_acquire);
+	for (int32 i = 0; i < Num; ++i)
+	{
+		FNode& Target = *Nodes[i];
+		UE::TScopeLock<UE::FSpinLock> Lock(Target.Lock);
+		Target.Count = 0;
+		Target.Total = 0;
+		Target.Min = MAX_uint64;
+		Target.Max = 0;
+		FMemory::Memzero(Target.Buckets, sizeof(Target.Buckets));
+	}
+}
+
+FString FContainerProfiler::GetPath(int32 Node) const
+{
+	FString Path = Nodes[Node]->Operation.ToString();
+	for (int32 Parent = Nodes[Node]->Parent; Parent != INDEX_NONE; Parent = Nodes[Parent]->Parent)
+	{
+		Path = Nodes[Parent]->Operation.ToString() + TEXT("/") + Path;
+	}
+	return Path;
+}
+
+FContainerProfilerStats FContainerProfiler::MakeStats(int32 Node) const
+{
+	const FNode& Source = *Nodes[Node];
+	FContainerProfilerStats Stats;
+	Stats.Operation = GetPath(Node);
+	Stats.Depth = Source.Depth;
+
+	// copy under the lock, evaluate without it
+	uint64 Count, Total, Min, Max;
+	uint32 Buckets[NumBuckets];
+	{
+		UE::TScopeLock<UE::FSpinLock> Lock(Source.Lock);
+		Count = Source.Count;
+		Total = Source.Total;
+		Min = Source.Min;
+		Max = Source.Max;
+		FMemory::Memcpy(Buckets, Source.Buckets, sizeof(Buckets));
+	}
+	if (Count == 0)
+		return Stats;
+
+	auto Percentile = [&](double Fraction) -> double
+	{
+		const uint64 Target = FMath::Max<uint64>(1, (uint64)FMath::CeilToDouble(Fraction * Count));
+		uint64 Seen = 0;
+		for (int32 Bucket = 0; Bucket < NumBuckets; ++Bucket)
+		{
+			Seen += Buckets[Bucket];
+			if (Seen >= Target)
+			{
+				// report the middle of the bucket, but never outside the measured range
+				const uint64 Lower = GetBucketLowerBound(Bucket);
+				const uint64 Upper = Bucket + 1 < NumBuckets ? GetBucketLowerBound(Bucket + 1) : Lower;
+				const uint64 Value = FMath::Clamp(Lower + (Upper - Lower) / 2, Min, Max);
+				return Value / 1000.0;
+			}
+		}
+		return Max / 1000.0;
+	};
+
+	Stats.Count = (int64)Count;
+	Stats.TotalMicroseconds = Total / 1000.0;
+	Stats.MinMicroseconds = Min / 1000.0;
+	Stats.MaxMicroseconds = Max / 1000.0;
+	Stats.AverageMicroseconds = Stats.TotalMicroseconds / Count;
+	Stats.P50Microseconds = Percentile(0.50);
+	Stats.P95Microseconds = Percentile(0.95);
+	Stats.P99Microseconds = Percentile(0.99);
+	return Stats;
+}
+
+TArray<FContainerProfilerStats> FContainerProfiler::GetAllStats() const
+{
+	TArray<FContainerProfilerStats> AllStats;
+	const int32 Num = NumNodes.load(std::memory_order_acquire);
+	AllStats.Reserve(Num);
+	for (int32 i = 0; i < Num; ++i)
+	{
+		FContainerProfilerStats Stats = MakeStats(i);
+		if (Stats.Count > 0)
+			AllStats.Add(MoveTemp(Stats));
+	}
+	AllStats.Sort([](const FContainerProfilerStats& A, const FContainerProfilerStats& B)
+	{
+		return A.Operation < B.Operation;
+	});
+	return AllStats;
+}
+
+bool FContainerProfiler::GetStats(const FString& Operation, FContainerProfilerStats& OutStats) const
+{
+	const int32 Num = NumNodes.load(std::memory_order_acquire);
+	for (int32 i = 0; i < Num; ++i)
+	{
+		if (GetPath(i) == Operation)
+		{
+			OutStats = MakeStats(i);
+			return OutStats.Count > 0;
+		}
+	}
+	return false;
+}
+
+FString FContainerProfiler::ToCSV() const
+{
+	FString Result = TEXT("Operation,Depth,Count,TotalUs,MinUs,MaxUs,AverageUs,P50Us,P95Us,P99Us\n");
+	for (const FContainerProfilerStats& Stats : GetAllStats())
+	{
+		Result += FString::Printf(TEXT("\"%s\",%d,%lld,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n")
+			, *Stats.Operation.Replace(TEXT("\""), TEXT("\"\"")), Stats.Depth, Stats.Count
+			, Stats.TotalMicroseconds, Stats.MinMicroseconds, Stats.MaxMicroseconds, Stats.AverageMicroseconds
+			, Stats.P50Microseconds, Stats.P95Microseconds, Stats.P99Microseconds);
+	}
+	return Result;
+}
+
+FString FContainerProfiler::ToJSON() const
+{
+	TArray<FString> Entries;
+	for (const FContainerProfilerStats& Stats : GetAllStats())
+	{
+		Entries.Add(FString::Printf(TEXT("\t{\"operation\": \"%s\", \"depth\": %d, \"count\": %lld, \"total_us\": %.3f, \"min_us\": %.3f, \"max_us\": %.3f, \"avg_us\": %.3f, \"p50_us\": %.3f, \"p95_us\": %.3f, \"p99_us\": %.3f}")
+			, *EscapeJson(Stats.Operation), Stats.Depth, Stats.Count
+			, Stats.TotalMicroseconds, Stats.MinMicroseconds, Stats.MaxMicroseconds, Stats.AverageMicroseconds
+			, Stats.P50Microseconds, Stats.P95Microseconds, Stats.P99Microseconds));
+	}
+	return TEXT("[\n") + FString::Join(Entries, TEXT(",\n")) + TEXT("\n]\n");
+}
+
+bool UContainerProfilerLibrary::Profiler_DumpToCSV(const FString& FilePath)
+{
+	return FFileHelper::SaveStringToFile(FContainerProfiler::Get().ToCSV(), *ResolveProfilerPath(FilePath));
+}
+
+bool UContainerProfilerLibrary::Profiler_DumpToJSON(const FString& FilePath)
+{
+	return FFileHelper::SaveStringToFile(FContainerProfiler::Get().ToJSON(), *ResolveProfilerPath(FilePath));
+}
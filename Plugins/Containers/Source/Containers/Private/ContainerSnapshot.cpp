@@ -0,0 +1,463 @@
+// Developer Bastian © 2024
+// License Creative Commons DEED 4.0 (https://creativecommons.org/licenses/by-sa/4.0/deed.en)
+
+#include "ContainerSnapshot.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "HAL/FileManager.h"
+#include "Misc/Crc.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Timer.h"
+
+static_assert(sizeof(FGuid) == 16, "snapshot Guid columns expect a 16 byte FGuid");
+static_assert(sizeof(FContainerSnapshotHeader) % 16 == 0, "the first snapshot section has to stay 16 byte aligned");
+
+namespace
+{
+	constexpr int64 SectionAlignment = 16;
+	constexpr int32 RowsPerChunk = 16384;
+
+	FORCEINLINE double ToMilliseconds(uint64 Nanoseconds)
+	{
+		return Nanoseconds / 1000000.0;
+	}
+
+	void FinishReport(FContainerSnapshotReport& Report, uint64 TotalNanoseconds)
+	{
+		Report.TotalMilliseconds = ToMilliseconds(TotalNanoseconds);
+	}
+
+	// Collects the rows of a container into columns and writes them
+	template <typename FillType>
+	bool SaveColumns(const FString& FilePath, EContainerSnapshotKind Kind, FContainerSnapshotReport& OutReport, FillType&& Fill)
+	{
+		Timer Total;
+		Total.Start();
+		FContainerSnapshotColumns Columns;
+		Fill(Columns);
+		if (!FContainerSnapshot::Write(FContainerSnapshot::ResolvePath(FilePath), Kind, Columns, OutReport))
+			return false;
+		FinishReport(OutReport, Total.StopNanoseconds());
+		return true;
+	}
+
+	// Opens a snapshot of Kind, builds its rows and hands them to Insert(TArray<StructType>&&, const FContainerSnapshotReader&)
+	template <typename StructType, typename InsertType>
+	bool LoadRows(const FString& FilePath, EContainerSnapshotKind Kind, FContainerSnapshotReport& OutReport, InsertType&& Insert)
+	{
+		Timer Total;
+		Total.Start();
+		FContainerSnapshotReader Reader;
+		if (!Reader.Open(FContainerSnapshot::ResolvePath(FilePath), Kind, OutReport))
+			return false;
+		Timer Decode;
+		Decode.Start();
+		TArray<StructType> Rows;
+		Reader.ToRows(Rows);
+		OutReport.DecodeMilliseconds = ToMilliseconds(Decode.StopNanoseconds());
+		Timer Adopt;
+		Adopt.Start();
+		Insert(MoveTemp(Rows), Reader);
+		OutReport.InsertMilliseconds = ToMilliseconds(Adopt.StopNanoseconds());
+		FinishReport(OutReport, Total.StopNanoseconds());
+		return true;
+	}
+}
+
+#pragma region Reader
+bool FContainerSnapshotReader::Open(const FString& Path, EContainerSnapshotKind Kind, FContainerSnapshotReport& OutReport)
+{
+	BA_CONTAINER_SCOPE("FContainerSnapshotReader::Open");
+	OutReport = FContainerSnapshotReport();
+	OutReport.Kind = Kind;
+	if (!this->File.Open(Path))
+	{
+		UE_LOG(LogTemp, Error, TEXT("ContainerSnapshot: '%s' could not be opened"), *Path);
+		return false;
+	}
+	const uint8* Data = this->File.GetData();
+	const int64 Size = this->File.GetSize();
+	OutReport.Bytes = Size;
+	OutReport.MemoryMapped = this->File.IsMapped();
+
+	// the header is copied, the mapping gives no alignment guarantee for reading it in place on every platform
+	FContainerSnapshotHeader Header;
+	if (Size < (int64)sizeof(Header))
+	{
+		UE_LOG(LogTemp, Error, TEXT("ContainerSnapshot: '%s' is too small for a snapshot"), *Path);
+		return false;
+	}
+	FMemory::Memcpy(&Header, Data, sizeof(Header));
+	if (Header.Magic != FContainerSnapshot::Magic || Header.Version != FContainerSnapshot::Version)
+	{
+		UE_LOG(LogTemp, Error, TEXT("ContainerSnapshot: '%s' is not a version %d snapshot"), *Path, FContainerSnapshot::Version);
+		return false;
+	}
+	const uint32 HeaderCrc = Header.HeaderCrc;
+	Header.HeaderCrc = 0;
+	if (FCrc::MemCrc32(&Header, sizeof(Header)) != HeaderCrc)
+	{
+		UE_LOG(LogTemp, Error, TEXT("ContainerSnapshot: '%s' has a corrupt header"), *Path);
+		return false;
+	}
+	if (Header.Kind != (uint8)Kind)
+	{
+		UE_LOG(LogTemp, Error, TEXT("ContainerSnapshot: '%s' was saved from a different container type"), *Path);
+		return false;
+	}
+	if (Header.CharSize != sizeof(TCHAR))
+	{
+		UE_LOG(LogTemp, Error, TEXT("ContainerSnapshot: '%s' was saved with %d byte characters, this platform uses %d"), *Path, Header.CharSize, (int32)sizeof(TCHAR));
+		return false;
+	}
+
+	// every section has to lie inside the file and have exactly the size its rows need,
+	// checked without adding offset and size so huge values from a broken file can not overflow
+	const int32 NumRows = Header.NumRows;
+	const bool bGuids = Kind == EContainerSnapshotKind::E_Map || Kind == EContainerSnapshotKind::E_MultiMap;
+	const bool bKeys = Kind == EContainerSnapshotKind::E_MultiMap;
+	const int64 ExpectedSizes[FContainerSnapshotHeader::NumSections] = {
+		-1,
+		NumRows * (int64)sizeof(int32),
+		NumRows * (int64)sizeof(int32),
+		bGuids ? NumRows * (int64)sizeof(FGuid) : 0,
+		bKeys ? NumRows * (int64)sizeof(FGuid) : 0 };
+	bool bValid = NumRows >= 0 && Header.NumStrings >= 0;
+	for (int32 i = 0; bValid && i < FContainerSnapshotHeader::NumSections; ++i)
+	{
+		const FContainerSnapshotSection& Section = Header.Sections[i];
+		bValid = Section.Offset >= (int64)sizeof(Header) && Section.Size >= 0 && Section.Offset % SectionAlignment == 0
+			&& Section.Offset <= Size && Section.Size <= Size - Section.Offset && (ExpectedSizes[i] < 0 || Section.Size == ExpectedSizes[i]);
+	}
+	const FContainerSnapshotSection& StringSection = Header.Sections[FContainerSnapshotHeader::Strings];
+	const int64 OffsetBytes = ((int64)Header.NumStrings + 1) * (int64)sizeof(uint32);
+	bValid = bValid && StringSection.Size >= OffsetBytes;
+	if (!bValid)
+	{
+		UE_LOG(LogTemp, Error, TEXT("ContainerSnapshot: '%s' has an invalid section table"), *Path);
+		return false;
+	}
+
+	// the sections are checked in parallel, the columns are the bulk of the file
+	Timer Checksums;
+	Checksums.Start();
+	bool bChecksumsMatch[FContainerSnapshotHeader::NumSections];
+	ParallelFor(FContainerSnapshotHeader::NumSections, [&](int32 i)
+	{
+		const FContainerSnapshotSection& Section = Header.Sections[i];
+		bChecksumsMatch[i] = FContainerSnapshot::Checksum(Data + Section.Offset, Section.Size) == Section.Crc;
+	});
+	OutReport.ChecksumMilliseconds = ToMilliseconds(Checksums.StopNanoseconds());
+	for (int32 i = 0; i < FContainerSnapshotHeader::NumSections; ++i)
+	{
+		if (!bChecksumsMatch[i])
+		{
+			UE_LOG(LogTemp, Error, TEXT("ContainerSnapshot: '%s' has a corrupt section %d"), *Path, i);
+			return false;
+		}
+	}
+
+	// the string table is the only part that is parsed, once per distinct name
+	const uint8* StringData = Data + StringSection.Offset;
+	const uint32* Offsets = (const uint32*)StringData;
+	const TCHAR* Chars = (const TCHAR*)(StringData + OffsetBytes);
+	const int64 NumChars = (StringSection.Size - OffsetBytes) / (int64)sizeof(TCHAR);
+	this->Strings.SetNum(Header.NumStrings);
+	for (int32 i = 0; i < Header.NumStrings; ++i)
+	{
+		if (Offsets[i] > Offsets[i + 1] || Offsets[i + 1] > NumChars)
+		{
+			UE_LOG(LogTemp, Error, TEXT("ContainerSnapshot: '%s' has an invalid string table"), *Path);
+			return false;
+		}
+		this->Strings[i] = FString((int32)(Offsets[i + 1] - Offsets[i]), Chars + Offsets[i]);
+	}
+
+	auto Column = [&Header, Data](FContainerSnapshotHeader::ESection Section, int64 ElementSize)
+	{
+		return TPair<const uint8*, int32>(Data + Header.Sections[Section].Offset, (int32)(Header.Sections[Section].Size / ElementSize));
+	};
+	const TPair<const uint8*, int32> NameColumn = Column(FContainerSnapshotHeader::Names, sizeof(int32));
+	const TPair<const uint8*, int32> NumberColumn = Column(FContainerSnapshotHeader::Numbers, sizeof(int32));
+	const TPair<const uint8*, int32> GuidColumn = Column(FContainerSnapshotHeader::Guids, sizeof(FGuid));
+	const TPair<const uint8*, int32> KeyColumn = Column(FContainerSnapshotHeader::Keys, sizeof(FGuid));
+	this->Names = TConstArrayView<int32>((const int32*)NameColumn.Key, NameColumn.Value);
+	this->Numbers = TConstArrayView<int32>((const int32*)NumberColumn.Key, NumberColumn.Value);
+	this->Guids = TConstArrayView<FGuid>((const FGuid*)GuidColumn.Key, GuidColumn.Value);
+	this->Keys = TConstArrayView<FGuid>((const FGuid*)KeyColumn.Key, KeyColumn.Value);
+
+	// a name index outside of the string table would read out of bounds in ToRows
+	for (const int32 Name : this->Names)
+	{
+		if ((uint32)Name >= (uint32)Header.NumStrings)
+		{
+			UE_LOG(LogTemp, Error, TEXT("ContainerSnapshot: '%s' has a name outside of its string table"), *Path);
+			return false;
+		}
+	}
+	OutReport.Rows = NumRows;
+	OutReport.Strings = Header.NumStrings;
+	return true;
+}
+
+int32 FContainerSnapshotReader::GetChunkCount() const
+{
+	const int32 Workers = FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+	return FMath::Clamp(Num() / RowsPerChunk, 1, Workers);
+}
+#pragma endregion Reader
+
+#pragma region Writer
+bool FContainerSnapshot::Write(const FString& Path, EContainerSnapshotKind Kind, const FContainerSnapshotColumns& Columns, FContainerSnapshotReport& OutReport)
+{
+	BA_CONTAINER_SCOPE("FContainerSnapshot::Write");
+	OutReport = FContainerSnapshotReport();
+	OutReport.Kind = Kind;
+	const FContainerNameArena& Strings = Columns.Strings;
+	const int32 NumRows = Columns.Numbers.Num();
+	const int32 NumStrings = Strings.Num();
+
+	int64 NumChars = 0;
+	for (FContainerNameArena::FHandle Handle = 0; Handle < NumStrings; ++Handle)
+		NumChars += Strings.Get(Handle).Len();
+	if (NumChars > MAX_uint32)
+	{
+		UE_LOG(LogTemp, Error, TEXT("ContainerSnapshot: the names are too long for one string table"));
+		return false;
+	}
+
+	// lay out the sections, each one 16 byte aligned
+	FContainerSnapshotHeader Header;
+	Header.Magic = Magic;
+	Header.Version = Version;
+	Header.Kind = (uint8)Kind;
+	Header.CharSize = sizeof(TCHAR);
+	Header.NumRows = NumRows;
+	Header.NumStrings = NumStrings;
+	const int64 OffsetBytes = (NumStrings + 1) * (int64)sizeof(uint32);
+	const int64 SectionSizes[FContainerSnapshotHeader::NumSections] = {
+		OffsetBytes + NumChars * (int64)sizeof(TCHAR),
+		Columns.Names.Num() * (int64)sizeof(int32),
+		Columns.Numbers.Num() * (int64)sizeof(int32),
+		Columns.Guids.Num() * (int64)sizeof(FGuid),
+		Columns.Keys.Num() * (int64)sizeof(FGuid) };
+	int64 FileSize = sizeof(Header);
+	for (int32 i = 0; i < FContainerSnapshotHeader::NumSections; ++i)
+	{
+		Header.Sections[i].Offset = FileSize;
+		Header.Sections[i].Size = SectionSizes[i];
+		FileSize = Align(FileSize + SectionSizes[i], SectionAlignment);
+	}
+
+	TArray64<uint8> Buffer;
+	Buffer.SetNumZeroed(FileSize);
+	uint8* Data = Buffer.GetData();
+	uint8* StringData = Data + Header.Sections[FContainerSnapshotHeader::Strings].Offset;
+	uint32* Offsets = (uint32*)StringData;
+	TCHAR* Chars = (TCHAR*)(StringData + OffsetBytes);
+	uint32 Offset = 0;
+	for (FContainerNameArena::FHandle Handle = 0; Handle < NumStrings; ++Handle)
+	{
+		const FStringView Name = Strings.Get(Handle);
+		Offsets[Handle] = Offset;
+		FMemory::Memcpy(Chars + Offset, Name.GetData(), Name.Len() * sizeof(TCHAR));
+		Offset += Name.Len();
+	}
+	Offsets[NumStrings] = Offset;
+	FMemory::Memcpy(Data + Header.Sections[FContainerSnapshotHeader::Names].Offset, Columns.Names.GetData(), SectionSizes[FContainerSnapshotHeader::Names]);
+	FMemory::Memcpy(Data + Header.Sections[FContainerSnapshotHeader::Numbers].Offset, Columns.Numbers.GetData(), SectionSizes[FContainerSnapshotHeader::Numbers]);
+	FMemory::Memcpy(Data + Header.Sections[FContainerSnapshotHeader::Guids].Offset, Columns.Guids.GetData(), SectionSizes[FContainerSnapshotHeader::Guids]);
+	FMemory::Memcpy(Data + Header.Sections[FContainerSnapshotHeader::Keys].Offset, Columns.Keys.GetData(), SectionSizes[FContainerSnapshotHeader::Keys]);
+
+	Timer Checksums;
+	Checksums.Start();
+	ParallelFor(FContainerSnapshotHeader::NumSections, [&Header, Data](int32 i)
+	{
+		FContainerSnapshotSection& Section = Header.Sections[i];
+		Section.Crc = Checksum(Data + Section.Offset, Section.Size);
+	});
+	Header.HeaderCrc = 0;
+	Header.HeaderCrc = FCrc::MemCrc32(&Header, sizeof(Header));
+	OutReport.ChecksumMilliseconds = ToMilliseconds(Checksums.StopNanoseconds());
+	FMemory::Memcpy(Data, &Header, sizeof(Header));
+
+	// write next to the target and move it over, a reader never sees half a snapshot
+	const FString TempPath = Path + TEXT(".tmp");
+	if (!FFileHelper::SaveArrayToFile(Buffer, *TempPath) || !IFileManager::Get().Move(*Path, *TempPath, true, true))
+	{
+		IFileManager::Get().Delete(*TempPath);
+		UE_LOG(LogTemp, Error, TEXT("ContainerSnapshot: '%s' could not be written"), *Path);
+		return false;
+	}
+	OutReport.Rows = NumRows;
+	OutReport.Strings = NumStrings;
+	OutReport.Bytes = FileSize;
+	return true;
+}
+
+uint32 FContainerSnapshot::Checksum(const uint8* Data, int64 Size)
+{
+	constexpr int64 MaxBytesPerCall = 1 << 30;
+	uint32 Crc = 0;
+	for (int64 Offset = 0; Offset < Size; Offset += MaxBytesPerCall)
+		Crc = FCrc::MemCrc32(Data + Offset, (int32)FMath::Min(Size - Offset, MaxBytesPerCall), Crc);
+	return Crc;
+}
+
+FString FContainerSnapshot::ResolvePath(const FString& FilePath)
+{
+	if (FPaths::IsRelative(FilePath))
+		return FPaths::ConvertRelativePathToFull(FPaths::Combine(FPaths::ProjectSavedDir(), FilePath));
+	return FilePath;
+}
+#pragma endregion Writer
+
+#pragma region Containers
+bool FContainerSnapshot::SaveArray(UTArray* Array, const FString& FilePath, FContainerSnapshotReport& OutReport)
+{
+	if (Array == nullptr)
+		return false;
+	return SaveColumns(FilePath, EContainerSnapshotKind::E_Array, OutReport, [Array](FContainerSnapshotColumns& Columns)
+	{
+		const TConstArrayView<FTArrayTestStruct> Values = Array->Array_View();
+		Columns.Reserve(Values.Num(), false, false);
+		for (const FTArrayTestStruct& Value : Values)
+			Columns.Add(Value.Name, Value.Number);
+	});
+}
+
+bool FContainerSnapshot::LoadIntoArray(UTArray* Array, const FString& FilePath, bool bBroadcast, FContainerSnapshotReport& OutReport)
+{
+	if (Array == nullptr)
+		return false;
+	return LoadRows<FTArrayTestStruct>(FilePath, EContainerSnapshotKind::E_Array, OutReport, [Array, bBroadcast](TArray<FTArrayTestStruct>&& Rows, const FContainerSnapshotReader&)
+	{
+		Array->Array_AppendMoved(MoveTemp(Rows), bBroadcast);
+	});
+}
+
+bool FContainerSnapshot::SaveMap(UTMap* Map, const FString& FilePath, FContainerSnapshotReport& OutReport)
+{
+	if (Map == nullptr)
+		return false;
+	return SaveColumns(FilePath, EContainerSnapshotKind::E_Map, OutReport, [Map](FContainerSnapshotColumns& Columns)
+	{
+		const TMap<FGuid, FMapTestStruct>& Values = Map->Map_View();
+		Columns.Reserve(Values.Num(), true, false);
+		for (const TPair<FGuid, FMapTestStruct>& KvP : Values)
+		{
+			Columns.Add(KvP.Value.Name, KvP.Value.Number);
+			Columns.Guids.Add(KvP.Value.Guid);
+		}
+	});
+}
+
+bool FContainerSnapshot::LoadIntoMap(UTMap* Map, const FString& FilePath, bool bBroadcast, FContainerSnapshotReport& OutReport)
+{
+	if (Map == nullptr)
+		return false;
+	return LoadRows<FMapTestStruct>(FilePath, EContainerSnapshotKind::E_Map, OutReport, [Map, bBroadcast](TArray<FMapTestStruct>&& Rows, const FContainerSnapshotReader&)
+	{
+		Map->Map_AppendMoved(MoveTemp(Rows), bBroadcast);
+	});
+}
+
+bool FContainerSnapshot::SaveSet(UTSet* Set, const FString& FilePath, FContainerSnapshotReport& OutReport)
+{
+	if (Set == nullptr)
+		return false;
+	return SaveColumns(FilePath, EContainerSnapshotKind::E_Set, OutReport, [Set](FContainerSnapshotColumns& Columns)
+	{
+		const TSet<FTSetTestStruct>& Values = Set->Set_View();
+		Columns.Reserve(Values.Num(), false, false);
+		for (const FTSetTestStruct& Value : Values)
+			Columns.Add(Value.Name, Value.Number);
+	});
+}
+
+bool FContainerSnapshot::LoadIntoSet(UTSet* Set, const FString& FilePath, bool bBroadcast, FContainerSnapshotReport& OutReport)
+{
+	if (Set == nullptr)
+		return false;
+	return LoadRows<FTSetTestStruct>(FilePath, EContainerSnapshotKind::E_Set, OutReport, [Set, bBroadcast](TArray<FTSetTestStruct>&& Rows, const FContainerSnapshotReader&)
+	{
+		Set->Set_AppendMoved(MoveTemp(Rows), bBroadcast);
+	});
+}
+
+bool FContainerSnapshot::SaveMultiMap(UTMultiMap* MultiMap, const FString& FilePath, FContainerSnapshotReport& OutReport)
+{
+	if (MultiMap == nullptr)
+		return false;
+	return SaveColumns(FilePath, EContainerSnapshotKind::E_MultiMap, OutReport, [MultiMap](FContainerSnapshotColumns& Columns)
+	{
+		// key by key, so the loader gets every key as one contiguous group
+		const int32 NumValues = MultiMap->MM_View().Num();
+		Columns.Reserve(NumValues, true, true);
+		for (const FGuid& Key : MultiMap->MM_GetKeys())
+		{
+			MultiMap->MM_ForEachValue(Key, [&Columns, &Key](const FTMultiMapTestStruct& Value)
+			{
+				Columns.Add(Value.Name, Value.Number);
+				Columns.Guids.Add(Value.Guid);
+				Columns.Keys.Add(Key);
+			});
+		}
+	});
+}
+
+bool FContainerSnapshot::LoadIntoMultiMap(UTMultiMap* MultiMap, const FString& FilePath, bool bBroadcast, FContainerSnapshotReport& OutReport)
+{
+	if (MultiMap == nullptr)
+		return false;
+	return LoadRows<FTMultiMapTestStruct>(FilePath, EContainerSnapshotKind::E_MultiMap, OutReport, [MultiMap, bBroadcast](TArray<FTMultiMapTestStruct>&& Rows, const FContainerSnapshotReader& Reader)
+	{
+		// consecutive rows with the same key form one group
+		const TConstArrayView<FGuid> Keys = Reader.GetKeys();
+		TArray<TPair<FGuid, TArray<FTMultiMapTestStruct>>> Groups;
+		for (int32 Start = 0; Start < Rows.Num(); )
+		{
+			int32 End = Start + 1;
+			while (End < Rows.Num() && Keys[End] == Keys[Start])
+				++End;
+			TPair<FGuid, TArray<FTMultiMapTestStruct>>& Group = Groups.Emplace_GetRef(Keys[Start], TArray<FTMultiMapTestStruct>());
+			Group.Value.Reserve(End - Start);
+			for (int32 i = Start; i < End; ++i)
+				Group.Value.Add(MoveTemp(Rows[i]));
+			Start = End;
+		}
+		Rows.Reset();
+		MultiMap->MM_AddGroupsMoved(MoveTemp(Groups), bBroadcast);
+	});
+}
+
+bool FContainerSnapshot::DrainQueue(UTQueue* Queue, const FString& FilePath, FContainerSnapshotReport& OutReport)
+{
+	if (Queue == nullptr)
+		return false;
+	TArray<FQueueTestStruct> Items;
+	Queue->DequeueBatch(Items, MAX_int32);
+	const bool bSaved = SaveColumns(FilePath, EContainerSnapshotKind::E_Queue, OutReport, [&Items](FContainerSnapshotColumns& Columns)
+	{
+		Columns.Reserve(Items.Num(), false, false);
+		for (const FQueueTestStruct& Item : Items)
+			Columns.Add(Item.Name, Item.Number);
+	});
+	if (!bSaved && Items.Num() > 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("ContainerSnapshot: %d drained items could not be written to '%s' and were enqueued again"), Items.Num(), *FilePath);
+		Queue->EnqueueMoved(MoveTemp(Items));
+	}
+	return bSaved;
+}
+
+bool FContainerSnapshot::LoadIntoQueue(UTQueue* Queue, const FString& FilePath, FContainerSnapshotReport& OutReport)
+{
+	if (Queue == nullptr)
+		return false;
+	return LoadRows<FQueueTestStruct>(FilePath, EContainerSnapshotKind::E_Queue, OutReport, [Queue](TArray<FQueueTestStruct>&& Rows, const FContainerSnapshotReader&)
+	{
+		Queue->EnqueueMoved(MoveTemp(Rows));
+	});
+}
+#pragma endregion Containers
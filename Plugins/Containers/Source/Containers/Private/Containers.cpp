@@ -34,6 +34,11 @@ void FContainersModule::StartupModule()
 			, new FSlateImageBrush(BA_StyleSet->RootToContentDir("Array.png"), Icon16x16));
 		BA_StyleSet->Set("ClassThumbnail.TArray"
 			, new FSlateImageBrush(BA_StyleSet->RootToContentDir("Array.png"), Icon64x64));
+		// TColumnarArray
+		BA_StyleSet->Set("ClassIcon.TColumnarArray"
+			, new FSlateImageBrush(BA_StyleSet->RootToContentDir("Array.png"), Icon16x16));
+		BA_StyleSet->Set("ClassThumbnail.TColumnarArray"
+			, new FSlateImageBrush(BA_StyleSet->RootToContentDir("Array.png"), Icon64x64));
 		// TMap
 		BA_StyleSet->Set("ClassIcon.TMap"
 			, new FSlateImageBrush(BA_StyleSet->RootToContentDir("Map.png"), Icon16x16));
@@ -44,16 +49,36 @@ void FContainersModule::StartupModule()
 			, new FSlateImageBrush(BA_StyleSet->RootToContentDir("MultiMap.png"), Icon16x16));
 		BA_StyleSet->Set("ClassThumbnail.TMultiMap"
 			, new FSlateImageBrush(BA_StyleSet->RootToContentDir("MultiMap.png"), Icon64x64));
+		// TBucketedMultiMap
+		BA_StyleSet->Set("ClassIcon.TBucketedMultiMap"
+			, new FSlateImageBrush(BA_StyleSet->RootToContentDir("MultiMap.png"), Icon16x16));
+		BA_StyleSet->Set("ClassThumbnail.TBucketedMultiMap"
+			, new FSlateImageBrush(BA_StyleSet->RootToContentDir("MultiMap.png"), Icon64x64));
 		// TQueue
 		BA_StyleSet->Set("ClassIcon.TQueue"
 			, new FSlateImageBrush(BA_StyleSet->RootToContentDir("Queue.png"), Icon16x16));
 		BA_StyleSet->Set("ClassThumbnail.TQueue"
 			, new FSlateImageBrush(BA_StyleSet->RootToContentDir("Queue.png"), Icon64x64));
+		// TRingQueue
+		BA_StyleSet->Set("ClassIcon.TRingQueue"
+			, new FSlateImageBrush(BA_StyleSet->RootToContentDir("Queue.png"), Icon16x16));
+		BA_StyleSet->Set("ClassThumbnail.TRingQueue"
+			, new FSlateImageBrush(BA_StyleSet->RootToContentDir("Queue.png"), Icon64x64));
+		// TStack
+		BA_StyleSet->Set("ClassIcon.TStack"
+			, new FSlateImageBrush(BA_StyleSet->RootToContentDir("Queue.png"), Icon16x16));
+		BA_StyleSet->Set("ClassThumbnail.TStack"
+			, new FSlateImageBrush(BA_StyleSet->RootToContentDir("Queue.png"), Icon64x64));
 		// TSet
 		BA_StyleSet->Set("ClassIcon.TSet"
 			, new FSlateImageBrush(BA_StyleSet->RootToContentDir("Set.png"), Icon16x16));
 		BA_StyleSet->Set("ClassThumbnail.TSet"
 			, new FSlateImageBrush(BA_StyleSet->RootToContentDir("Set.png"), Icon64x64));
+		// TSortedSet
+		BA_StyleSet->Set("ClassIcon.TSortedSet"
+			, new FSlateImageBrush(BA_StyleSet->RootToContentDir("Set.png"), Icon16x16));
+		BA_StyleSet->Set("ClassThumbnail.TSortedSet"
+			, new FSlateImageBrush(BA_StyleSet->RootToContentDir("Set.png"), Icon64x64));
 #pragma endregion
 
 		// register
@@ -0,0 +1,251 @@
+// Developer Bastian © 2024
+// License Creative Commons DEED 4.0 (https://creativecommons.org/licenses/by-sa/4.0/deed.en)
+
+#include "QueueConsumerPool.h"
+#include "Async/Async.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/ScopeLock.h"
+
+/**
+ * One worker thread of UTQueueConsumerPool with its local deque.
+ * The owner takes from the front, thieves from the back, both under Lock.
+ */
+class FQueueConsumerWorker : public FRunnable
+{
+public:
+	FQueueConsumerWorker(UTQueueConsumerPool& InPool, int32 InIndex)
+		: Pool(InPool), Index(InIndex)
+	{
+	}
+
+	virtual uint32 Run() override
+	{
+		Pool.RunWorker(Index);
+		return 0;
+	}
+
+	bool PopFront(FQueueTestStruct& OutItem)
+	{
+		UE::TScopeLock<UE::FSpinLock> ScopeLock(Lock);
+		if (Head >= Items.Num())
+			return false;
+		OutItem = MoveTemp(Items[Head++]);
+		if (Head == Items.Num())
+		{
+			Items.Reset();
+			Head = 0;
+		}
+		return true;
+	}
+
+	void Append(TArray<FQueueTestStruct>&& NewItems)
+	{
+		UE::TScopeLock<UE::FSpinLock> ScopeLock(Lock);
+		Items.Append(MoveTemp(NewItems));
+	}
+
+	// Moves the back half of the remaining items to OutItems, leaves a single item to its owner
+	int32 StealBackHalf(TArray<FQueueTestStruct>& OutItems)
+	{
+		UE::TScopeLock<UE::FSpinLock> ScopeLock(Lock);
+		const int32 Remaining = Items.Num() - Head;
+		if (Remaining < 2)
+			return 0;
+		const int32 NumStolen = Remaining / 2;
+		const int32 First = Items.Num() - NumStolen;
+		for (int32 i = First; i < Items.Num(); ++i)
+			OutItems.Add(MoveTemp(Items[i]));
+		Items.RemoveAt(First, NumStolen, false);
+		return NumStolen;
+	}
+
+	UTQueueConsumerPool& Pool;
+	const int32 Index;
+	TUniquePtr<FRunnableThread> Thread;
+
+private:
+	UE::FSpinLock Lock;
+	TArray<FQueueTestStruct> Items;
+	int32 Head = 0;
+};
+
+void UTQueueConsumerPool::BeginDestroy()
+{
+	// nobody listens any more, the remaining results are dropped
+	StopWorkers(false);
+	Super::BeginDestroy();
+}
+
+void UTQueueConsumerPool::Pool_SetHandler(FHandler InHandler)
+{
+	if (Pool_IsRunning())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("UTQueueConsumerPool: the handler can only be set while the pool is stopped"));
+		return;
+	}
+	this->Handler = MoveTemp(InHandler);
+}
+
+bool UTQueueConsumerPool::Pool_Start(UTQueue* InQueue, int32 NumWorkers, int32 InBatchSize)
+{
+	BA_CONTAINER_SCOPE("UTQueueConsumerPool::Pool_Start");
+	if (Pool_IsRunning() || InQueue == nullptr)
+		return false;
+	this->Queue = InQueue;
+	this->BatchSize = FMath::Max(InBatchSize, 1);
+	this->bStopRequested = false;
+	this->bDrainOnStop = false;
+
+	NumWorkers = FMath::Clamp(NumWorkers, 1, FPlatformMisc::NumberOfCoresIncludingHyperthreads());
+	// all workers exist before the first one runs, so thieves can look at every deque
+	for (int32 i = 0; i < NumWorkers; ++i)
+		this->Workers.Add(MakeUnique<FQueueConsumerWorker>(*this, i));
+	for (int32 i = 0; i < NumWorkers; ++i)
+	{
+		this->Workers[i]->Thread.Reset(FRunnableThread::Create(this->Workers[i].Get()
+			, *FString::Printf(TEXT("BAQueueConsumer%d"), i), 0, TPri_Normal));
+	}
+	return true;
+}
+
+void UTQueueConsumerPool::Pool_Stop(bool DrainQueue)
+{
+	BA_CONTAINER_SCOPE("UTQueueConsumerPool::Pool_Stop");
+	StopWorkers(DrainQueue);
+	if (IsInGameThread())
+		FlushResults();
+}
+
+bool UTQueueConsumerPool::Pool_IsRunning() const
+{
+	return this->Workers.Num() > 0;
+}
+
+int64 UTQueueConsumerPool::Pool_GetProcessedCount() const
+{
+	return this->ProcessedCount.load(std::memory_order_relaxed);
+}
+
+int64 UTQueueConsumerPool::Pool_GetStolenCount() const
+{
+	return this->StolenCount.load(std::memory_order_relaxed);
+}
+
+void UTQueueConsumerPool::StopWorkers(bool bDrainQueue)
+{
+	if (!Pool_IsRunning())
+		return;
+	this->bDrainOnStop = bDrainQueue;
+	this->bStopRequested = true;
+	this->Queue->GetItemsSignal().WakeAll();
+	for (const TUniquePtr<FQueueConsumerWorker>& Worker : this->Workers)
+	{
+		if (Worker->Thread.IsValid())
+			Worker->Thread->WaitForCompletion();
+	}
+	// threads first, their runnables are still referenced until they are gone
+	for (const TUniquePtr<FQueueConsumerWorker>& Worker : this->Workers)
+		Worker->Thread.Reset();
+	this->Workers.Reset();
+}
+
+void UTQueueConsumerPool::RunWorker(int32 Index)
+{
+	FQueueConsumerWorker& Self = *this->Workers[Index];
+	TArray<FQueueTestStruct> Results;
+	FQueueTestStruct Item;
+	for (;;)
+	{
+		// own batch first, then the queue, then the other workers
+		if (Self.PopFront(Item) || (RefillFromQueue(Self) && Self.PopFront(Item)) || (StealFor(Index) && Self.PopFront(Item)))
+		{
+			if (!this->Handler || this->Handler(Item))
+				Results.Add(MoveTemp(Item));
+			this->ProcessedCount.fetch_add(1, std::memory_order_relaxed);
+			if (Results.Num() >= this->BatchSize)
+				PostResults(Results);
+			continue;
+		}
+		// idle - whatever is done goes out now instead of waiting for a full batch
+		PostResults(Results);
+		if (this->bStopRequested.load(std::memory_order_acquire))
+		{
+			if (!this->bDrainOnStop.load(std::memory_order_relaxed) || this->Queue->IsEmpty())
+				break;
+			continue;
+		}
+		// sleeps until a producer enqueues, another worker has items to steal or the pool stops
+		this->Queue->GetItemsSignal().Wait([this]()
+		{
+			return this->bStopRequested.load() || !this->Queue->IsEmpty();
+		});
+	}
+	PostResults(Results);
+	// a sleeping worker may have lost the stop wake-up to this one, so it is passed on
+	this->Queue->GetItemsSignal().WakeAll();
+}
+
+bool UTQueueConsumerPool::RefillFromQueue(FQueueConsumerWorker& Worker)
+{
+	if (this->bStopRequested.load(std::memory_order_acquire) && !this->bDrainOnStop.load(std::memory_order_relaxed))
+		return false;
+	TArray<FQueueTestStruct> Batch;
+	// another worker is taking a batch right now - better to steal from it than to wait
+	if (this->Queue->DequeueBatch(Batch, this->BatchSize, false) == 0)
+		return false;
+	const bool bStealable = Batch.Num() > 1;
+	Worker.Append(MoveTemp(Batch));
+	// idle workers may take a share of the batch
+	if (bStealable)
+		this->Queue->GetItemsSignal().Notify();
+	return true;
+}
+
+bool UTQueueConsumerPool::StealFor(int32 Index)
+{
+	const int32 NumWorkers = this->Workers.Num();
+	TArray<FQueueTestStruct> Stolen;
+	for (int32 Offset = 1; Offset < NumWorkers; ++Offset)
+	{
+		const int32 NumStolen = this->Workers[(Index + Offset) % NumWorkers]->StealBackHalf(Stolen);
+		if (NumStolen > 0)
+		{
+			this->StolenCount.fetch_add(NumStolen, std::memory_order_relaxed);
+			this->Workers[Index]->Append(MoveTemp(Stolen));
+			return true;
+		}
+	}
+	return false;
+}
+
+void UTQueueConsumerPool::PostResults(TArray<FQueueTestStruct>& Results)
+{
+	if (Results.Num() == 0)
+		return;
+	{
+		UE::TScopeLock<UE::FSpinLock> Lock(this->ResultsLock);
+		this->PendingResults.Append(MoveTemp(Results));
+	}
+	Results.Reset();
+	// one game thread task for everything posted until it runs
+	if (this->bResultsScheduled.exchange(true))
+		return;
+	AsyncTask(ENamedThreads::GameThread, [WeakThis = TWeakObjectPtr<UTQueueConsumerPool>(this)]()
+	{
+		if (UTQueueConsumerPool* Pool = WeakThis.Get())
+			Pool->FlushResults();
+	});
+}
+
+void UTQueueConsumerPool::FlushResults()
+{
+	this->bResultsScheduled = false;
+	TArray<FQueueTestStruct> Results;
+	{
+		UE::TScopeLock<UE::FSpinLock> Lock(this->ResultsLock);
+		Results = MoveTemp(this->PendingResults);
+	}
+	if (Results.Num() > 0)
+		this->OnItemsProcessed_Delegate.Broadcast(Results);
+}
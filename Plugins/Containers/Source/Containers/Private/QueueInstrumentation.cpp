@@ -0,0 +1,93 @@
+// Developer Bastian © 2024
+// License Creative Commons DEED 4.0 (https://creativecommons.org/licenses/by-sa/4.0/deed.en)
+
+#include "QueueInstrumentation.h"
+#include "ContainerProfiler.h"
+
+FQueueInstrumentation::FQueueInstrumentation()
+	: LastSampleNanoseconds(Timer::NowNanoseconds())
+{
+}
+
+void FQueueInstrumentation::OnDequeue(uint64 EnqueueNanoseconds)
+{
+	if ((this->TotalDequeued.fetch_add(1, std::memory_order_relaxed) & (HighWaterMarkInterval - 1)) == 0)
+	{
+		// the item is already counted as dequeued, it was still in the queue a moment ago
+		UpdateHighWaterMark(1);
+	}
+
+	const uint64 Now = Timer::NowNanoseconds();
+	const uint64 Latency = Now > EnqueueNanoseconds ? Now - EnqueueNanoseconds : 0;
+	this->LatencyTotal.fetch_add(Latency, std::memory_order_relaxed);
+	this->LatencyCount.fetch_add(1, std::memory_order_relaxed);
+	if (Latency > this->LatencyMax.load(std::memory_order_relaxed))
+		this->LatencyMax.store(Latency, std::memory_order_relaxed);
+
+	// the profiler keeps the latency histogram, so percentiles come for free
+	FContainerProfiler& Profiler = FContainerProfiler::Get();
+	if (Profiler.IsEnabled())
+	{
+		static const int32 LatencyNode = Profiler.RegisterOperation(TEXT("UTQueue::Latency"));
+		if (LatencyNode != INDEX_NONE)
+			Profiler.Record(LatencyNode, Latency);
+	}
+}
+
+FQueueMetrics FQueueInstrumentation::Sample()
+{
+	UpdateHighWaterMark(0);
+	FQueueMetrics Metrics;
+	const int64 Enqueued = GetTotalEnqueued();
+	const int64 Dequeued = this->TotalDequeued.load(std::memory_order_relaxed);
+	Metrics.Depth = (int32)FMath::Max<int64>(Enqueued - Dequeued, 0);
+	Metrics.TotalEnqueued = Enqueued - this->ResetEnqueued;
+	Metrics.TotalDequeued = Dequeued - this->ResetDequeued;
+	Metrics.HighWaterMark = (int32)this->HighWaterMark.load(std::memory_order_relaxed);
+
+	const uint64 Now = Timer::NowNanoseconds();
+	Metrics.SampleSeconds = (Now - this->LastSampleNanoseconds) / 1000000000.0;
+	if (Metrics.SampleSeconds > 0.0)
+	{
+		Metrics.EnqueuePerSecond = (float)((Metrics.TotalEnqueued - this->LastEnqueued) / Metrics.SampleSeconds);
+		Metrics.DequeuePerSecond = (float)((Metrics.TotalDequeued - this->LastDequeued) / Metrics.SampleSeconds);
+	}
+	this->LastSampleNanoseconds = Now;
+	this->LastEnqueued = Metrics.TotalEnqueued;
+	this->LastDequeued = Metrics.TotalDequeued;
+
+	const int64 NumLatencies = this->LatencyCount.load(std::memory_order_relaxed);
+	if (NumLatencies > 0)
+		Metrics.AverageLatencyMilliseconds = this->LatencyTotal.load(std::memory_order_relaxed) / (double)NumLatencies / 1000000.0;
+	Metrics.MaxLatencyMilliseconds = this->LatencyMax.load(std::memory_order_relaxed) / 1000000.0;
+	return Metrics;
+}
+
+void FQueueInstrumentation::Reset()
+{
+	// the counters keep running, producers may be incrementing them right now - the totals start from here
+	this->ResetEnqueued = GetTotalEnqueued();
+	this->ResetDequeued = this->TotalDequeued.load(std::memory_order_relaxed);
+	this->HighWaterMark = FMath::Max<int64>(this->ResetEnqueued - this->ResetDequeued, 0);
+	this->LatencyTotal = 0;
+	this->LatencyMax = 0;
+	this->LatencyCount = 0;
+	this->LastSampleNanoseconds = Timer::NowNanoseconds();
+	this->LastEnqueued = 0;
+	this->LastDequeued = 0;
+}
+
+int64 FQueueInstrumentation::GetTotalEnqueued() const
+{
+	int64 Total = 0;
+	for (const FShard& Shard : this->EnqueueShards)
+		Total += Shard.Value.load(std::memory_order_relaxed);
+	return Total;
+}
+
+void FQueueInstrumentation::UpdateHighWaterMark(int64 JustDequeued)
+{
+	const int64 Depth = GetTotalEnqueued() - this->TotalDequeued.load(std::memory_order_relaxed) + JustDequeued;
+	if (Depth > this->HighWaterMark.load(std::memory_order_relaxed))
+		this->HighWaterMark.store(Depth, std::memory_order_relaxed);
+}
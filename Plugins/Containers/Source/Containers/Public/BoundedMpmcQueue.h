@@ -0,0 +1,182 @@
+// Developer Bastian © 2024
+// License Creative Commons DEED 4.0 (https://creativecommons.org/licenses/by-sa/4.0/deed.en)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/UniquePtr.h"
+#include "Templates/TypeCompatibleBytes.h"
+#include "HAL/PlatformProcess.h"
+#include <atomic>
+
+/**
+ * Bounded multi-producer multi-consumer queue on a ring buffer (after Dmitry Vyukov).
+ *
+ * Every cell carries a sequence number that tells producers and consumers whose turn it is, so a
+ * push or pop is one compare-and-swap on the shared position plus one store on the cell - no lock
+ * and no allocation after construction. The capacity is rounded up to a power of two.
+ *
+ * The enqueue and dequeue positions sit on cache lines of their own, so producers and consumers
+ * do not invalidate each other's line on every operation.
+ *
+ * Peek pins the oldest cell with a per-cell reader count. A consumer that claims a pinned cell waits
+ * for the copy to finish before it moves the element out - no other cell and no producer waits.
+ */
+template <typename ElementType>
+class TBoundedMpmcQueue
+{
+public:
+	explicit TBoundedMpmcQueue(uint32 InCapacity)
+		: Mask(FMath::RoundUpToPowerOfTwo(FMath::Max<uint32>(InCapacity, 2)) - 1)
+		, Cells(MakeUnique<FCell[]>(Mask + 1))
+	{
+		for (uint64 i = 0; i <= Mask; ++i)
+			Cells[i].Sequence.store(i, std::memory_order_relaxed);
+	}
+
+	~TBoundedMpmcQueue()
+	{
+		ElementType Value;
+		while (TryDequeue(Value))
+		{
+		}
+	}
+
+	TBoundedMpmcQueue(const TBoundedMpmcQueue&) = delete;
+	TBoundedMpmcQueue& operator=(const TBoundedMpmcQueue&) = delete;
+
+	FORCEINLINE uint32 Capacity() const
+	{
+		return (uint32)(Mask + 1);
+	}
+
+	// Number of stored elements - only a snapshot while other threads push or pop
+	FORCEINLINE uint32 Num() const
+	{
+		const uint64 Head = DequeuePos.Value.load(std::memory_order_acquire);
+		const uint64 Tail = EnqueuePos.Value.load(std::memory_order_acquire);
+		return Tail > Head ? (uint32)FMath::Min<uint64>(Tail - Head, Capacity()) : 0;
+	}
+
+	FORCEINLINE bool IsEmpty() const
+	{
+		return Num() == 0;
+	}
+
+	// Adds a copy of Value, returns false without waiting if the queue is full
+	FORCEINLINE bool TryEnqueue(const ElementType& Value)
+	{
+		return Emplace(Value);
+	}
+
+	// Moves Value in, returns false without waiting if the queue is full - Value is untouched then
+	FORCEINLINE bool TryEnqueue(ElementType&& Value)
+	{
+		return Emplace(MoveTemp(Value));
+	}
+
+	// Moves the oldest element to OutValue, returns false without waiting if the queue is empty
+	bool TryDequeue(ElementType& OutValue)
+	{
+		FCell* Cell;
+		uint64 Pos = DequeuePos.Value.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			Cell = &Cells[Pos & Mask];
+			const uint64 Sequence = Cell->Sequence.load(std::memory_order_acquire);
+			const int64 Diff = (int64)Sequence - (int64)(Pos + 1);
+			if (Diff == 0)
+			{
+				// seq_cst pairs with Peek, which pins the cell and then re-reads the position
+				if (DequeuePos.Value.compare_exchange_weak(Pos, Pos + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+					break;
+			}
+			else if (Diff < 0)
+				return false;
+			else
+				Pos = DequeuePos.Value.load(std::memory_order_relaxed);
+		}
+		// a Peek may still be copying this element
+		while (Cell->Readers.load(std::memory_order_seq_cst) != 0)
+			FPlatformProcess::YieldThread();
+		ElementType* Stored = Cell->Storage.GetTypedPtr();
+		OutValue = MoveTemp(*Stored);
+		DestructItem(Stored);
+		// the cell is free for the producer one lap ahead
+		Cell->Sequence.store(Pos + Mask + 1, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * Copies the oldest element without removing it, returns false if the queue is empty.
+	 * Safe next to other consumers: the cell is pinned while copying, and once the position moved on
+	 * the pin is dropped and the next oldest element is tried.
+	 */
+	bool Peek(ElementType& OutValue) const
+	{
+		for (;;)
+		{
+			const uint64 Pos = DequeuePos.Value.load(std::memory_order_seq_cst);
+			FCell& Cell = Cells[Pos & Mask];
+			const int64 Diff = (int64)Cell.Sequence.load(std::memory_order_acquire) - (int64)(Pos + 1);
+			if (Diff < 0)
+				return false;
+			if (Diff > 0)
+				// already taken by another consumer
+				continue;
+			Cell.Readers.fetch_add(1, std::memory_order_seq_cst);
+			// nobody claimed the cell before the pin, so whoever claims it now waits for the copy
+			const bool bPinned = DequeuePos.Value.load(std::memory_order_seq_cst) == Pos;
+			if (bPinned)
+				OutValue = *Cell.Storage.GetTypedPtr();
+			Cell.Readers.fetch_sub(1, std::memory_order_release);
+			if (bPinned)
+				return true;
+		}
+	}
+
+private:
+	template <typename ArgType>
+	bool Emplace(ArgType&& Value)
+	{
+		FCell* Cell;
+		uint64 Pos = EnqueuePos.Value.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			Cell = &Cells[Pos & Mask];
+			const uint64 Sequence = Cell->Sequence.load(std::memory_order_acquire);
+			const int64 Diff = (int64)Sequence - (int64)Pos;
+			if (Diff == 0)
+			{
+				if (EnqueuePos.Value.compare_exchange_weak(Pos, Pos + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if (Diff < 0)
+				// the consumer of the previous lap has not freed this cell yet - full
+				return false;
+			else
+				Pos = EnqueuePos.Value.load(std::memory_order_relaxed);
+		}
+		new (Cell->Storage.GetTypedPtr()) ElementType(Forward<ArgType>(Value));
+		Cell->Sequence.store(Pos + 1, std::memory_order_release);
+		return true;
+	}
+
+	struct FCell
+	{
+		std::atomic<uint64> Sequence;
+		// number of Peeks copying the element right now
+		mutable std::atomic<int32> Readers{ 0 };
+		TTypeCompatibleBytes<ElementType> Storage;
+	};
+
+	struct alignas(PLATFORM_CACHE_LINE_SIZE) FPaddedPosition
+	{
+		std::atomic<uint64> Value{ 0 };
+	};
+
+	const uint64 Mask;
+	TUniquePtr<FCell[]> Cells;
+	FPaddedPosition EnqueuePos;
+	FPaddedPosition DequeuePos;
+};
@@ -0,0 +1,117 @@
+// Developer Bastian © 2024
+// License Creative Commons DEED 4.0 (https://creativecommons.org/licenses/by-sa/4.0/deed.en)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintFunctionLibrary.h"
+#include "ContainerCsvLoader.h"
+
+#include "ContainerBenchmark.generated.h"
+
+/**
+ * One measured operation of the container benchmark
+ */
+USTRUCT(BlueprintType)
+struct FContainerBenchmarkResult
+{
+public:
+	GENERATED_USTRUCT_BODY()
+
+	// container class, e.g. "UTArray" - "TArray+Lock" is the locked array baseline of the stack benchmark
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Container Benchmark")
+	FString Container;
+
+	// measured operation: Add, BulkAdd, Lookup, LookupMiss, BloomLookupMiss, Remove, BulkRemove, SortByNumber, SortByName, ParallelSortByNumber, ParallelSortByName, SortByKey, Filter, FilterNumber, IndexBuild, FilterIndexed, RangeIndexed, Aggregate, CountPerKey, GroupBy, Union, Intersect, Range, ContendedPushPop, Rename or Iterate
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Container Benchmark")
+	FString Operation;
+
+	// number of rows in the container when the operation ran
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Container Benchmark")
+	int32 Rows;
+
+	// number of calls that were timed - lookups and removes only sample a part of the rows
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Container Benchmark")
+	int32 Calls;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Container Benchmark")
+	double TotalMilliseconds;
+
+	// TotalMilliseconds divided by Rows for whole-container operations, by Calls otherwise
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Container Benchmark")
+	double NanosecondsPerElement;
+
+	FContainerBenchmarkResult() : Container(""), Operation(""), Rows(0), Calls(0), TotalMilliseconds(0.0), NanosecondsPerElement(0.0)
+	{
+	}
+};
+
+/**
+ * Benchmark driver for all container classes.
+ * Loads WorldCities.csv, scales it synthetically to the requested row counts and times
+ * add, lookup, remove, sort, filter and iterate through the public container API.
+ */
+class CONTAINERS_API FContainerBenchmark
+{
+public:
+	// Resources/WorldCities.csv of this plugin
+	static FString GetDefaultDatasetPath();
+
+	// Reads Name and Number of every row, returns false if the file can not be read
+	static bool LoadDataset(const FString& Path, TArray<FContainerCsvRow>& OutRows);
+
+	/**
+	 * Repeats the dataset until it has Rows entries.
+	 * Copies after the first one get a "#<copy>" suffix on the name and their copy index added to the number,
+	 * so names stay unique and numbers keep the distribution of the original data.
+	 */
+	static void ScaleDataset(const TArray<FContainerCsvRow>& Source, int32 Rows, TArray<FContainerCsvRow>& OutRows);
+
+	// Runs all container benchmarks for every row count
+	static TArray<FContainerBenchmarkResult> Run(const TArray<FContainerCsvRow>& Dataset, const TArray<int32>& RowCounts);
+
+	static FString ToCSV(const TArray<FContainerBenchmarkResult>& Results);
+	static FString ToJSON(const TArray<FContainerBenchmarkResult>& Results);
+
+	// Parses a file written by ToCSV, used as baseline for regression checks
+	static bool LoadCSV(const FString& Path, TArray<FContainerBenchmarkResult>& OutResults);
+
+	/**
+	 * Compares Results against Baseline and lists every operation that got slower by more than Tolerance
+	 * (0.2 = 20% slower per element). Returns the number of regressions.
+	 */
+	static int32 FindRegressions(const TArray<FContainerBenchmarkResult>& Results, const TArray<FContainerBenchmarkResult>& Baseline
+		, double Tolerance, TArray<FString>& OutMessages);
+
+private:
+	static void RunArray(const TArray<FContainerCsvRow>& Rows, TArray<FContainerBenchmarkResult>& Results);
+	static void RunColumnarArray(const TArray<FContainerCsvRow>& Rows, TArray<FContainerBenchmarkResult>& Results);
+	static void RunMap(const TArray<FContainerCsvRow>& Rows, TArray<FContainerBenchmarkResult>& Results);
+	template <typename MultiMapType>
+	static void RunMultiMap(const TCHAR* Container, const TArray<FContainerCsvRow>& Rows, TArray<FContainerBenchmarkResult>& Results);
+	static void RunSet(const TArray<FContainerCsvRow>& Rows, TArray<FContainerBenchmarkResult>& Results);
+	static void RunSortedSet(const TArray<FContainerCsvRow>& Rows, TArray<FContainerBenchmarkResult>& Results);
+	static void RunQueue(const TArray<FContainerCsvRow>& Rows, TArray<FContainerBenchmarkResult>& Results);
+	static void RunRingQueue(const TArray<FContainerCsvRow>& Rows, TArray<FContainerBenchmarkResult>& Results);
+	static void RunStack(const TArray<FContainerCsvRow>& Rows, TArray<FContainerBenchmarkResult>& Results);
+};
+
+/**
+ * Blueprint access to the container benchmark
+ */
+UCLASS()
+class CONTAINERS_API UContainerBenchmarkLibrary : public UBlueprintFunctionLibrary
+{
+	GENERATED_BODY()
+
+public:
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Benchmark"
+		, meta = (CompactNodeTitle = "Run Benchmark"
+			, ToolTip = "Runs the container benchmark on WorldCities.csv scaled to each row count. Blocks the calling thread - large row counts take minutes"))
+	static TArray<FContainerBenchmarkResult> Benchmark_Run(const TArray<int32>& RowCounts);
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Benchmark"
+		, meta = (CompactNodeTitle = "Save Benchmark"
+			, ToolTip = "Writes benchmark results as .csv or .json, depending on the file extension. Relative paths are resolved against the project's Saved directory"))
+	static bool Benchmark_Save(const TArray<FContainerBenchmarkResult>& Results, const FString& FilePath);
+};
@@ -0,0 +1,225 @@
+// Developer Bastian © 2024
+// License Creative Commons DEED 4.0 (https://creativecommons.org/licenses/by-sa/4.0/deed.en)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/Guid.h"
+
+#include "ContainerBloomFilter.generated.h"
+
+/**
+ * Counters of a container's Bloom filter since it was enabled.
+ */
+USTRUCT(BlueprintType)
+struct FContainerBloomFilterStats
+{
+public:
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Bloom Filter Stats")
+	bool bEnabled;
+
+	// membership checks that asked the filter
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Bloom Filter Stats")
+	int64 Queries;
+
+	// checks the filter answered with "absent" without touching the container
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Bloom Filter Stats")
+	int64 FilteredNegatives;
+
+	// checks the filter passed on that found the value in the container
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Bloom Filter Stats")
+	int64 Hits;
+
+	// checks the filter passed on that did not find the value
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Bloom Filter Stats")
+	int64 FalsePositives;
+
+	// FalsePositives of all checks for absent values
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Bloom Filter Stats")
+	float FalsePositiveRate;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Bloom Filter Stats")
+	int32 Rebuilds;
+
+	// size of the filter and the values it was sized for
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Bloom Filter Stats")
+	int32 NumBits;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Bloom Filter Stats")
+	int32 Capacity;
+
+	FContainerBloomFilterStats() : bEnabled(false), Queries(0), FilteredNegatives(0), Hits(0), FalsePositives(0)
+		, FalsePositiveRate(0.f), Rebuilds(0), NumBits(0), Capacity(0)
+	{
+	}
+};
+
+/**
+ * Blocked Bloom filter in front of a container's membership checks.
+ *
+ * All probes of one value go to the same 512 bit block, so a check reads a single cache line.
+ * The owning container adds the hash of every inserted value and reports removals. A Bloom filter
+ * can not forget values, so removals only make it stale - once more than a quarter of its values
+ * are gone, or it holds more values than it was sized for, NeedsRebuild asks the owner to fill a
+ * new one, sized for the current number of values plus headroom. This happens lazily, on the next check.
+ */
+class FContainerBloomFilter
+{
+public:
+	static constexpr int32 BitsPerValue = 10;
+	static constexpr int32 NumProbes = 6;
+	static constexpr int32 BlockWords = 8;
+	static constexpr int32 MinCapacity = 1024;
+
+	FORCEINLINE bool IsEnabled() const
+	{
+		return bEnabled;
+	}
+
+	// Enabling starts with fresh stats and an empty filter that is filled on the first check
+	void SetEnabled(bool bInEnabled)
+	{
+		bEnabled = bInEnabled;
+		Blocks.Empty();
+		Stats = FContainerBloomFilterStats();
+		bDirty = true;
+	}
+
+	// Drops the content, the owner refills it on the next check
+	FORCEINLINE void Invalidate()
+	{
+		bDirty = true;
+	}
+
+	FORCEINLINE bool NeedsRebuild() const
+	{
+		return bEnabled && (bDirty || NumValues > Capacity || NumStale * 4 > NumValues);
+	}
+
+	/**
+	 * Sizes the filter for Num values and calls AddAll(FContainerBloomFilter&), which has to Add
+	 * the hash of every value of the container.
+	 */
+	template <typename AddAllType>
+	void Rebuild(int32 Num, AddAllType&& AddAll)
+	{
+		Capacity = FMath::Max(Num + Num / 2, MinCapacity);
+		const int32 NumBlocks = FMath::DivideAndRoundUp(Capacity * BitsPerValue, BlockWords * 64);
+		Blocks.SetNumZeroed(NumBlocks * BlockWords);
+		NumValues = 0;
+		NumStale = 0;
+		bDirty = false;
+		++Stats.Rebuilds;
+		AddAll(*this);
+	}
+
+	// Records a new value, ignored while disabled or waiting for a rebuild
+	FORCEINLINE void Add(uint64 ValueHash)
+	{
+		if (!bEnabled || bDirty)
+			return;
+		uint64* Block = GetBlock(ValueHash);
+		const uint64 Probes = Mix(ValueHash);
+		for (int32 Probe = 0; Probe < NumProbes; ++Probe)
+		{
+			const uint32 Bit = (uint32)(Probes >> (Probe * 9)) & 511u;
+			Block[Bit >> 6] |= 1ull << (Bit & 63);
+		}
+		++NumValues;
+	}
+
+	// Records Count removed values
+	FORCEINLINE void Remove(int32 Count = 1)
+	{
+		if (bEnabled)
+			NumStale += Count;
+	}
+
+	/**
+	 * True if the value with ValueHash is certainly not in the container - counted as a filtered negative.
+	 * Otherwise the owner checks its storage and reports the outcome with RecordLookup.
+	 */
+	FORCEINLINE bool Rejects(uint64 ValueHash)
+	{
+		++Stats.Queries;
+		const uint64* Block = GetBlock(ValueHash);
+		const uint64 Probes = Mix(ValueHash);
+		for (int32 Probe = 0; Probe < NumProbes; ++Probe)
+		{
+			const uint32 Bit = (uint32)(Probes >> (Probe * 9)) & 511u;
+			if ((Block[Bit >> 6] & (1ull << (Bit & 63))) == 0)
+			{
+				++Stats.FilteredNegatives;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	FORCEINLINE void RecordLookup(bool bFound)
+	{
+		if (bFound)
+			++Stats.Hits;
+		else
+			++Stats.FalsePositives;
+	}
+
+	FContainerBloomFilterStats GetStats() const
+	{
+		FContainerBloomFilterStats Result = Stats;
+		Result.bEnabled = bEnabled;
+		const int64 Negatives = Stats.FilteredNegatives + Stats.FalsePositives;
+		Result.FalsePositiveRate = Negatives > 0 ? (float)((double)Stats.FalsePositives / Negatives) : 0.f;
+		Result.NumBits = Blocks.Num() * 64;
+		Result.Capacity = bEnabled ? Capacity : 0;
+		return Result;
+	}
+
+	#pragma region Hashing
+	// 64 bit finalizer of SplitMix64 - the probes need well mixed bits, GetTypeHash of an int32 is the int itself
+	static FORCEINLINE uint64 Mix(uint64 Value)
+	{
+		Value = (Value ^ (Value >> 30)) * 0xBF58476D1CE4E5B9ull;
+		Value = (Value ^ (Value >> 27)) * 0x94D049BB133111EBull;
+		return Value ^ (Value >> 31);
+	}
+
+	static FORCEINLINE uint64 Hash(int32 Number)
+	{
+		return Mix((uint64)(uint32)Number);
+	}
+
+	static FORCEINLINE uint64 Hash(const FGuid& Guid)
+	{
+		return Mix(((uint64)Guid.A << 32 | Guid.B) ^ Mix((uint64)Guid.C << 32 | Guid.D));
+	}
+
+	static FORCEINLINE uint64 Hash(const FGuid& Guid, int32 Number)
+	{
+		return Mix(Hash(Guid) ^ (uint64)(uint32)Number);
+	}
+#pragma endregion Hashing
+
+private:
+	// the block comes from the lower 32 bits, the probes inside it from 54 bits of the hash mixed once more
+	FORCEINLINE uint64* GetBlock(uint64 ValueHash)
+	{
+		const uint64 NumBlocks = (uint64)(Blocks.Num() / BlockWords);
+		return Blocks.GetData() + (int32)(((ValueHash & 0xFFFFFFFFull) * NumBlocks) >> 32) * BlockWords;
+	}
+
+	FORCEINLINE const uint64* GetBlock(uint64 ValueHash) const
+	{
+		return const_cast<FContainerBloomFilter*>(this)->GetBlock(ValueHash);
+	}
+
+	TArray<uint64, TAlignedHeapAllocator<64>> Blocks;
+	int32 Capacity = 0;
+	int32 NumValues = 0;
+	int32 NumStale = 0;
+	bool bEnabled = false;
+	bool bDirty = true;
+	FContainerBloomFilterStats Stats;
+};
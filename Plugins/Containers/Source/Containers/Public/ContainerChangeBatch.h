@@ -0,0 +1,151 @@
+// Developer Bastian © 2024
+// License Creative Commons DEED 4.0 (https://creativecommons.org/licenses/by-sa/4.0/deed.en)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "Misc/Guid.h"
+#include "Misc/SpinLock.h"
+#include "Misc/ScopeLock.h"
+#include <atomic>
+
+#include "ContainerChangeBatch.generated.h"
+
+/**
+ * How a container reports its changes
+ */
+UENUM(BlueprintType)
+	enum class EContainerNotifyMode : uint8 {
+		E_Immediate		UMETA(DisplayName = "Immediate - one event per change"),
+		E_Batched		UMETA(DisplayName = "Batched - one event per frame")
+	};
+
+/**
+ * All changes of one container since the last flush.
+ * Indices are the positions at the time of the change - later changes in the same batch may have shifted them.
+ * Every container fills only the fields that fit it: keys, positions or numbers.
+ */
+USTRUCT(BlueprintType)
+struct FContainerChangeBatch
+{
+public:
+	GENERATED_USTRUCT_BODY()
+
+	// number of added elements, also counts changes that have no key or index
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Container Change Batch")
+	int32 NumAdded;
+
+	// number of removed elements, also counts changes that have no key or index (e.g. Empty)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Container Change Batch")
+	int32 NumRemoved;
+
+	// keys of added elements - map and multi map
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Container Change Batch")
+	TArray<FGuid> AddedKeys;
+
+	// keys of removed elements - map and multi map
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Container Change Batch")
+	TArray<FGuid> RemovedKeys;
+
+	// positions of added elements - array
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Container Change Batch")
+	TArray<int32> AddedIndices;
+
+	// positions of removed elements - array
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Container Change Batch")
+	TArray<int32> RemovedIndices;
+
+	// Number of added values - sets, which have neither keys nor positions
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Container Change Batch")
+	TArray<int32> AddedNumbers;
+
+	// Number of removed values - sets, which have neither keys nor positions
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Container Change Batch")
+	TArray<int32> RemovedNumbers;
+
+	FContainerChangeBatch() : NumAdded(0), NumRemoved(0)
+	{
+	}
+
+	FORCEINLINE bool IsEmpty() const
+	{
+		return NumAdded == 0 && NumRemoved == 0;
+	}
+
+	// Adds all changes of Other behind the ones of this batch
+	void Append(FContainerChangeBatch&& Other)
+	{
+		NumAdded += Other.NumAdded;
+		NumRemoved += Other.NumRemoved;
+		AddedKeys.Append(MoveTemp(Other.AddedKeys));
+		RemovedKeys.Append(MoveTemp(Other.RemovedKeys));
+		AddedIndices.Append(MoveTemp(Other.AddedIndices));
+		RemovedIndices.Append(MoveTemp(Other.RemovedIndices));
+		AddedNumbers.Append(MoveTemp(Other.AddedNumbers));
+		RemovedNumbers.Append(MoveTemp(Other.RemovedNumbers));
+	}
+};
+
+/**
+ * Delegate for one flushed batch of changes
+ */
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnContainerChangesFlushed, const FContainerChangeBatch&, Changes);
+
+/**
+ * Collects the changes of one container while it is in batched mode and flushes them once per frame.
+ *
+ * Record may be called from any thread. The first change after a flush registers a one-shot ticker
+ * on the core ticker, which runs on the game thread at the start of the next frame and calls the
+ * flush function of the container - so an idle container costs nothing per frame.
+ * The mode is set on the game thread and read by producers, the ticker handle is only touched under Mutex.
+ */
+class CONTAINERS_API FContainerChangeBatcher
+{
+public:
+	~FContainerChangeBatcher();
+
+	FORCEINLINE bool IsBatched() const
+	{
+		return this->Mode.load(std::memory_order_acquire) == EContainerNotifyMode::E_Batched;
+	}
+
+	FORCEINLINE EContainerNotifyMode GetMode() const
+	{
+		return this->Mode.load(std::memory_order_acquire);
+	}
+
+	/**
+	 * Switches the mode. Flush is called by the ticker for batched changes, the owner keeps the ticker
+	 * from calling it after the owner is gone. Switching to immediate drops the scheduled flush and
+	 * calls Flush right away for the changes recorded so far.
+	 */
+	void SetMode(EContainerNotifyMode InMode, UObject* Owner, TFunction<void()> Flush);
+
+	// Adds to the pending batch with Recorder(FContainerChangeBatch&) and schedules a flush for the next frame
+	template <typename RecorderType>
+	void Record(RecorderType&& Recorder)
+	{
+		{
+			UE::TScopeLock<UE::FSpinLock> Lock(this->Mutex);
+			Recorder(this->Pending);
+		}
+		ScheduleFlush();
+	}
+
+	// Moves the pending changes to OutBatch, returns false if there were none
+	bool TakePending(FContainerChangeBatch& OutBatch);
+
+private:
+	void ScheduleFlush();
+	void RemoveTicker();
+
+	std::atomic<EContainerNotifyMode> Mode{ EContainerNotifyMode::E_Immediate };
+	FContainerChangeBatch Pending;
+	// guards Pending and TickerHandle
+	UE::FSpinLock Mutex;
+	std::atomic<bool> bFlushScheduled{ false };
+	FTSTicker::FDelegateHandle TickerHandle;
+	TWeakObjectPtr<UObject> Owner;
+	TFunction<void()> FlushFunction;
+};
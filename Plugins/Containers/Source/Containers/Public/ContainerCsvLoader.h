@@ -0,0 +1,284 @@
+// Developer Bastian © 2024
+// License Creative Commons DEED 4.0 (https://creativecommons.org/licenses/by-sa/4.0/deed.en)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintFunctionLibrary.h"
+#include "Runtime/Core/Public/Async/ParallelFor.h"
+#include "ContainerMappedFile.h"
+#include "ContainerProfiler.h"
+#include "TArray.h"
+#include "TMap.h"
+#include "TSet.h"
+#include "Timer.h"
+#include <cstring>
+
+#include "ContainerCsvLoader.generated.h"
+
+/**
+ * Result of one native CSV load
+ */
+USTRUCT(BlueprintType)
+struct FContainerCsvLoadReport
+{
+public:
+	GENERATED_USTRUCT_BODY()
+
+	// rows that were added to the container
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "CSV Load Report")
+	int32 Rows;
+
+	// non-empty lines that did not have the Key,Name,Number layout
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "CSV Load Report")
+	int32 SkippedLines;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "CSV Load Report")
+	int64 Bytes;
+
+	// number of chunks that were parsed in parallel
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "CSV Load Report")
+	int32 Chunks;
+
+	// true if the file was memory-mapped, false if it had to be read into memory
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "CSV Load Report")
+	bool MemoryMapped;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "CSV Load Report")
+	double ParseMilliseconds;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "CSV Load Report")
+	double InsertMilliseconds;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "CSV Load Report")
+	double TotalMilliseconds;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "CSV Load Report")
+	double RowsPerSecond;
+
+	FContainerCsvLoadReport() : Rows(0), SkippedLines(0), Bytes(0), Chunks(0), MemoryMapped(false)
+		, ParseMilliseconds(0.0), InsertMilliseconds(0.0), TotalMilliseconds(0.0), RowsPerSecond(0.0)
+	{
+	}
+};
+
+/**
+ * Plain row of a WorldCities.csv shaped file, for native code that does not need a container struct
+ */
+struct FContainerCsvRow
+{
+	FString Name;
+	int32 Number = 0;
+};
+
+/**
+ * Columns of one CSV line, pointing into the file data
+ */
+struct FContainerCsvFields
+{
+	const ANSICHAR* RowName = nullptr;
+	int32 RowNameLength = 0;
+	const ANSICHAR* Name = nullptr;
+	int32 NameLength = 0;
+	int32 Number = 0;
+};
+
+/**
+ * Byte range of the file that starts and ends on a line boundary
+ */
+struct FContainerCsvChunk
+{
+	int64 Begin = 0;
+	int64 End = 0;
+};
+
+/**
+ * Native loader for WorldCities.csv shaped files (DataTable layout "---,Name,Number", UTF-8).
+ * The file is memory-mapped, cut into line-aligned chunks and every chunk is parsed on its own worker
+ * into a pre-sized array. The chunks are then moved into one array of exactly the right size,
+ * which the containers adopt without a per-row Blueprint call or delegate broadcast.
+ */
+class CONTAINERS_API FContainerCsvLoader
+{
+public:
+	/**
+	 * Parses all rows of Path into OutRows.
+	 * StructType needs a FString Name and an int32 Number - FTArrayTestStruct, FMapTestStruct, FTSetTestStruct and FContainerCsvRow do.
+	 * FMapTestStruct additionally gets a Guid derived from the row name, so the same file always yields the same keys.
+	 */
+	template <typename StructType>
+	static bool Load(const FString& Path, TArray<StructType>& OutRows, FContainerCsvLoadReport& OutReport)
+	{
+		BA_CONTAINER_SCOPE("FContainerCsvLoader::Load");
+		Timer Total;
+		Total.Start();
+		OutReport = FContainerCsvLoadReport();
+
+		FContainerMappedFile File;
+		if (!File.Open(Path))
+		{
+			UE_LOG(LogTemp, Error, TEXT("ContainerCsvLoader: '%s' could not be opened"), *Path);
+			return false;
+		}
+		OutReport.Bytes = File.GetSize();
+		OutReport.MemoryMapped = File.IsMapped();
+
+		TArray<FContainerCsvChunk> Chunks;
+		SplitIntoChunks(File.GetData(), File.GetSize(), GetChunkCount(File.GetSize()), Chunks);
+		OutReport.Chunks = Chunks.Num();
+
+		// every worker parses into its own array, nothing is shared while parsing
+		TArray<TArray<StructType>> Parsed;
+		Parsed.SetNum(Chunks.Num());
+		TArray<int32> Skipped;
+		Skipped.SetNumZeroed(Chunks.Num());
+		const ANSICHAR* Data = (const ANSICHAR*)File.GetData();
+		ParallelFor(Chunks.Num(), [&](int32 ChunkIndex)
+		{
+			const FContainerCsvChunk& Chunk = Chunks[ChunkIndex];
+			TArray<StructType>& Rows = Parsed[ChunkIndex];
+			const ANSICHAR* LineBegin = Data + Chunk.Begin;
+			const ANSICHAR* ChunkEnd = Data + Chunk.End;
+			Rows.Reserve(CountLines(LineBegin, ChunkEnd));
+			while (LineBegin < ChunkEnd)
+			{
+				const ANSICHAR* LineEnd = FindLineEnd(LineBegin, ChunkEnd);
+				FContainerCsvFields Fields;
+				if (ParseLine(LineBegin, LineEnd, Fields))
+				{
+					StructType& Row = Rows.AddDefaulted_GetRef();
+					Row.Name = ToString(Fields.Name, Fields.NameLength);
+					Row.Number = Fields.Number;
+					ApplyRowKey(Row, Fields);
+				}
+				else if (!IsBlank(LineBegin, LineEnd))
+				{
+					++Skipped[ChunkIndex];
+				}
+				LineBegin = LineEnd + 1;
+			}
+		});
+		OutReport.ParseMilliseconds = Total.StopNanoseconds() / 1000000.0;
+
+		// concatenate: reserve exactly once, then every chunk moves its rows to its own offset
+		TArray<int32> Offsets;
+		Offsets.SetNum(Parsed.Num());
+		int32 TotalRows = 0;
+		for (int32 i = 0; i < Parsed.Num(); ++i)
+		{
+			Offsets[i] = TotalRows;
+			TotalRows += Parsed[i].Num();
+			OutReport.SkippedLines += Skipped[i];
+		}
+		if (Parsed.Num() == 1)
+		{
+			OutRows = MoveTemp(Parsed[0]);
+		}
+		else
+		{
+			OutRows.Reset();
+			OutRows.SetNum(TotalRows);
+			ParallelFor(Parsed.Num(), [&](int32 ChunkIndex)
+			{
+				TArray<StructType>& Rows = Parsed[ChunkIndex];
+				StructType* Target = OutRows.GetData() + Offsets[ChunkIndex];
+				for (int32 i = 0; i < Rows.Num(); ++i)
+				{
+					Target[i] = MoveTemp(Rows[i]);
+				}
+			});
+		}
+		OutReport.Rows = TotalRows;
+		FinishReport(OutReport, Total.StopNanoseconds());
+		return true;
+	}
+
+	/**
+	 * Cuts Data, without its header line, into about NumChunks ranges that start and end on line boundaries
+	 */
+	static void SplitIntoChunks(const uint8* Data, int64 Size, int32 NumChunks, TArray<FContainerCsvChunk>& OutChunks);
+
+	// About four chunks per worker thread, but at least 64 KB per chunk
+	static int32 GetChunkCount(int64 Size);
+
+	// Splits one line (without '\n') into its columns, returns false if it does not have three columns
+	static bool ParseLine(const ANSICHAR* Begin, const ANSICHAR* End, FContainerCsvFields& OutFields);
+
+	// Converts a UTF-8 column into a FString
+	static FString ToString(const ANSICHAR* Text, int32 Length);
+
+	// End of the line starting at Begin, i.e. the position of its '\n' or End
+	static FORCEINLINE const ANSICHAR* FindLineEnd(const ANSICHAR* Begin, const ANSICHAR* End)
+	{
+		const void* Found = memchr(Begin, '\n', End - Begin);
+		return Found ? (const ANSICHAR*)Found : End;
+	}
+
+	static FORCEINLINE int32 CountLines(const ANSICHAR* Begin, const ANSICHAR* End)
+	{
+		int32 Lines = 0;
+		for (const ANSICHAR* Line = Begin; Line < End; Line = FindLineEnd(Line, End) + 1)
+		{
+			++Lines;
+		}
+		return Lines;
+	}
+
+	// Resolves an empty path to the plugin's WorldCities.csv and relative paths against the project directory
+	static FString ResolvePath(const FString& FilePath);
+
+	// Loads one of the Key,Name,Number files into each container type, replacing nothing - rows are appended
+	static bool LoadIntoArray(UTArray* Array, const FString& FilePath, FContainerCsvLoadReport& OutReport);
+	static bool LoadIntoMap(UTMap* Map, const FString& FilePath, FContainerCsvLoadReport& OutReport);
+	static bool LoadIntoSet(UTSet* Set, const FString& FilePath, FContainerCsvLoadReport& OutReport);
+
+private:
+	template <typename StructType>
+	static FORCEINLINE void ApplyRowKey(StructType& Row, const FContainerCsvFields& Fields)
+	{
+	}
+
+	static void ApplyRowKey(FMapTestStruct& Row, const FContainerCsvFields& Fields);
+
+	static FORCEINLINE bool IsBlank(const ANSICHAR* Begin, const ANSICHAR* End)
+	{
+		return End == Begin || (End == Begin + 1 && *Begin == '\r');
+	}
+
+	// Sets total time and rows per second, TotalNanoseconds covers everything since the file was opened
+	static void FinishReport(FContainerCsvLoadReport& Report, uint64 TotalNanoseconds);
+};
+
+/**
+ * Blueprint access to the native CSV loader
+ */
+UCLASS()
+class CONTAINERS_API UContainerCsvLoaderLibrary : public UBlueprintFunctionLibrary
+{
+	GENERATED_BODY()
+
+public:
+	UFUNCTION(BlueprintCallable, Category = "BA Container - CSV"
+		, meta = (CompactNodeTitle = "Load CSV into Array"
+			, ToolTip = "Appends all rows of a Key,Name,Number CSV to the array in one step. Empty path loads the plugin's WorldCities.csv"))
+	static bool CSV_LoadIntoArray(UTArray* Array, const FString& FilePath, FContainerCsvLoadReport& Report)
+	{
+		return FContainerCsvLoader::LoadIntoArray(Array, FilePath, Report);
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - CSV"
+		, meta = (CompactNodeTitle = "Load CSV into Map"
+			, ToolTip = "Adds all rows of a Key,Name,Number CSV to the map in one step, keyed by a Guid derived from the row key. Empty path loads the plugin's WorldCities.csv"))
+	static bool CSV_LoadIntoMap(UTMap* Map, const FString& FilePath, FContainerCsvLoadReport& Report)
+	{
+		return FContainerCsvLoader::LoadIntoMap(Map, FilePath, Report);
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - CSV"
+		, meta = (CompactNodeTitle = "Load CSV into Set"
+			, ToolTip = "Adds all rows of a Key,Name,Number CSV to the set in one step. Empty path loads the plugin's WorldCities.csv"))
+	static bool CSV_LoadIntoSet(UTSet* Set, const FString& FilePath, FContainerCsvLoadReport& Report)
+	{
+		return FContainerCsvLoader::LoadIntoSet(Set, FilePath, Report);
+	}
+};
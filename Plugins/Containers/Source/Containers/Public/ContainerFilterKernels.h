@@ -0,0 +1,106 @@
+// Developer Bastian © 2024
+// License Creative Commons DEED 4.0 (https://creativecommons.org/licenses/by-sa/4.0/deed.en)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <type_traits>
+
+/**
+ * Comparison on an int32 field, evaluated by FContainerFilterKernels
+ */
+struct CONTAINERS_API FContainerFilterPredicate
+{
+	enum class EOp : uint8
+	{
+		Greater,
+		Less,
+		Between,
+		InSet
+	};
+
+	EOp Op = EOp::Greater;
+	// threshold of Greater and Less, lower bound of Between
+	int32 A = 0;
+	// upper bound of Between
+	int32 B = 0;
+	// values of InSet, sorted and unique
+	TArray<int32> Set;
+
+	// Value > Threshold
+	static FContainerFilterPredicate Greater(int32 Threshold);
+	// Value < Threshold
+	static FContainerFilterPredicate Less(int32 Threshold);
+	// Min <= Value <= Max
+	static FContainerFilterPredicate Between(int32 Min, int32 Max);
+	// Value is one of Values
+	static FContainerFilterPredicate InSet(TConstArrayView<int32> Values);
+
+	bool Matches(int32 Value) const;
+};
+
+/**
+ * Vectorized filter kernels for int32 fields.
+ *
+ * Values are tested 64 at a time and every block yields one 64 bit word of the selection bitmap.
+ * Builds with AVX2 enabled compare 8 values per instruction, other x86 builds use SSE2 with 4,
+ * all other platforms a scalar loop. Large inputs are split over the worker threads in whole words.
+ *
+ * Inputs are either a plain int32 column (Stride = sizeof(int32)) or the Number field inside an array
+ * of structs (Stride = sizeof(Struct)), in which case every block is gathered first.
+ */
+class CONTAINERS_API FContainerFilterKernels
+{
+public:
+	// "AVX2", "SSE2" or "Scalar"
+	static const TCHAR* GetInstructionSet();
+
+	// Bit i of the result is set if Values[i] matches, for up to 64 contiguous values
+	static uint64 MatchBlock(const int32* Values, int32 Count, const FContainerFilterPredicate& Predicate);
+
+	/**
+	 * Selection bitmap over Num values, Stride bytes apart - bit i of word i / 64 belongs to value i.
+	 * @returns number of matches
+	 */
+	static int32 Select(const int32* Values, int32 Num, int32 Stride, const FContainerFilterPredicate& Predicate, TArray<uint64>& OutBitmap);
+
+	// Same as Select, but returns the positions of the matches in ascending order
+	static void SelectIndices(const int32* Values, int32 Num, int32 Stride, const FContainerFilterPredicate& Predicate, TArray<int32>& OutIndices);
+
+	// Positions of all set bits in ascending order
+	static void BitmapToIndices(const TArray<uint64>& Bitmap, TArray<int32>& OutIndices);
+
+	// Number of matches without building a bitmap
+	static int32 CountMatches(const int32* Values, int32 Num, int32 Stride, const FContainerFilterPredicate& Predicate);
+
+	/**
+	 * Filters containers without contiguous storage, e.g. TSet or TMap.
+	 * The numbers are collected 64 elements at a time and matched with MatchBlock,
+	 * then OnMatch(Element) is called for every match in iteration order.
+	 */
+	template <typename RangeType, typename GetterType, typename VisitorType>
+	static void ForEachMatch(RangeType& Range, const FContainerFilterPredicate& Predicate, GetterType&& GetNumber, VisitorType&& OnMatch)
+	{
+		using ElementType = std::remove_reference_t<decltype(*Range.begin())>;
+		int32 Numbers[64];
+		ElementType* Elements[64];
+		int32 NumPending = 0;
+		auto Flush = [&]()
+		{
+			for (uint64 Bits = MatchBlock(Numbers, NumPending, Predicate); Bits != 0; Bits &= Bits - 1)
+			{
+				OnMatch(*Elements[FMath::CountTrailingZeros64(Bits)]);
+			}
+			NumPending = 0;
+		};
+		for (ElementType& Element : Range)
+		{
+			Numbers[NumPending] = GetNumber(Element);
+			Elements[NumPending] = &Element;
+			if (++NumPending == 64)
+				Flush();
+		}
+		if (NumPending > 0)
+			Flush();
+	}
+};
@@ -0,0 +1,206 @@
+// Developer Bastian © 2024
+// License Creative Commons DEED 4.0 (https://creativecommons.org/licenses/by-sa/4.0/deed.en)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintFunctionLibrary.h"
+#include "Async/ParallelFor.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Misc/Guid.h"
+#include "ContainerProfiler.h"
+#include "TArray.h"
+#include "TMultiMap.h"
+#include "TBucketedMultiMap.h"
+
+#include "ContainerGroupBy.generated.h"
+
+/**
+ * Field the Blueprint group-by functions take the key from
+ */
+UENUM(BlueprintType)
+	enum class EContainerGroupKey : uint8 {
+		E_Name			UMETA(DisplayName = "Name"),
+		E_Number		UMETA(DisplayName = "Number")
+	};
+
+/**
+ * Parallel group-by from arrays into the multi maps.
+ *
+ * 1. Every worker takes a chunk of the values, runs the key selector and counts how many keys of
+ *    its chunk fall into each partition (key hash modulo the number of partitions).
+ * 2. A prefix sum over those counts gives every chunk its write offsets, the value indices are
+ *    scattered so that each partition is one contiguous, order preserving range.
+ * 3. Every worker groups one partition. Partitions never share a key, so no locks are needed.
+ * 4. The groups are merged into the multi map on the calling thread in one step with one notification.
+ */
+struct FContainerGroupBy
+{
+	using FGroup = TPair<FGuid, TArray<FTMultiMapTestStruct>>;
+
+	// below this many values everything runs on the calling thread
+	static constexpr int32 ParallelThreshold = 16384;
+
+	/**
+	 * Groups Values by the FGuid KeySelector(const SourceType&) returns. Values is consumed.
+	 * OutGroups holds every key once, the values of a key keep their order in Values.
+	 */
+	template <typename SourceType, typename KeySelectorType>
+	static void Group(TArray<SourceType>&& Values, KeySelectorType&& KeySelector, TArray<FGroup>& OutGroups)
+	{
+		BA_CONTAINER_SCOPE("FContainerGroupBy::Group");
+		OutGroups.Reset();
+		const int32 Num = Values.Num();
+		if (Num == 0)
+			return;
+		const int32 NumChunks = GetChunkCount(Num);
+		const int32 ChunkSize = FMath::DivideAndRoundUp(Num, NumChunks);
+		const int32 NumPartitions = NumChunks;
+		const EParallelForFlags Flags = NumChunks > 1 ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread;
+
+		TArray<FGuid> Keys;
+		Keys.SetNumUninitialized(Num);
+		// counts per chunk and partition, turned into the write offsets of that chunk
+		TArray<int32> Offsets;
+		Offsets.SetNumZeroed(NumChunks * NumPartitions);
+		ParallelFor(NumChunks, [&](int32 Chunk)
+		{
+			int32* Counts = Offsets.GetData() + Chunk * NumPartitions;
+			const int32 End = FMath::Min((Chunk + 1) * ChunkSize, Num);
+			for (int32 i = Chunk * ChunkSize; i < End; ++i)
+			{
+				Keys[i] = KeySelector(Values[i]);
+				++Counts[GetTypeHash(Keys[i]) % NumPartitions];
+			}
+		}, Flags);
+
+		// partition-major, chunk-minor keeps the values of a key in their original order
+		TArray<int32> PartitionStarts;
+		PartitionStarts.SetNumUninitialized(NumPartitions + 1);
+		int32 Offset = 0;
+		for (int32 Partition = 0; Partition < NumPartitions; ++Partition)
+		{
+			PartitionStarts[Partition] = Offset;
+			for (int32 Chunk = 0; Chunk < NumChunks; ++Chunk)
+			{
+				int32& Slot = Offsets[Chunk * NumPartitions + Partition];
+				const int32 Count = Slot;
+				Slot = Offset;
+				Offset += Count;
+			}
+		}
+		PartitionStarts[NumPartitions] = Num;
+
+		TArray<int32> Order;
+		Order.SetNumUninitialized(Num);
+		ParallelFor(NumChunks, [&](int32 Chunk)
+		{
+			int32* Positions = Offsets.GetData() + Chunk * NumPartitions;
+			const int32 End = FMath::Min((Chunk + 1) * ChunkSize, Num);
+			for (int32 i = Chunk * ChunkSize; i < End; ++i)
+				Order[Positions[GetTypeHash(Keys[i]) % NumPartitions]++] = i;
+		}, Flags);
+
+		TArray<TArray<FGroup>> PartitionGroups;
+		PartitionGroups.SetNum(NumPartitions);
+		ParallelFor(NumPartitions, [&](int32 Partition)
+		{
+			TArray<FGroup>& Groups = PartitionGroups[Partition];
+			TMap<FGuid, int32> GroupIndices;
+			for (int32 Position = PartitionStarts[Partition]; Position < PartitionStarts[Partition + 1]; ++Position)
+			{
+				const int32 i = Order[Position];
+				int32* GroupIndex = GroupIndices.Find(Keys[i]);
+				if (GroupIndex == nullptr)
+					GroupIndex = &GroupIndices.Add(Keys[i], Groups.Emplace(Keys[i], TArray<FTMultiMapTestStruct>()));
+				Groups[*GroupIndex].Value.Add(ToValue(MoveTemp(Values[i]), Keys[i]));
+			}
+		}, Flags);
+		Values.Reset();
+
+		int32 NumGroups = 0;
+		for (const TArray<FGroup>& Groups : PartitionGroups)
+			NumGroups += Groups.Num();
+		OutGroups.Reserve(NumGroups);
+		for (TArray<FGroup>& Groups : PartitionGroups)
+			OutGroups.Append(MoveTemp(Groups));
+	}
+
+	// Groups Values by KeySelector and adds the groups to MultiMap with one notification. Values is consumed.
+	template <typename MultiMapType, typename SourceType, typename KeySelectorType>
+	static int32 IntoMultiMap(MultiMapType& MultiMap, TArray<SourceType>&& Values, KeySelectorType&& KeySelector, bool bBroadcast)
+	{
+		BA_CONTAINER_SCOPE("FContainerGroupBy::IntoMultiMap");
+		TArray<FGroup> Groups;
+		Group(MoveTemp(Values), Forward<KeySelectorType>(KeySelector), Groups);
+		const int32 NumGroups = Groups.Num();
+		MultiMap.MM_AddGroupsMoved(MoveTemp(Groups), bBroadcast);
+		return NumGroups;
+	}
+
+	// Key the Blueprint functions use for a name or number - the same name or number always gives the same key
+	static FGuid MakeKey(const FString& Name, int32 Number, EContainerGroupKey GroupKey)
+	{
+		return GroupKey == EContainerGroupKey::E_Name ? FGuid::NewDeterministicGuid(Name) : FGuid(0, 0, 0, (uint32)Number);
+	}
+
+private:
+	// number of chunks and partitions for Num values - one per worker, but never smaller than ParallelThreshold
+	static int32 GetChunkCount(int32 Num)
+	{
+		const int32 Workers = FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+		return FMath::Clamp(Num / ParallelThreshold, 1, Workers);
+	}
+
+	// the multi map value of a source value, keyed by Key
+	static FTMultiMapTestStruct ToValue(FTMultiMapTestStruct&& Source, const FGuid& Key)
+	{
+		FTMultiMapTestStruct Value = MoveTemp(Source);
+		Value.Guid = Key;
+		return Value;
+	}
+
+	static FTMultiMapTestStruct ToValue(FTArrayTestStruct&& Source, const FGuid& Key)
+	{
+		FTMultiMapTestStruct Value;
+		Value.Guid = Key;
+		Value.Name = MoveTemp(Source.Name);
+		Value.Number = Source.Number;
+		return Value;
+	}
+};
+
+/**
+ * Blueprint access to the parallel group-by
+ */
+UCLASS()
+class CONTAINERS_API UContainerGroupByLibrary : public UBlueprintFunctionLibrary
+{
+	GENERATED_BODY()
+
+public:
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Group By"
+		, meta = (CompactNodeTitle = "Group Array into MultiMap"
+			, ToolTip = "Groups Values by their Name or Number on worker threads and adds them to MultiMap with one notification. Returns the number of keys"))
+	static int32 GroupBy_ArrayIntoMultiMap(UTMultiMap* MultiMap, const TArray<FTArrayTestStruct>& Values, EContainerGroupKey GroupKey, bool Broadcast);
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Group By"
+		, meta = (CompactNodeTitle = "Group Array into Bucketed MultiMap"
+			, ToolTip = "Groups Values by their Name or Number on worker threads and adds them to MultiMap with one notification. Returns the number of keys"))
+	static int32 GroupBy_ArrayIntoBucketedMultiMap(UTBucketedMultiMap* MultiMap, const TArray<FTArrayTestStruct>& Values, EContainerGroupKey GroupKey, bool Broadcast);
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Group By"
+		, meta = (CompactNodeTitle = "Regroup into MultiMap"
+			, ToolTip = "Groups Values by their Name or Number on worker threads and adds them to MultiMap with one notification. The Guid of every value is set to its new key. Returns the number of keys"))
+	static int32 GroupBy_ValuesIntoMultiMap(UTMultiMap* MultiMap, const TArray<FTMultiMapTestStruct>& Values, EContainerGroupKey GroupKey, bool Broadcast);
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Group By"
+		, meta = (CompactNodeTitle = "Regroup into Bucketed MultiMap"
+			, ToolTip = "Groups Values by their Name or Number on worker threads and adds them to MultiMap with one notification. The Guid of every value is set to its new key. Returns the number of keys"))
+	static int32 GroupBy_ValuesIntoBucketedMultiMap(UTBucketedMultiMap* MultiMap, const TArray<FTMultiMapTestStruct>& Values, EContainerGroupKey GroupKey, bool Broadcast);
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "BA Container - Group By"
+		, meta = (CompactNodeTitle = "Group Key"
+			, ToolTip = "Returns the key the group-by functions use for this Name or Number, to find a group in the multi map"))
+	static FGuid GroupBy_MakeKey(const FString& Name, int32 Number, EContainerGroupKey GroupKey);
+};
@@ -0,0 +1,55 @@
+// Developer Bastian © 2024
+// License Creative Commons DEED 4.0 (https://creativecommons.org/licenses/by-sa/4.0/deed.en)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/MappedFileHandle.h"
+
+/**
+ * Read-only view of a whole file.
+ * Memory-maps the file where the platform supports it and reads it into memory otherwise,
+ * so callers always get one contiguous block of bytes.
+ */
+class CONTAINERS_API FContainerMappedFile
+{
+public:
+	FContainerMappedFile()
+	{}
+
+	~FContainerMappedFile()
+	{
+		Close();
+	}
+
+	FContainerMappedFile(const FContainerMappedFile&) = delete;
+	FContainerMappedFile& operator=(const FContainerMappedFile&) = delete;
+
+	// Opens Path, returns false if it does not exist or can not be read
+	bool Open(const FString& Path);
+
+	void Close();
+
+	FORCEINLINE const uint8* GetData() const
+	{
+		return Data;
+	}
+
+	FORCEINLINE int64 GetSize() const
+	{
+		return Size;
+	}
+
+	// true if the data is memory-mapped, false if it was read into memory
+	FORCEINLINE bool IsMapped() const
+	{
+		return Region.IsValid();
+	}
+
+private:
+	TUniquePtr<IMappedFileHandle> Handle;
+	TUniquePtr<IMappedFileRegion> Region;
+	TArray64<uint8> Buffer;
+	const uint8* Data = nullptr;
+	int64 Size = 0;
+};
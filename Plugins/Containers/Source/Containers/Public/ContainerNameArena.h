@@ -0,0 +1,199 @@
+// Developer Bastian © 2024
+// License Creative Commons DEED 4.0 (https://creativecommons.org/licenses/by-sa/4.0/deed.en)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/StringView.h"
+#include "Hash/CityHash.h"
+#include "Templates/UniquePtr.h"
+
+/**
+ * Interned, immutable string storage of one container.
+ *
+ * Every distinct name is copied once into large character pages and identified by a handle, the
+ * index of its entry. Equal names - compared case sensitive - always get the same handle, so rows
+ * compare names by comparing two int32. Names are never freed one by one: a name stays in the
+ * arena after the last row using it is removed, Empty frees all pages at once.
+ */
+class FContainerNameArena
+{
+public:
+	using FHandle = int32;
+
+	// characters per page, longer names get a page of their own
+	static constexpr int32 PageChars = 32768;
+
+	FContainerNameArena() = default;
+	FContainerNameArena(FContainerNameArena&&) = default;
+	FContainerNameArena& operator=(FContainerNameArena&&) = default;
+
+	// Handle of Name, copies it into the arena if it is new
+	FHandle Intern(FStringView Name)
+	{
+		const uint32 NameHash = HashOf(Name);
+		const FHandle Found = Find(Name, NameHash);
+		if (Found != INDEX_NONE)
+			return Found;
+		if ((this->Entries.Num() + 1) * 4 > this->Slots.Num() * 3)
+			Grow();
+
+		const int32 Len = Name.Len();
+		TCHAR* Chars = Allocate(Len + 1);
+		FMemory::Memcpy(Chars, Name.GetData(), Len * sizeof(TCHAR));
+		Chars[Len] = TEXT('\0');
+		const FHandle Handle = this->Entries.Add({ Chars, Len, NameHash });
+		this->Slots[FindSlot(Name, NameHash)] = Handle;
+		return Handle;
+	}
+
+	// Handle of Name, INDEX_NONE if it was never interned
+	FORCEINLINE FHandle Find(FStringView Name) const
+	{
+		return Find(Name, HashOf(Name));
+	}
+
+	FORCEINLINE FStringView Get(FHandle Handle) const
+	{
+		const FEntry& Entry = this->Entries[Handle];
+		return FStringView(Entry.Chars, Entry.Len);
+	}
+
+	// Null terminated characters of Handle, valid until Empty
+	FORCEINLINE const TCHAR* GetChars(FHandle Handle) const
+	{
+		return this->Entries[Handle].Chars;
+	}
+
+	FORCEINLINE FString ToString(FHandle Handle) const
+	{
+		const FEntry& Entry = this->Entries[Handle];
+		return FString(Entry.Len, Entry.Chars);
+	}
+
+	// Number of distinct names, handles are 0 .. Num() - 1
+	FORCEINLINE int32 Num() const
+	{
+		return this->Entries.Num();
+	}
+
+	// Makes room for NumNames new names of NumChars characters in total, terminators included, in one page
+	void Reserve(int32 NumNames, int32 NumChars)
+	{
+		this->Entries.Reserve(this->Entries.Num() + NumNames);
+		while ((this->Entries.Num() + NumNames) * 4 > this->Slots.Num() * 3)
+			Grow();
+		if (this->PageUsed + NumChars > GetPageSize())
+			AddPage(FMath::Max(NumChars, PageChars));
+	}
+
+	// Frees all names at once, every handle becomes invalid
+	void Empty()
+	{
+		this->Pages.Empty();
+		this->Entries.Empty();
+		this->Slots.Empty();
+		this->PageUsed = 0;
+	}
+
+	SIZE_T GetAllocatedSize() const
+	{
+		SIZE_T Size = this->Entries.GetAllocatedSize() + this->Slots.GetAllocatedSize() + this->Pages.GetAllocatedSize();
+		for (const FPage& Page : this->Pages)
+			Size += Page.Size * sizeof(TCHAR);
+		return Size;
+	}
+
+private:
+	struct FEntry
+	{
+		const TCHAR* Chars;
+		int32 Len;
+		uint32 Hash;
+	};
+
+	struct FPage
+	{
+		TUniquePtr<TCHAR[]> Chars;
+		int32 Size;
+	};
+
+	static FORCEINLINE uint32 HashOf(FStringView Name)
+	{
+		return (uint32)CityHash64((const char*)Name.GetData(), (uint32)(Name.Len() * sizeof(TCHAR)));
+	}
+
+	FHandle Find(FStringView Name, uint32 NameHash) const
+	{
+		if (this->Slots.Num() == 0)
+			return INDEX_NONE;
+		return this->Slots[FindSlot(Name, NameHash)];
+	}
+
+	// Slot holding Name, or the empty slot it belongs into - linear probing, Slots.Num() is a power of two
+	int32 FindSlot(FStringView Name, uint32 NameHash) const
+	{
+		const int32 Mask = this->Slots.Num() - 1;
+		for (int32 Slot = NameHash & Mask; ; Slot = (Slot + 1) & Mask)
+		{
+			const FHandle Handle = this->Slots[Slot];
+			if (Handle == INDEX_NONE)
+				return Slot;
+			const FEntry& Entry = this->Entries[Handle];
+			if (Entry.Hash == NameHash && Entry.Len == Name.Len()
+				&& FMemory::Memcmp(Entry.Chars, Name.GetData(), Entry.Len * sizeof(TCHAR)) == 0)
+				return Slot;
+		}
+	}
+
+	void Grow()
+	{
+		const int32 NumSlots = FMath::Max(this->Slots.Num() * 2, 1024);
+		this->Slots.Init(INDEX_NONE, NumSlots);
+		const int32 Mask = NumSlots - 1;
+		for (FHandle Handle = 0; Handle < this->Entries.Num(); ++Handle)
+		{
+			int32 Slot = this->Entries[Handle].Hash & Mask;
+			while (this->Slots[Slot] != INDEX_NONE)
+				Slot = (Slot + 1) & Mask;
+			this->Slots[Slot] = Handle;
+		}
+	}
+
+	// size of the page names are currently written to, the last one
+	FORCEINLINE int32 GetPageSize() const
+	{
+		return this->Pages.Num() > 0 ? this->Pages.Last().Size : 0;
+	}
+
+	void AddPage(int32 Size)
+	{
+		this->Pages.Add({ MakeUnique<TCHAR[]>(Size), Size });
+		this->PageUsed = 0;
+	}
+
+	// Count characters that stay at the same address for the lifetime of the arena
+	TCHAR* Allocate(int32 Count)
+	{
+		if (this->PageUsed + Count > GetPageSize())
+		{
+			if (Count > PageChars && this->Pages.Num() > 0)
+			{
+				// a name that does not fit into a page gets its own, the current page stays open
+				FPage& Page = this->Pages.Insert_GetRef({ MakeUnique<TCHAR[]>(Count), Count }, this->Pages.Num() - 1);
+				return Page.Chars.Get();
+			}
+			AddPage(FMath::Max(Count, PageChars));
+		}
+		TCHAR* Chars = this->Pages.Last().Chars.Get() + this->PageUsed;
+		this->PageUsed += Count;
+		return Chars;
+	}
+
+	TArray<FPage> Pages;
+	// characters used of the last page
+	int32 PageUsed = 0;
+	TArray<FEntry> Entries;
+	// open addressing table of handles, INDEX_NONE marks an empty slot
+	TArray<FHandle> Slots;
+};
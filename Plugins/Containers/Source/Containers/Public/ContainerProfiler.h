@@ -0,0 +1,250 @@
+// Developer Bastian © 2024
+// License Creative Commons DEED 4.0 (https://creativecommons.org/licenses/by-sa/4.0/deed.en)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintFunctionLibrary.h"
+#include "Misc/SpinLock.h"
+#include "Timer.h"
+#include <atomic>
+
+#include "ContainerProfiler.generated.h"
+
+/**
+ * Accumulated timings of one profiled operation.
+ * All times are in microseconds, percentiles are read from a log-linear histogram (max. 12.5% bucket error).
+ */
+USTRUCT(BlueprintType)
+struct FContainerProfilerStats
+{
+public:
+	GENERATED_USTRUCT_BODY()
+
+	// Path of the operation, nested operations are separated by '/' e.g. "UTArray::Array_Sort/ContainerSort::RadixSort"
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Container Profiler")
+	FString Operation;
+
+	// 0 for top-level operations, 1 for operations called from within another operation, ...
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Container Profiler")
+	int32 Depth;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Container Profiler")
+	int64 Count;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Container Profiler")
+	double TotalMicroseconds;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Container Profiler")
+	double MinMicroseconds;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Container Profiler")
+	double MaxMicroseconds;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Container Profiler")
+	double AverageMicroseconds;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Container Profiler")
+	double P50Microseconds;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Container Profiler")
+	double P95Microseconds;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Container Profiler")
+	double P99Microseconds;
+
+	FContainerProfilerStats() : Operation(""), Depth(0), Count(0), TotalMicroseconds(0.0), MinMicroseconds(0.0)
+		, MaxMicroseconds(0.0), AverageMicroseconds(0.0), P50Microseconds(0.0), P95Microseconds(0.0), P99Microseconds(0.0)
+	{
+	}
+};
+
+/**
+ * Process wide profiler for container operations.
+ * Every call site registers its operation once (see BA_CONTAINER_SCOPE) and feeds nanosecond timings into
+ * a per-node accumulator. Operations that run inside another profiled operation get their own child node,
+ * so the same function shows up separately under every caller.
+ *
+ * Recording is disabled by default, a disabled scope costs one relaxed atomic load.
+ */
+class CONTAINERS_API FContainerProfiler
+{
+public:
+	static constexpr int32 MaxNodes = 4096;
+	static constexpr int32 NumBuckets = 512;
+
+	static FContainerProfiler& Get();
+
+	FORCEINLINE bool IsEnabled() const
+	{
+		return bEnabled.load(std::memory_order_relaxed);
+	}
+
+	void SetEnabled(bool bInEnabled)
+	{
+		bEnabled.store(bInEnabled, std::memory_order_relaxed);
+	}
+
+	/**
+	 * Returns the node of a top-level operation, creating it on first use.
+	 * Cheap enough to call once per call site, not meant to be called per measurement.
+	 */
+	int32 RegisterOperation(const TCHAR* Operation);
+
+	/**
+	 * Returns the node of Operation (a node returned by RegisterOperation) nested below ParentNode.
+	 * Lookups are cached per thread, the registry is only locked the first time a thread sees a pair.
+	 */
+	int32 FindOrAddChild(int32 ParentNode, int32 OperationNode);
+
+	// Adds one measurement to the accumulator of Node
+	void Record(int32 Node, uint64 Nanoseconds);
+
+	// Clears all accumulated values, registered operations stay valid
+	void Reset();
+
+	TArray<FContainerProfilerStats> GetAllStats() const;
+	bool GetStats(const FString& Operation, FContainerProfilerStats& OutStats) const;
+
+	FString ToCSV() const;
+	FString ToJSON() const;
+
+	// node the current thread is measuring right now, INDEX_NONE outside of any scope
+	static int32 GetCurrentNode();
+	static void SetCurrentNode(int32 Node);
+
+	// log-linear histogram: exact below 16ns, then 8 buckets per power of two
+	static int32 GetBucketIndex(uint64 Nanoseconds);
+	static uint64 GetBucketLowerBound(int32 Bucket);
+
+private:
+	FContainerProfiler();
+
+	struct FNode
+	{
+		FName Operation;
+		int32 Parent = INDEX_NONE;
+		int32 Depth = 0;
+		mutable UE::FSpinLock Lock;
+		uint64 Count = 0;
+		uint64 Total = 0;
+		uint64 Min = MAX_uint64;
+		uint64 Max = 0;
+		uint32 Buckets[NumBuckets] = {};
+	};
+
+	int32 AddNode(FName Operation, int32 Parent);
+	FString GetPath(int32 Node) const;
+	FContainerProfilerStats MakeStats(int32 Node) const;
+
+	// nodes are never removed or moved, so their index can be cached at the call site
+	TUniquePtr<FNode> Nodes[MaxNodes];
+	std::atomic<int32> NumNodes;
+	std::atomic<bool> bEnabled;
+
+	FCriticalSection RegistryLock;
+	TMap<FName, int32> RootNodes;
+	TMap<TPair<int32, int32>, int32> ChildNodes;
+};
+
+/**
+ * Measures the lifetime of the scope and reports it to FContainerProfiler.
+ * Use the BA_CONTAINER_SCOPE macro instead of creating it directly.
+ */
+class FContainerProfilerScope
+{
+public:
+	FORCEINLINE explicit FContainerProfilerScope(int32 OperationNode)
+	{
+		FContainerProfiler& Profiler = FContainerProfiler::Get();
+		if (!Profiler.IsEnabled() || OperationNode == INDEX_NONE)
+			return;
+		Parent = FContainerProfiler::GetCurrentNode();
+		Node = Parent == INDEX_NONE ? OperationNode : Profiler.FindOrAddChild(Parent, OperationNode);
+		if (Node == INDEX_NONE)
+			return;
+		FContainerProfiler::SetCurrentNode(Node);
+		StartNanoseconds = Timer::NowNanoseconds();
+	}
+
+	FORCEINLINE ~FContainerProfilerScope()
+	{
+		if (Node == INDEX_NONE)
+			return;
+		FContainerProfiler::Get().Record(Node, Timer::NowNanoseconds() - StartNanoseconds);
+		FContainerProfiler::SetCurrentNode(Parent);
+	}
+
+private:
+	int32 Node = INDEX_NONE;
+	int32 Parent = INDEX_NONE;
+	uint64 StartNanoseconds = 0;
+};
+
+/**
+ * Profiles the rest of the enclosing scope under the given operation name, e.g.
+ * BA_CONTAINER_SCOPE("UTArray::Array_Add");
+ */
+#define BA_CONTAINER_SCOPE(Operation) \
+	static const int32 PREPROCESSOR_JOIN(BAProfilerNode_, __LINE__) = FContainerProfiler::Get().RegisterOperation(TEXT(Operation)); \
+	FContainerProfilerScope PREPROCESSOR_JOIN(BAProfilerScope_, __LINE__)(PREPROCESSOR_JOIN(BAProfilerNode_, __LINE__))
+
+/**
+ * Blueprint access to the container profiler
+ */
+UCLASS()
+class CONTAINERS_API UContainerProfilerLibrary : public UBlueprintFunctionLibrary
+{
+	GENERATED_BODY()
+
+public:
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Profiler"
+		, meta = (CompactNodeTitle = "Enable Profiler"
+			, ToolTip = "Starts or stops recording of container operations"))
+	static void Profiler_SetEnabled(bool Enabled)
+	{
+		FContainerProfiler::Get().SetEnabled(Enabled);
+	}
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "BA Container - Profiler"
+		, meta = (CompactNodeTitle = "Profiler Enabled?"
+			, ToolTip = "Checks whether container operations are recorded"))
+	static bool Profiler_IsEnabled()
+	{
+		return FContainerProfiler::Get().IsEnabled();
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Profiler"
+		, meta = (CompactNodeTitle = "Reset Profiler"
+			, ToolTip = "Clears all recorded timings"))
+	static void Profiler_Reset()
+	{
+		FContainerProfiler::Get().Reset();
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Profiler"
+		, meta = (CompactNodeTitle = "Get Stats"
+			, ToolTip = "Gets the timings of one operation path, e.g. 'UTArray::Array_Sort'. Returns false if the operation was never recorded"))
+	static bool Profiler_GetStats(const FString& Operation, FContainerProfilerStats& Stats)
+	{
+		return FContainerProfiler::Get().GetStats(Operation, Stats);
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Profiler"
+		, meta = (CompactNodeTitle = "Get All Stats"
+			, ToolTip = "Gets the timings of all recorded operations"))
+	static TArray<FContainerProfilerStats> Profiler_GetAllStats()
+	{
+		return FContainerProfiler::Get().GetAllStats();
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Profiler"
+		, meta = (CompactNodeTitle = "Dump CSV"
+			, ToolTip = "Writes all timings as CSV. Relative paths are resolved against the project's Saved directory"))
+	static bool Profiler_DumpToCSV(const FString& FilePath);
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Profiler"
+		, meta = (CompactNodeTitle = "Dump JSON"
+			, ToolTip = "Writes all timings as JSON. Relative paths are resolved against the project's Saved directory"))
+	static bool Profiler_DumpToJSON(const FString& FilePath);
+};
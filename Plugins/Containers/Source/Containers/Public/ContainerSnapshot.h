@@ -0,0 +1,340 @@
+// Developer Bastian © 2024
+// License Creative Commons DEED 4.0 (https://creativecommons.org/licenses/by-sa/4.0/deed.en)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintFunctionLibrary.h"
+#include "Async/ParallelFor.h"
+#include "Misc/Guid.h"
+#include "ContainerMappedFile.h"
+#include "ContainerNameArena.h"
+#include "ContainerProfiler.h"
+#include "TArray.h"
+#include "TMap.h"
+#include "TSet.h"
+#include "TMultiMap.h"
+#include "TQueue.h"
+
+#include "ContainerSnapshot.generated.h"
+
+/**
+ * Container type a snapshot was written from, a snapshot only loads into the same type
+ */
+UENUM(BlueprintType)
+	enum class EContainerSnapshotKind : uint8 {
+		E_Array			UMETA(DisplayName = "Array"),
+		E_Map			UMETA(DisplayName = "Map"),
+		E_Set			UMETA(DisplayName = "Set"),
+		E_MultiMap		UMETA(DisplayName = "MultiMap"),
+		E_Queue			UMETA(DisplayName = "Queue")
+	};
+
+/**
+ * Result of one snapshot save or load
+ */
+USTRUCT(BlueprintType)
+struct FContainerSnapshotReport
+{
+public:
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Snapshot Report")
+	EContainerSnapshotKind Kind;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Snapshot Report")
+	int32 Rows;
+
+	// distinct names in the string table
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Snapshot Report")
+	int32 Strings;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Snapshot Report")
+	int64 Bytes;
+
+	// load only - true if the file was memory-mapped, false if it had to be read into memory
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Snapshot Report")
+	bool MemoryMapped;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Snapshot Report")
+	double ChecksumMilliseconds;
+
+	// load only - building the rows from the columns
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Snapshot Report")
+	double DecodeMilliseconds;
+
+	// load only - handing the rows to the container
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Snapshot Report")
+	double InsertMilliseconds;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Snapshot Report")
+	double TotalMilliseconds;
+
+	FContainerSnapshotReport() : Kind(EContainerSnapshotKind::E_Array), Rows(0), Strings(0), Bytes(0), MemoryMapped(false)
+		, ChecksumMilliseconds(0.0), DecodeMilliseconds(0.0), InsertMilliseconds(0.0), TotalMilliseconds(0.0)
+	{
+	}
+};
+
+#pragma region Format
+/**
+ * Byte range of one section of a snapshot file and the CRC32 of its bytes
+ */
+struct FContainerSnapshotSection
+{
+	int64 Offset = 0;
+	int64 Size = 0;
+	uint32 Crc = 0;
+	uint32 Reserved = 0;
+};
+
+/**
+ * First bytes of a snapshot file. All values are little endian, every section starts 16 byte aligned.
+ *
+ * Strings  uint32 offsets[NumStrings + 1] in characters, followed by the characters of all distinct names, CharSize bytes each
+ * Names    int32[NumRows], index into Strings
+ * Numbers  int32[NumRows]
+ * Guids    FGuid[NumRows], the value's Guid - map and multi map only
+ * Keys     FGuid[NumRows], the multi map key - rows of one key are stored next to each other
+ */
+struct FContainerSnapshotHeader
+{
+	enum ESection { Strings, Names, Numbers, Guids, Keys, NumSections };
+
+	uint32 Magic = 0;
+	uint16 Version = 0;
+	uint8 Kind = 0;
+	uint8 CharSize = 0;
+	int32 NumRows = 0;
+	int32 NumStrings = 0;
+	FContainerSnapshotSection Sections[NumSections];
+	// CRC32 of the header with HeaderCrc set to 0
+	uint32 HeaderCrc = 0;
+	uint32 Reserved = 0;
+};
+#pragma endregion Format
+
+/**
+ * Rows of one container split into the snapshot columns, the names interned so every distinct one is stored once
+ */
+struct FContainerSnapshotColumns
+{
+	FContainerNameArena Strings;
+	TArray<FContainerNameArena::FHandle> Names;
+	TArray<int32> Numbers;
+	TArray<FGuid> Guids;
+	TArray<FGuid> Keys;
+
+	void Reserve(int32 NumRows, bool bGuids, bool bKeys)
+	{
+		this->Names.Reserve(NumRows);
+		this->Numbers.Reserve(NumRows);
+		if (bGuids)
+			this->Guids.Reserve(NumRows);
+		if (bKeys)
+			this->Keys.Reserve(NumRows);
+	}
+
+	FORCEINLINE void Add(const FString& Name, int32 Number)
+	{
+		this->Names.Add(this->Strings.Intern(Name));
+		this->Numbers.Add(Number);
+	}
+};
+
+/**
+ * Validated snapshot file, its columns point into the memory-mapped data
+ */
+class CONTAINERS_API FContainerSnapshotReader
+{
+public:
+	// Maps Path and checks header, section bounds and checksums, logs and returns false on any mismatch
+	bool Open(const FString& Path, EContainerSnapshotKind Kind, FContainerSnapshotReport& OutReport);
+
+	FORCEINLINE int32 Num() const
+	{
+		return this->Numbers.Num();
+	}
+
+	/**
+	 * Builds one StructType per row in parallel - StructType needs a FString Name and an int32 Number,
+	 * the map and multi map structs get their Guid. Every distinct name is converted to a FString once.
+	 */
+	template <typename StructType>
+	void ToRows(TArray<StructType>& OutRows) const
+	{
+		BA_CONTAINER_SCOPE("FContainerSnapshotReader::ToRows");
+		const int32 NumRows = Num();
+		OutRows.SetNum(NumRows);
+		const int32 NumChunks = GetChunkCount();
+		const int32 ChunkSize = FMath::DivideAndRoundUp(NumRows, NumChunks);
+		ParallelFor(NumChunks, [this, &OutRows, NumRows, ChunkSize](int32 Chunk)
+		{
+			const int32 End = FMath::Min((Chunk + 1) * ChunkSize, NumRows);
+			for (int32 i = Chunk * ChunkSize; i < End; ++i)
+			{
+				StructType& Row = OutRows[i];
+				Row.Name = this->Strings[this->Names[i]];
+				Row.Number = this->Numbers[i];
+				ApplyGuid(Row, i);
+			}
+		}, NumChunks > 1 ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+	}
+
+	FORCEINLINE TConstArrayView<FGuid> GetKeys() const
+	{
+		return this->Keys;
+	}
+
+private:
+	// one chunk per 16k rows, at most one per worker
+	int32 GetChunkCount() const;
+
+	template <typename StructType>
+	FORCEINLINE void ApplyGuid(StructType& Row, int32 Index) const
+	{
+	}
+
+	FORCEINLINE void ApplyGuid(FMapTestStruct& Row, int32 Index) const
+	{
+		Row.Guid = this->Guids[Index];
+	}
+
+	FORCEINLINE void ApplyGuid(FTMultiMapTestStruct& Row, int32 Index) const
+	{
+		Row.Guid = this->Guids[Index];
+	}
+
+	FContainerMappedFile File;
+	TArray<FString> Strings;
+	TConstArrayView<int32> Names;
+	TConstArrayView<int32> Numbers;
+	TConstArrayView<FGuid> Guids;
+	TConstArrayView<FGuid> Keys;
+};
+
+/**
+ * Versioned binary snapshots of the container contents, so a server restart adopts its data instead of re-importing CSV.
+ * A snapshot holds a string table of the distinct names and one fixed-width column per field; the loader maps the file,
+ * verifies the CRC32 of the header and of every section, and builds the rows straight from the mapped columns.
+ * Files are written to Path.tmp first and then moved over Path, so a crash never leaves half a snapshot.
+ */
+class CONTAINERS_API FContainerSnapshot
+{
+public:
+	// "BACS" read as little endian uint32
+	static constexpr uint32 Magic = 0x53434142;
+	static constexpr uint16 Version = 1;
+
+	// Writes Columns as a snapshot of Kind to Path
+	static bool Write(const FString& Path, EContainerSnapshotKind Kind, const FContainerSnapshotColumns& Columns, FContainerSnapshotReport& OutReport);
+
+	// CRC32 of Size bytes - FCrc::MemCrc32 takes at most MAX_int32 bytes per call
+	static uint32 Checksum(const uint8* Data, int64 Size);
+
+	// Resolves relative paths against the project's Saved directory
+	static FString ResolvePath(const FString& FilePath);
+
+	// Save the whole container, or append the rows of a snapshot to it - nothing is replaced
+	static bool SaveArray(UTArray* Array, const FString& FilePath, FContainerSnapshotReport& OutReport);
+	static bool LoadIntoArray(UTArray* Array, const FString& FilePath, bool bBroadcast, FContainerSnapshotReport& OutReport);
+	static bool SaveMap(UTMap* Map, const FString& FilePath, FContainerSnapshotReport& OutReport);
+	static bool LoadIntoMap(UTMap* Map, const FString& FilePath, bool bBroadcast, FContainerSnapshotReport& OutReport);
+	static bool SaveSet(UTSet* Set, const FString& FilePath, FContainerSnapshotReport& OutReport);
+	static bool LoadIntoSet(UTSet* Set, const FString& FilePath, bool bBroadcast, FContainerSnapshotReport& OutReport);
+	static bool SaveMultiMap(UTMultiMap* MultiMap, const FString& FilePath, FContainerSnapshotReport& OutReport);
+	static bool LoadIntoMultiMap(UTMultiMap* MultiMap, const FString& FilePath, bool bBroadcast, FContainerSnapshotReport& OutReport);
+	// TQueue can not be read without dequeuing, so a queue is drained into its snapshot and left empty
+	static bool DrainQueue(UTQueue* Queue, const FString& FilePath, FContainerSnapshotReport& OutReport);
+	static bool LoadIntoQueue(UTQueue* Queue, const FString& FilePath, FContainerSnapshotReport& OutReport);
+};
+
+/**
+ * Blueprint access to the container snapshots
+ */
+UCLASS()
+class CONTAINERS_API UContainerSnapshotLibrary : public UBlueprintFunctionLibrary
+{
+	GENERATED_BODY()
+
+public:
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Snapshot"
+		, meta = (CompactNodeTitle = "Save Array Snapshot"
+			, ToolTip = "Writes all items of the array to a binary snapshot. Relative paths are resolved against the project's Saved directory"))
+	static bool Snapshot_SaveArray(UTArray* Array, const FString& FilePath, FContainerSnapshotReport& Report)
+	{
+		return FContainerSnapshot::SaveArray(Array, FilePath, Report);
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Snapshot"
+		, meta = (CompactNodeTitle = "Load Array Snapshot"
+			, ToolTip = "Appends all items of an array snapshot to the array in one step, after checking its checksums"))
+	static bool Snapshot_LoadIntoArray(UTArray* Array, const FString& FilePath, bool Broadcast, FContainerSnapshotReport& Report)
+	{
+		return FContainerSnapshot::LoadIntoArray(Array, FilePath, Broadcast, Report);
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Snapshot"
+		, meta = (CompactNodeTitle = "Save Map Snapshot"
+			, ToolTip = "Writes all values of the map to a binary snapshot. Relative paths are resolved against the project's Saved directory"))
+	static bool Snapshot_SaveMap(UTMap* Map, const FString& FilePath, FContainerSnapshotReport& Report)
+	{
+		return FContainerSnapshot::SaveMap(Map, FilePath, Report);
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Snapshot"
+		, meta = (CompactNodeTitle = "Load Map Snapshot"
+			, ToolTip = "Adds all values of a map snapshot to the map in one step, keyed by their Guid, after checking its checksums"))
+	static bool Snapshot_LoadIntoMap(UTMap* Map, const FString& FilePath, bool Broadcast, FContainerSnapshotReport& Report)
+	{
+		return FContainerSnapshot::LoadIntoMap(Map, FilePath, Broadcast, Report);
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Snapshot"
+		, meta = (CompactNodeTitle = "Save Set Snapshot"
+			, ToolTip = "Writes all items of the set to a binary snapshot. Relative paths are resolved against the project's Saved directory"))
+	static bool Snapshot_SaveSet(UTSet* Set, const FString& FilePath, FContainerSnapshotReport& Report)
+	{
+		return FContainerSnapshot::SaveSet(Set, FilePath, Report);
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Snapshot"
+		, meta = (CompactNodeTitle = "Load Set Snapshot"
+			, ToolTip = "Adds all items of a set snapshot to the set in one step, after checking its checksums"))
+	static bool Snapshot_LoadIntoSet(UTSet* Set, const FString& FilePath, bool Broadcast, FContainerSnapshotReport& Report)
+	{
+		return FContainerSnapshot::LoadIntoSet(Set, FilePath, Broadcast, Report);
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Snapshot"
+		, meta = (CompactNodeTitle = "Save MultiMap Snapshot"
+			, ToolTip = "Writes all key-value pairs of the multi map to a binary snapshot. Relative paths are resolved against the project's Saved directory"))
+	static bool Snapshot_SaveMultiMap(UTMultiMap* MultiMap, const FString& FilePath, FContainerSnapshotReport& Report)
+	{
+		return FContainerSnapshot::SaveMultiMap(MultiMap, FilePath, Report);
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Snapshot"
+		, meta = (CompactNodeTitle = "Load MultiMap Snapshot"
+			, ToolTip = "Adds all key-value pairs of a multi map snapshot to the multi map in one step with one notification, after checking its checksums"))
+	static bool Snapshot_LoadIntoMultiMap(UTMultiMap* MultiMap, const FString& FilePath, bool Broadcast, FContainerSnapshotReport& Report)
+	{
+		return FContainerSnapshot::LoadIntoMultiMap(MultiMap, FilePath, Broadcast, Report);
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Snapshot"
+		, meta = (CompactNodeTitle = "Drain Queue to Snapshot"
+			, ToolTip = "Dequeues all items and writes them, oldest first, to a binary snapshot - the queue is empty afterwards. Items enqueued meanwhile stay in the queue. If writing fails the items are enqueued again, behind those"))
+	static bool Snapshot_DrainQueue(UTQueue* Queue, const FString& FilePath, FContainerSnapshotReport& Report)
+	{
+		return FContainerSnapshot::DrainQueue(Queue, FilePath, Report);
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Snapshot"
+		, meta = (CompactNodeTitle = "Load Queue Snapshot"
+			, ToolTip = "Enqueues all items of a queue snapshot in their saved order, after checking its checksums"))
+	static bool Snapshot_LoadIntoQueue(UTQueue* Queue, const FString& FilePath, FContainerSnapshotReport& Report)
+	{
+		return FContainerSnapshot::LoadIntoQueue(Queue, FilePath, Report);
+	}
+};
@@ -0,0 +1,273 @@
+// Developer Bastian © 2024
+// License Creative Commons DEED 4.0 (https://creativecommons.org/licenses/by-sa/4.0/deed.en)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Runtime/Core/Public/Async/ParallelFor.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Algo/Sort.h"
+#include "ContainerProfiler.h"
+
+#include "ContainerSort.generated.h"
+
+/**
+ * Sort implementation used by the Sort functions of the containers
+ */
+UENUM(BlueprintType)
+	enum class EContainerSortBackend : uint8 {
+		E_Default		UMETA(DisplayName = "Default - Comparison Sort"),
+		E_Parallel		UMETA(DisplayName = "Parallel - Radix / Merge Sort")
+	};
+
+/**
+ * Parallel sort engine for the Number and Name fields of the container structs.
+ *
+ * Both sorts work on small precomputed keys plus the element index and return the sorted order
+ * as a permutation, so the (large) structs are moved exactly once, by ApplyOrder or by the
+ * container rebuilding itself in that order.
+ *  - Numbers: LSD radix sort, 8 bits per pass. Every worker counts and scatters its own chunk,
+ *    passes where all keys share the same byte are skipped.
+ *  - Names: parallel merge sort. The key holds the first four lower-cased characters, so most
+ *    comparisons are one integer compare - only equal prefixes fall back to a full string compare.
+ *    The order is the case-insensitive order of FString::operator<.
+ */
+struct FContainerSort
+{
+	// below this many elements everything runs on the calling thread
+	static constexpr int32 ParallelThreshold = 16384;
+
+	/**
+	 * Sorted order of Elements by the int32 GetNumber(Element) returns.
+	 * OutOrder[i] is the index of the element that belongs to position i.
+	 */
+	template <typename ElementType, typename GetterType>
+	static void NumberOrder(const TArray<ElementType>& Elements, GetterType&& GetNumber, bool bDescending, TArray<int32>& OutOrder)
+	{
+		BA_CONTAINER_SCOPE("FContainerSort::NumberOrder");
+		const int32 Num = Elements.Num();
+		TArray<FRadixEntry> Entries;
+		Entries.SetNumUninitialized(Num);
+		ForEachChunk(Num, [&](int32 Start, int32 End, int32)
+		{
+			for (int32 i = Start; i < End; ++i)
+			{
+				// flipping the sign bit turns signed order into unsigned order, inverting all bits reverses it
+				const uint32 Key = (uint32)GetNumber(Elements[i]) ^ 0x80000000u;
+				Entries[i] = { bDescending ? ~Key : Key, i };
+			}
+		});
+		RadixSort(Entries);
+		OutOrder.SetNumUninitialized(Num);
+		ForEachChunk(Num, [&](int32 Start, int32 End, int32)
+		{
+			for (int32 i = Start; i < End; ++i)
+				OutOrder[i] = Entries[i].Index;
+		});
+	}
+
+	/**
+	 * Sorted order of Elements by the FString GetName(Element) returns, ignoring case.
+	 * OutOrder[i] is the index of the element that belongs to position i.
+	 */
+	template <typename ElementType, typename GetterType>
+	static void NameOrder(const TArray<ElementType>& Elements, GetterType&& GetName, bool bDescending, TArray<int32>& OutOrder)
+	{
+		BA_CONTAINER_SCOPE("FContainerSort::NameOrder");
+		const int32 Num = Elements.Num();
+		TArray<FNameEntry> Entries;
+		Entries.SetNumUninitialized(Num);
+		ForEachChunk(Num, [&](int32 Start, int32 End, int32)
+		{
+			for (int32 i = Start; i < End; ++i)
+				Entries[i] = { NamePrefix(GetName(Elements[i])), i };
+		});
+		auto Less = [&Elements, &GetName, bDescending](const FNameEntry& A, const FNameEntry& B)
+		{
+			if (A.Prefix != B.Prefix)
+				return bDescending ? A.Prefix > B.Prefix : A.Prefix < B.Prefix;
+			const int32 Result = FCString::Stricmp(*GetName(Elements[A.Index]), *GetName(Elements[B.Index]));
+			return bDescending ? Result > 0 : Result < 0;
+		};
+		MergeSort(Entries, Less);
+		OutOrder.SetNumUninitialized(Num);
+		ForEachChunk(Num, [&](int32 Start, int32 End, int32)
+		{
+			for (int32 i = Start; i < End; ++i)
+				OutOrder[i] = Entries[i].Index;
+		});
+	}
+
+	// Reorders Elements so the element at Order[i] ends up at position i, every element is moved once
+	template <typename ElementType>
+	static void ApplyOrder(TArray<ElementType>& Elements, const TArray<int32>& Order)
+	{
+		BA_CONTAINER_SCOPE("FContainerSort::ApplyOrder");
+		check(Elements.Num() == Order.Num());
+		TArray<ElementType> Sorted;
+		Sorted.SetNum(Elements.Num());
+		ForEachChunk(Elements.Num(), [&](int32 Start, int32 End, int32)
+		{
+			for (int32 i = Start; i < End; ++i)
+				Sorted[i] = MoveTemp(Elements[Order[i]]);
+		});
+		Elements = MoveTemp(Sorted);
+	}
+
+private:
+	struct FRadixEntry
+	{
+		uint32 Key;
+		int32 Index;
+	};
+
+	struct FNameEntry
+	{
+		uint64 Prefix;
+		int32 Index;
+	};
+
+	// number of chunks for Num elements - one per worker, but never smaller than ParallelThreshold
+	static int32 GetChunkCount(int32 Num)
+	{
+		const int32 Workers = FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+		return FMath::Clamp(Num / ParallelThreshold, 1, Workers);
+	}
+
+	// Calls Function(Start, End, Chunk) for contiguous chunks of [0, Num), in parallel if there are several
+	template <typename FunctionType>
+	static void ForEachChunk(int32 Num, FunctionType&& Function)
+	{
+		if (Num == 0)
+			return;
+		const int32 NumChunks = GetChunkCount(Num);
+		const int32 ChunkSize = FMath::DivideAndRoundUp(Num, NumChunks);
+		ParallelFor(NumChunks, [&](int32 Chunk)
+		{
+			const int32 Start = Chunk * ChunkSize;
+			Function(Start, FMath::Min(Start + ChunkSize, Num), Chunk);
+		}, NumChunks > 1 ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+	}
+
+	/**
+	 * First four characters, lower-cased like FCString::Stricmp does for ASCII, packed so that
+	 * comparing two prefixes as integers compares the strings on those characters.
+	 */
+	static uint64 NamePrefix(const FString& Name)
+	{
+		uint64 Prefix = 0;
+		const int32 Len = Name.Len();
+		for (int32 i = 0; i < 4; ++i)
+		{
+			uint32 Char = i < Len ? (uint32)Name[i] : 0u;
+			if (Char >= 'A' && Char <= 'Z')
+				Char += 'a' - 'A';
+			Prefix = (Prefix << 16) | FMath::Min<uint32>(Char, 0xFFFFu);
+		}
+		return Prefix;
+	}
+
+	static void RadixSort(TArray<FRadixEntry>& Entries)
+	{
+		const int32 Num = Entries.Num();
+		if (Num < 2)
+			return;
+		const int32 NumChunks = GetChunkCount(Num);
+		const int32 ChunkSize = FMath::DivideAndRoundUp(Num, NumChunks);
+		TArray<FRadixEntry> Buffer;
+		Buffer.SetNumUninitialized(Num);
+		FRadixEntry* Source = Entries.GetData();
+		FRadixEntry* Target = Buffer.GetData();
+		// one histogram of 256 buckets per chunk, turned into the write offsets of that chunk
+		TArray<int32> Offsets;
+		Offsets.SetNumUninitialized(NumChunks * 256);
+		const EParallelForFlags Flags = NumChunks > 1 ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread;
+
+		for (int32 Shift = 0; Shift < 32; Shift += 8)
+		{
+			FMemory::Memzero(Offsets.GetData(), Offsets.Num() * sizeof(int32));
+			ParallelFor(NumChunks, [&](int32 Chunk)
+			{
+				int32* Counts = Offsets.GetData() + Chunk * 256;
+				const int32 End = FMath::Min((Chunk + 1) * ChunkSize, Num);
+				for (int32 i = Chunk * ChunkSize; i < End; ++i)
+					++Counts[(Source[i].Key >> Shift) & 0xFF];
+			}, Flags);
+
+			// digit-major, chunk-minor prefix sum keeps the sort stable, which LSD needs
+			int32 Offset = 0;
+			bool bSingleDigit = false;
+			for (int32 Digit = 0; Digit < 256 && !bSingleDigit; ++Digit)
+			{
+				int32 DigitCount = 0;
+				for (int32 Chunk = 0; Chunk < NumChunks; ++Chunk)
+				{
+					int32& Slot = Offsets[Chunk * 256 + Digit];
+					const int32 Count = Slot;
+					Slot = Offset;
+					Offset += Count;
+					DigitCount += Count;
+				}
+				bSingleDigit = DigitCount == Num;
+			}
+			// all keys share this byte - the pass would not change the order
+			if (bSingleDigit)
+				continue;
+
+			ParallelFor(NumChunks, [&](int32 Chunk)
+			{
+				int32* Positions = Offsets.GetData() + Chunk * 256;
+				const int32 End = FMath::Min((Chunk + 1) * ChunkSize, Num);
+				for (int32 i = Chunk * ChunkSize; i < End; ++i)
+					Target[Positions[(Source[i].Key >> Shift) & 0xFF]++] = Source[i];
+			}, Flags);
+			Swap(Source, Target);
+		}
+		if (Source != Entries.GetData())
+			FMemory::Memcpy(Entries.GetData(), Source, Num * sizeof(FRadixEntry));
+	}
+
+	// Sorts every chunk on its own worker, then merges neighbouring runs pairwise until one run is left
+	template <typename EntryType, typename LessType>
+	static void MergeSort(TArray<EntryType>& Entries, const LessType& Less)
+	{
+		const int32 Num = Entries.Num();
+		if (Num < 2)
+			return;
+		const int32 NumChunks = GetChunkCount(Num);
+		const int32 ChunkSize = FMath::DivideAndRoundUp(Num, NumChunks);
+		const EParallelForFlags Flags = NumChunks > 1 ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread;
+		ParallelFor(NumChunks, [&](int32 Chunk)
+		{
+			const int32 Start = Chunk * ChunkSize;
+			Algo::Sort(TArrayView<EntryType>(Entries.GetData() + Start, FMath::Min(ChunkSize, Num - Start)), Less);
+		}, Flags);
+		if (NumChunks == 1)
+			return;
+
+		TArray<EntryType> Buffer;
+		Buffer.SetNumUninitialized(Num);
+		EntryType* Source = Entries.GetData();
+		EntryType* Target = Buffer.GetData();
+		for (int32 Width = ChunkSize; Width < Num; Width *= 2)
+		{
+			const int32 NumMerges = FMath::DivideAndRoundUp(Num, 2 * Width);
+			ParallelFor(NumMerges, [&](int32 Merge)
+			{
+				const int32 Start = Merge * 2 * Width;
+				const int32 Middle = FMath::Min(Start + Width, Num);
+				const int32 End = FMath::Min(Start + 2 * Width, Num);
+				int32 A = Start, B = Middle, Out = Start;
+				while (A < Middle && B < End)
+					Target[Out++] = Less(Source[B], Source[A]) ? Source[B++] : Source[A++];
+				while (A < Middle)
+					Target[Out++] = Source[A++];
+				while (B < End)
+					Target[Out++] = Source[B++];
+			}, NumMerges > 1 ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+			Swap(Source, Target);
+		}
+		if (Source != Entries.GetData())
+			FMemory::Memcpy(Entries.GetData(), Source, Num * sizeof(EntryType));
+	}
+};
@@ -0,0 +1,233 @@
+// Developer Bastian © 2024
+// License Creative Commons DEED 4.0 (https://creativecommons.org/licenses/by-sa/4.0/deed.en)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/StringView.h"
+#include "Async/ParallelFor.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "ContainerProfiler.h"
+#include "ContainerNameArena.h"
+#include <atomic>
+
+#include "ContainerStringTransform.generated.h"
+
+/**
+ * Bulk rename applied to all names of a container
+ */
+UENUM(BlueprintType)
+	enum class EContainerStringTransform : uint8 {
+		E_Prefix		UMETA(DisplayName = "Add Prefix"),
+		E_Suffix		UMETA(DisplayName = "Add Suffix"),
+		E_Replace		UMETA(DisplayName = "Replace")
+	};
+
+/**
+ * Bulk string transform - prefix, suffix or replace - over many names.
+ *
+ * The exact length of every result is computed before anything is written, so each FString is
+ * allocated once at its final size and written front to back, instead of Name.InsertAt(0, Prefix)
+ * reallocating and moving the whole string. For an FContainerNameArena all results go into one
+ * pre-sized buffer and are interned into a new arena in one pass.
+ * With bSkipIfPresent a prefix or suffix is not added to names that already have it, so running
+ * the same relabel pass twice does not grow the names again.
+ */
+struct FContainerStringTransform
+{
+	EContainerStringTransform Transform = EContainerStringTransform::E_Prefix;
+	// prefix, suffix or the text to replace
+	FString Text;
+	// replacement of Text, only used by E_Replace
+	FString Replacement;
+	bool bSkipIfPresent = false;
+
+	FContainerStringTransform() = default;
+
+	FContainerStringTransform(EContainerStringTransform InTransform, const FString& InText, const FString& InReplacement = FString(), bool bInSkipIfPresent = false)
+		: Transform(InTransform), Text(InText), Replacement(InReplacement), bSkipIfPresent(bInSkipIfPresent)
+	{
+	}
+
+	// True if Name is left as it is
+	bool IsUnchanged(FStringView Name) const
+	{
+		if (this->Text.IsEmpty())
+			return true;
+		switch (this->Transform)
+		{
+		case EContainerStringTransform::E_Prefix:
+			return this->bSkipIfPresent && Name.StartsWith(this->Text, ESearchCase::CaseSensitive);
+		case EContainerStringTransform::E_Suffix:
+			return this->bSkipIfPresent && Name.EndsWith(this->Text, ESearchCase::CaseSensitive);
+		default:
+			return FindText(Name, 0) == INDEX_NONE;
+		}
+	}
+
+	// Exact length of the transformed Name
+	int32 GetResultLen(FStringView Name) const
+	{
+		if (IsUnchanged(Name))
+			return Name.Len();
+		if (this->Transform != EContainerStringTransform::E_Replace)
+			return Name.Len() + this->Text.Len();
+		int32 Count = 0;
+		for (int32 Found = FindText(Name, 0); Found != INDEX_NONE; Found = FindText(Name, Found + this->Text.Len()))
+			++Count;
+		return Name.Len() + Count * (this->Replacement.Len() - this->Text.Len());
+	}
+
+	// Writes the transformed Name to Out, which has room for GetResultLen(Name) characters
+	void Write(FStringView Name, TCHAR* Out) const
+	{
+		if (IsUnchanged(Name))
+		{
+			Copy(Out, Name);
+			return;
+		}
+		switch (this->Transform)
+		{
+		case EContainerStringTransform::E_Prefix:
+			Out = Copy(Out, this->Text);
+			Copy(Out, Name);
+			break;
+		case EContainerStringTransform::E_Suffix:
+			Out = Copy(Out, Name);
+			Copy(Out, this->Text);
+			break;
+		default:
+		{
+			int32 Start = 0;
+			for (int32 Found = FindText(Name, 0); Found != INDEX_NONE; Found = FindText(Name, Start))
+			{
+				Out = Copy(Out, Name.Mid(Start, Found - Start));
+				Out = Copy(Out, this->Replacement);
+				Start = Found + this->Text.Len();
+			}
+			Copy(Out, Name.RightChop(Start));
+			break;
+		}
+		}
+	}
+
+	// Transforms Name, allocating its result once. Returns false if Name was left as it is
+	bool Apply(FString& Name) const
+	{
+		if (IsUnchanged(Name))
+			return false;
+		const int32 Len = GetResultLen(Name);
+		if (Len == 0)
+		{
+			Name.Empty();
+			return true;
+		}
+		FString Result;
+		TArray<TCHAR>& Chars = Result.GetCharArray();
+		Chars.SetNumUninitialized(Len + 1);
+		Write(Name, Chars.GetData());
+		Chars[Len] = TEXT('\0');
+		Name = MoveTemp(Result);
+		return true;
+	}
+
+	/**
+	 * Transforms the FString& GetName(int32 Index) returns for every index below Num, in contiguous
+	 * chunks of ChunkSize on worker threads - 0 picks a size. No lock is taken, every name is only
+	 * touched by the chunk that owns its index. Returns the number of changed names.
+	 */
+	template <typename GetterType>
+	int32 ApplyAll(int32 Num, GetterType&& GetName, int32 ChunkSize = 0, bool bParallel = true) const
+	{
+		BA_CONTAINER_SCOPE("FContainerStringTransform::ApplyAll");
+		if (Num == 0 || this->Text.IsEmpty())
+			return 0;
+		ChunkSize = ResolveChunkSize(Num, ChunkSize);
+		const int32 NumChunks = FMath::DivideAndRoundUp(Num, ChunkSize);
+		std::atomic<int32> NumChanged(0);
+		ParallelFor(NumChunks, [&](int32 Chunk)
+		{
+			int32 ChunkChanged = 0;
+			const int32 End = FMath::Min((Chunk + 1) * ChunkSize, Num);
+			for (int32 i = Chunk * ChunkSize; i < End; ++i)
+			{
+				if (Apply(GetName(i)))
+					++ChunkChanged;
+			}
+			NumChanged += ChunkChanged;
+		}, bParallel && NumChunks > 1 ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+		return NumChanged.load();
+	}
+
+	/**
+	 * Transforms the names of Source with the given Handles into Target. The result lengths are
+	 * summed up first, all results are written in parallel into one buffer of that size, then
+	 * interned into Target - which is reserved once for all of them. OutHandles[i] is the Target
+	 * handle of Handles[i]. A replace can map several names to the same result, they share a handle.
+	 */
+	void ApplyAll(const FContainerNameArena& Source, TConstArrayView<FContainerNameArena::FHandle> Handles
+		, FContainerNameArena& Target, TArray<FContainerNameArena::FHandle>& OutHandles) const
+	{
+		BA_CONTAINER_SCOPE("FContainerStringTransform::ApplyAll (Arena)");
+		const int32 Num = Handles.Num();
+		const int32 ChunkSize = ResolveChunkSize(Num, 0);
+		const int32 NumChunks = FMath::DivideAndRoundUp(Num, ChunkSize);
+		const EParallelForFlags Flags = NumChunks > 1 ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread;
+
+		TArray<int32> Offsets;
+		Offsets.SetNumUninitialized(Num + 1);
+		Offsets[0] = 0;
+		ParallelFor(NumChunks, [&](int32 Chunk)
+		{
+			const int32 End = FMath::Min((Chunk + 1) * ChunkSize, Num);
+			for (int32 i = Chunk * ChunkSize; i < End; ++i)
+				Offsets[i + 1] = GetResultLen(Source.Get(Handles[i]));
+		}, Flags);
+		for (int32 i = 0; i < Num; ++i)
+			Offsets[i + 1] += Offsets[i];
+
+		TArray<TCHAR> Buffer;
+		Buffer.SetNumUninitialized(Offsets[Num]);
+		ParallelFor(NumChunks, [&](int32 Chunk)
+		{
+			const int32 End = FMath::Min((Chunk + 1) * ChunkSize, Num);
+			for (int32 i = Chunk * ChunkSize; i < End; ++i)
+				Write(Source.Get(Handles[i]), Buffer.GetData() + Offsets[i]);
+		}, Flags);
+
+		Target.Reserve(Num, Offsets[Num] + Num);
+		OutHandles.SetNumUninitialized(Num);
+		for (int32 i = 0; i < Num; ++i)
+			OutHandles[i] = Target.Intern(FStringView(Buffer.GetData() + Offsets[i], Offsets[i + 1] - Offsets[i]));
+	}
+
+private:
+	// elements per chunk - about four chunks per worker, but at least 256
+	static int32 ResolveChunkSize(int32 Num, int32 ChunkSize)
+	{
+		if (ChunkSize > 0)
+			return ChunkSize;
+		const int32 Workers = FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+		return FMath::Max(256, FMath::DivideAndRoundUp(Num, Workers * 4));
+	}
+
+	// First case sensitive occurrence of Text in Name at or after Start, INDEX_NONE if there is none
+	int32 FindText(FStringView Name, int32 Start) const
+	{
+		const int32 TextLen = this->Text.Len();
+		const TCHAR* TextChars = *this->Text;
+		for (int32 i = Start; i + TextLen <= Name.Len(); ++i)
+		{
+			if (Name[i] == TextChars[0] && FMemory::Memcmp(Name.GetData() + i, TextChars, TextLen * sizeof(TCHAR)) == 0)
+				return i;
+		}
+		return INDEX_NONE;
+	}
+
+	// Copies Chars to Out and returns the position behind them
+	static FORCEINLINE TCHAR* Copy(TCHAR* Out, FStringView Chars)
+	{
+		FMemory::Memcpy(Out, Chars.GetData(), Chars.Len() * sizeof(TCHAR));
+		return Out + Chars.Len();
+	}
+};
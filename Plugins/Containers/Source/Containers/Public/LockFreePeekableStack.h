@@ -0,0 +1,200 @@
+// Developer Bastian © 2024
+// License Creative Commons DEED 4.0 (https://creativecommons.org/licenses/by-sa/4.0/deed.en)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+
+/**
+ * Lock-free stack (Treiber) whose top can be read in place.
+ *
+ * Nodes are allocated in chunks and never freed before the stack is: a popped node goes to a free
+ * list and is reused by the next push, so a steady push/pop workload does not allocate and a node
+ * stays valid memory even after another thread popped it. Heads are a node index plus a counter
+ * that grows with every change, which protects against the ABA problem.
+ *
+ * Peek pins the top node with a per-node reader count and only copies it if the head did not change
+ * meanwhile. Nobody waits for a pinned node: a pop copies instead of moving out of it, and a push
+ * does not reuse it but takes a fresh node.
+ */
+template <typename ElementType>
+class TLockFreePeekableStack
+{
+public:
+	TLockFreePeekableStack() = default;
+
+	~TLockFreePeekableStack()
+	{
+		for (std::atomic<FNode*>& Chunk : Chunks)
+			delete[] Chunk.load(std::memory_order_relaxed);
+	}
+
+	TLockFreePeekableStack(const TLockFreePeekableStack&) = delete;
+	TLockFreePeekableStack& operator=(const TLockFreePeekableStack&) = delete;
+
+	FORCEINLINE bool IsEmpty() const
+	{
+		return GetIndex(Head.load(std::memory_order_acquire)) == NoIndex;
+	}
+
+	template <typename ArgType>
+	void Push(ArgType&& Value)
+	{
+		const uint32 Index = AllocateNode();
+		FNode& Node = GetNode(Index);
+		Node.Item = Forward<ArgType>(Value);
+		PushIndex(Head, Index);
+	}
+
+	// Takes the top element, returns false if the stack is empty
+	bool Pop(ElementType& OutValue)
+	{
+		const uint32 Index = PopIndex(Head);
+		if (Index == NoIndex)
+			return false;
+		TakeItem(GetNode(Index), OutValue);
+		PushIndex(FreeHead, Index);
+		return true;
+	}
+
+	// Copies the top element without removing it, returns false if the stack is empty
+	bool Peek(ElementType& OutValue) const
+	{
+		for (;;)
+		{
+			const uint64 Top = Head.load(std::memory_order_seq_cst);
+			if (GetIndex(Top) == NoIndex)
+				return false;
+			FNode& Node = GetNode(GetIndex(Top));
+			Node.Readers.fetch_add(1, std::memory_order_seq_cst);
+			// an unchanged head means the node was not popped before the pin
+			const bool bPinned = Head.load(std::memory_order_seq_cst) == Top;
+			if (bPinned)
+				OutValue = Node.Item;
+			Node.Readers.fetch_sub(1, std::memory_order_release);
+			if (bPinned)
+				return true;
+		}
+	}
+
+	// Takes the whole stack with one change of the head and appends its elements, top first
+	int32 PopAll(TArray<ElementType>& OutValues)
+	{
+		uint64 Top = Head.load(std::memory_order_relaxed);
+		while (!Head.compare_exchange_weak(Top, MakeHead(GetCounter(Top) + 1, NoIndex), std::memory_order_seq_cst, std::memory_order_relaxed))
+		{
+		}
+		int32 NumTaken = 0;
+		for (uint32 Index = GetIndex(Top); Index != NoIndex; ++NumTaken)
+		{
+			FNode& Node = GetNode(Index);
+			const uint32 Next = Node.Next.load(std::memory_order_relaxed);
+			TakeItem(Node, OutValues.AddDefaulted_GetRef());
+			PushIndex(FreeHead, Index);
+			Index = Next;
+		}
+		return NumTaken;
+	}
+
+private:
+	struct FNode
+	{
+		ElementType Item;
+		std::atomic<uint32> Next{ NoIndex };
+		// number of Peeks that pinned the node right now
+		std::atomic<int32> Readers{ 0 };
+	};
+
+	static constexpr uint32 NoIndex = MAX_uint32;
+	// chunk k holds FirstChunkSize << k nodes, 26 chunks keep every index below NoIndex
+	static constexpr uint32 FirstChunkSize = 64;
+	static constexpr int32 NumChunks = 26;
+
+	static FORCEINLINE uint64 MakeHead(uint32 Counter, uint32 Index)
+	{
+		return ((uint64)Counter << 32) | Index;
+	}
+
+	static FORCEINLINE uint32 GetIndex(uint64 InHead)
+	{
+		return (uint32)InHead;
+	}
+
+	static FORCEINLINE uint32 GetCounter(uint64 InHead)
+	{
+		return (uint32)(InHead >> 32);
+	}
+
+	FORCEINLINE FNode& GetNode(uint32 Index) const
+	{
+		const uint32 Chunk = FMath::FloorLog2(Index / FirstChunkSize + 1);
+		return Chunks[Chunk].load(std::memory_order_acquire)[Index - FirstChunkSize * ((1u << Chunk) - 1)];
+	}
+
+	void PushIndex(std::atomic<uint64>& ListHead, uint32 Index)
+	{
+		FNode& Node = GetNode(Index);
+		uint64 Top = ListHead.load(std::memory_order_relaxed);
+		do
+		{
+			Node.Next.store(GetIndex(Top), std::memory_order_relaxed);
+		}
+		while (!ListHead.compare_exchange_weak(Top, MakeHead(GetCounter(Top) + 1, Index), std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	uint32 PopIndex(std::atomic<uint64>& ListHead)
+	{
+		uint64 Top = ListHead.load(std::memory_order_acquire);
+		for (;;)
+		{
+			const uint32 Index = GetIndex(Top);
+			if (Index == NoIndex)
+				return NoIndex;
+			// the node may be popped and reused meanwhile, then the counter fails the exchange
+			const uint32 Next = GetNode(Index).Next.load(std::memory_order_relaxed);
+			// seq_cst pairs with Peek, which pins the node and then re-reads the head
+			if (ListHead.compare_exchange_weak(Top, MakeHead(GetCounter(Top) + 1, Next), std::memory_order_seq_cst, std::memory_order_acquire))
+				return Index;
+		}
+	}
+
+	// Moves the item out of a node that just left the stack, or copies it if a Peek still reads it
+	static void TakeItem(FNode& Node, ElementType& OutValue)
+	{
+		if (Node.Readers.load(std::memory_order_seq_cst) == 0)
+			OutValue = MoveTemp(Node.Item);
+		else
+			OutValue = Node.Item;
+	}
+
+	// Takes a node from the free list, or a fresh one if there is none or a Peek still reads it
+	uint32 AllocateNode()
+	{
+		const uint32 Free = PopIndex(FreeHead);
+		if (Free != NoIndex)
+		{
+			// a Peek pinned after the node left the stack never reads it, so zero here is final
+			if (GetNode(Free).Readers.load(std::memory_order_acquire) == 0)
+				return Free;
+			PushIndex(FreeHead, Free);
+		}
+		const uint32 Index = NumAllocated.fetch_add(1, std::memory_order_relaxed);
+		const uint32 Chunk = FMath::FloorLog2(Index / FirstChunkSize + 1);
+		checkf(Chunk < NumChunks, TEXT("TLockFreePeekableStack ran out of node indices"));
+		if (Chunks[Chunk].load(std::memory_order_acquire) == nullptr)
+		{
+			FNode* NewChunk = new FNode[FirstChunkSize << Chunk];
+			FNode* Expected = nullptr;
+			// another thread may have allocated the chunk meanwhile
+			if (!Chunks[Chunk].compare_exchange_strong(Expected, NewChunk, std::memory_order_acq_rel))
+				delete[] NewChunk;
+		}
+		return Index;
+	}
+
+	std::atomic<uint64> Head{ MakeHead(0, NoIndex) };
+	std::atomic<uint64> FreeHead{ MakeHead(0, NoIndex) };
+	std::atomic<uint32> NumAllocated{ 0 };
+	std::atomic<FNode*> Chunks[NumChunks] = {};
+};
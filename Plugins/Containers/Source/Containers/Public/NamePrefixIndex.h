@@ -0,0 +1,255 @@
+// Developer Bastian © 2024
+// License Creative Commons DEED 4.0 (https://creativecommons.org/licenses/by-sa/4.0/deed.en)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Algo/BinarySearch.h"
+
+/**
+ * Case-insensitive prefix index over the Name field of a container.
+ *
+ * Keeps the lower-cased names sorted together with an id of their element (array index, FSetElementId, ...).
+ * All names starting with a prefix are one contiguous range of that order, so a prefix query is a
+ * binary search plus a walk over the matches - no element of the container is looked at.
+ *
+ * The index is built lazily: it starts invalid and the owning container fills it on the first query.
+ * Single adds go into a small sorted pending buffer that queries search next to the main entries, it is
+ * only merged once it outgrows about sqrt(n) entries. Removed entries are just marked and compacted once
+ * they make up a quarter of the index, so adding and removing never moves the whole index.
+ */
+template <typename IdType>
+class TNamePrefixIndex
+{
+public:
+	struct FEntry
+	{
+		FString Folded;
+		IdType Id;
+		bool bRemoved = false;
+	};
+
+	FORCEINLINE bool IsValid() const
+	{
+		return bValid;
+	}
+
+	// Drops all entries, the owner has to rebuild before the next query
+	void Invalidate()
+	{
+		Entries.Empty();
+		Pending.Empty();
+		NumRemoved = 0;
+		bPendingSorted = true;
+		bValid = false;
+	}
+
+	// Starts a valid, empty index - the owner adds all its elements afterwards
+	void Reset(int32 ExpectedNum = 0)
+	{
+		Entries.Reset();
+		Pending.Reset(ExpectedNum);
+		NumRemoved = 0;
+		bPendingSorted = true;
+		bValid = true;
+	}
+
+	// Adds one element, ignored while the index is invalid
+	void Add(const FString& Name, IdType Id)
+	{
+		if (!bValid)
+			return;
+		FEntry Entry{ Name.ToLower(), Id };
+		if (bPendingSorted && Pending.Num() < GetPendingLimit())
+		{
+			const int32 Position = Algo::UpperBound(Pending, Entry, FFoldedLess());
+			Pending.Insert(MoveTemp(Entry), Position);
+			return;
+		}
+		// bulk adds are sorted and merged in one go by the next query
+		Pending.Add(MoveTemp(Entry));
+		bPendingSorted = false;
+	}
+
+	// Removes the entry of one element, returns false if it is not indexed
+	bool Remove(const FString& Name, IdType Id)
+	{
+		if (!bValid)
+			return false;
+		const FString Folded = Name.ToLower();
+		for (int32 i = Algo::LowerBound(Entries, Folded, FFoldedLess()); i < Entries.Num() && Entries[i].Folded.Equals(Folded, ESearchCase::CaseSensitive); ++i)
+		{
+			if (Entries[i].Id == Id && !Entries[i].bRemoved)
+			{
+				Entries[i].bRemoved = true;
+				++NumRemoved;
+				if (NumRemoved * 4 > Entries.Num())
+					Compact();
+				return true;
+			}
+		}
+		if (!bPendingSorted)
+		{
+			const int32 PendingIndex = Pending.IndexOfByPredicate([&Id](const FEntry& Entry) { return Entry.Id == Id; });
+			if (PendingIndex == INDEX_NONE)
+				return false;
+			Pending.RemoveAtSwap(PendingIndex, 1, false);
+			return true;
+		}
+		for (int32 i = Algo::LowerBound(Pending, Folded, FFoldedLess()); i < Pending.Num() && Pending[i].Folded.Equals(Folded, ESearchCase::CaseSensitive); ++i)
+		{
+			if (Pending[i].Id == Id)
+			{
+				Pending.RemoveAt(i, 1, false);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// Calls Visitor with the id of every element whose name starts with Prefix, ignoring case
+	template <typename VisitorType>
+	void ForEachWithPrefix(const FString& Prefix, VisitorType&& Visitor)
+	{
+		const FString Folded = Prefix.ToLower();
+		if (!bPendingSorted)
+			MergePending();
+		int32 First, Last;
+		FindPrefixRange(Entries, Folded, First, Last);
+		for (int32 i = First; i < Last; ++i)
+		{
+			if (!Entries[i].bRemoved)
+				Visitor(Entries[i].Id);
+		}
+		FindPrefixRange(Pending, Folded, First, Last);
+		for (int32 i = First; i < Last; ++i)
+		{
+			Visitor(Pending[i].Id);
+		}
+	}
+
+	// Removes the entries of all elements whose name starts with Prefix and returns their ids
+	void RemovePrefix(const FString& Prefix, TArray<IdType>& OutIds)
+	{
+		const FString Folded = Prefix.ToLower();
+		if (!bPendingSorted)
+			MergePending();
+		OutIds.Reset();
+		int32 First, Last;
+		FindPrefixRange(Entries, Folded, First, Last);
+		for (int32 i = First; i < Last; ++i)
+		{
+			if (Entries[i].bRemoved)
+				continue;
+			OutIds.Add(Entries[i].Id);
+			Entries[i].bRemoved = true;
+			++NumRemoved;
+		}
+		FindPrefixRange(Pending, Folded, First, Last);
+		for (int32 i = First; i < Last; ++i)
+		{
+			OutIds.Add(Pending[i].Id);
+		}
+		Pending.RemoveAt(First, Last - First, false);
+		if (NumRemoved * 4 > Entries.Num())
+			Compact();
+	}
+
+	// Replaces every id with Remap(id), e.g. after the owner compacted its storage - the order of the names stays
+	template <typename RemapType>
+	void RemapIds(RemapType&& Remap)
+	{
+		for (FEntry& Entry : Entries)
+			Entry.Id = Remap(Entry.Id);
+		for (FEntry& Entry : Pending)
+			Entry.Id = Remap(Entry.Id);
+	}
+
+private:
+	struct FFoldedLess
+	{
+		FORCEINLINE bool operator()(const FEntry& A, const FEntry& B) const
+		{
+			return A.Folded.Compare(B.Folded, ESearchCase::CaseSensitive) < 0;
+		}
+
+		FORCEINLINE bool operator()(const FEntry& A, const FString& B) const
+		{
+			return A.Folded.Compare(B, ESearchCase::CaseSensitive) < 0;
+		}
+
+		FORCEINLINE bool operator()(const FString& A, const FEntry& B) const
+		{
+			return A.Compare(B.Folded, ESearchCase::CaseSensitive) < 0;
+		}
+	};
+
+	// pending entries kept sorted by single adds, inserting costs one move of at most this many
+	FORCEINLINE int32 GetPendingLimit() const
+	{
+		return FMath::Max(64, (int32)FMath::Sqrt((float)Entries.Num()));
+	}
+
+	static void FindPrefixRange(const TArray<FEntry>& Sorted, const FString& Folded, int32& OutFirst, int32& OutLast)
+	{
+		OutFirst = Algo::LowerBound(Sorted, Folded, FFoldedLess());
+		OutLast = OutFirst;
+		while (OutLast < Sorted.Num() && Sorted[OutLast].Folded.StartsWith(Folded, ESearchCase::CaseSensitive))
+		{
+			++OutLast;
+		}
+	}
+
+	// drops the removed entries in one linear pass
+	void Compact()
+	{
+		Entries.RemoveAll([](const FEntry& Entry) { return Entry.bRemoved; });
+		NumRemoved = 0;
+	}
+
+	// sorts the pending entries and merges them into the sorted ones in one linear pass, dropping removed ones
+	void MergePending()
+	{
+		bPendingSorted = true;
+		if (Pending.Num() == 0)
+			return;
+		Pending.StableSort(FFoldedLess());
+		if (Entries.Num() == 0)
+		{
+			Entries = MoveTemp(Pending);
+			Pending.Reset();
+			return;
+		}
+		TArray<FEntry> Merged;
+		Merged.Reserve(Entries.Num() - NumRemoved + Pending.Num());
+		int32 A = 0, B = 0;
+		const FFoldedLess Less;
+		while (A < Entries.Num() && B < Pending.Num())
+		{
+			if (Entries[A].bRemoved)
+				++A;
+			else if (Less(Pending[B], Entries[A]))
+				Merged.Add(MoveTemp(Pending[B++]));
+			else
+				Merged.Add(MoveTemp(Entries[A++]));
+		}
+		for (; A < Entries.Num(); ++A)
+		{
+			if (!Entries[A].bRemoved)
+				Merged.Add(MoveTemp(Entries[A]));
+		}
+		while (B < Pending.Num())
+			Merged.Add(MoveTemp(Pending[B++]));
+		Entries = MoveTemp(Merged);
+		Pending.Reset();
+		NumRemoved = 0;
+	}
+
+	TArray<FEntry> Entries;
+	// sorted while bPendingSorted, otherwise in the order of adding
+	TArray<FEntry> Pending;
+	// entries marked as removed, but not compacted yet
+	int32 NumRemoved = 0;
+	bool bPendingSorted = true;
+	bool bValid = false;
+};
@@ -0,0 +1,117 @@
+// Developer Bastian © 2024
+// License Creative Commons DEED 4.0 (https://creativecommons.org/licenses/by-sa/4.0/deed.en)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "Misc/SpinLock.h"
+#include "TQueue.h"
+#include <atomic>
+
+#include "QueueConsumerPool.generated.h"
+
+class FQueueConsumerWorker;
+
+/**
+ * Delegate with the items the handler handed back, fired on the game thread
+ */
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnQueueItemsProcessed, const TArray<FQueueTestStruct>&, Items);
+
+/**
+ * Drains a UTQueue on worker threads.
+ *
+ * Every worker takes a batch of items from the queue into a local deque and runs the handler on them.
+ * Only one worker at a time takes from the queue (its consumer lock keeps TQueue single-consumer),
+ * the others work on their local batch or, once it is empty, steal the back half of another
+ * worker's batch - so a slow item does not hold up the items queued behind it.
+ * Workers without anything to do sleep on the queue's items signal until a producer enqueues.
+ *
+ * The items the handler hands back are collected from all workers and broadcast on the game thread
+ * in one OnItemsProcessed event per game thread task instead of one event per item.
+ */
+UCLASS(BlueprintType, Transient)
+class CONTAINERS_API UTQueueConsumerPool : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * Runs on a worker thread for every item, may change the item.
+	 * Returns true to hand the item back to the game thread.
+	 */
+	using FHandler = TFunction<bool(FQueueTestStruct& Item)>;
+
+	virtual void BeginDestroy() override;
+
+	#pragma region Delegates
+
+	UPROPERTY(BlueprintAssignable, Category = "BA Container - Queue Consumer Pool"
+		, meta = (ToolTip = "Delegate with the items the handler handed back, fired on the game thread"))
+	FOnQueueItemsProcessed OnItemsProcessed_Delegate;
+
+#pragma endregion Delegates
+
+	#pragma region Public Functions
+
+	// Sets the handler, only while the pool is stopped. Without a handler every item is handed back unchanged.
+	void Pool_SetHandler(FHandler InHandler);
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Queue Consumer Pool"
+		, meta = (CompactNodeTitle = "Start Pool"
+			, ToolTip = "Starts NumWorkers threads that drain Queue in batches of BatchSize items. Returns false if the pool is already running or Queue is not set"))
+	bool Pool_Start(UTQueue* Queue, int32 NumWorkers, int32 BatchSize);
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Queue Consumer Pool"
+		, meta = (CompactNodeTitle = "Stop Pool"
+			, ToolTip = "Stops the workers after the items they already took. With DrainQueue they also process what is left in the queue. Blocks until all workers are done, then broadcasts the remaining results"))
+	void Pool_Stop(bool DrainQueue);
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "BA Container - Queue Consumer Pool"
+		, meta = (CompactNodeTitle = "Is Running?"
+			, ToolTip = "Checks whether the workers are running"))
+	bool Pool_IsRunning() const;
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "BA Container - Queue Consumer Pool"
+		, meta = (CompactNodeTitle = "Processed Items"
+			, ToolTip = "Returns the number of items the handler ran on since the pool was created"))
+	int64 Pool_GetProcessedCount() const;
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "BA Container - Queue Consumer Pool"
+		, meta = (CompactNodeTitle = "Stolen Items"
+			, ToolTip = "Returns the number of items workers took from another worker's batch. A high share means the batch size is too large for the handler's cost"))
+	int64 Pool_GetStolenCount() const;
+
+#pragma endregion Public Functions
+
+private:
+	friend class FQueueConsumerWorker;
+
+	// Loop of worker Index, returns when the pool stops
+	void RunWorker(int32 Index);
+	// Takes a batch from the queue into the local deque of Worker
+	bool RefillFromQueue(FQueueConsumerWorker& Worker);
+	// Moves the back half of another worker's deque into the deque of worker Index
+	bool StealFor(int32 Index);
+	// Hands Results to the game thread, Results is empty afterwards
+	void PostResults(TArray<FQueueTestStruct>& Results);
+	// Game thread - broadcasts everything posted so far
+	void FlushResults();
+	void StopWorkers(bool bDrainQueue);
+
+	UPROPERTY()
+	TObjectPtr<UTQueue> Queue;
+
+	FHandler Handler;
+	TArray<TUniquePtr<FQueueConsumerWorker>> Workers;
+	int32 BatchSize = 64;
+
+	std::atomic<bool> bStopRequested{ false };
+	std::atomic<bool> bDrainOnStop{ false };
+	std::atomic<int64> ProcessedCount{ 0 };
+	std::atomic<int64> StolenCount{ 0 };
+
+	UE::FSpinLock ResultsLock;
+	TArray<FQueueTestStruct> PendingResults;
+	std::atomic<bool> bResultsScheduled{ false };
+};
@@ -0,0 +1,122 @@
+// Developer Bastian © 2024
+// License Creative Commons DEED 4.0 (https://creativecommons.org/licenses/by-sa/4.0/deed.en)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/PlatformTLS.h"
+#include "Timer.h"
+#include <atomic>
+
+#include "QueueInstrumentation.generated.h"
+
+/**
+ * Snapshot of the metrics of an instrumented queue.
+ * Latency percentiles are recorded by the container profiler as operation "UTQueue::Latency".
+ */
+USTRUCT(BlueprintType)
+struct FQueueMetrics
+{
+public:
+	GENERATED_USTRUCT_BODY()
+
+	// items in the queue right now
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Queue Metrics")
+	int32 Depth;
+
+	// largest depth since instrumentation was enabled or reset - sampled, peaks shorter than the sampling interval can be missed
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Queue Metrics")
+	int32 HighWaterMark;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Queue Metrics")
+	int64 TotalEnqueued;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Queue Metrics")
+	int64 TotalDequeued;
+
+	// items per second since the previous snapshot
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Queue Metrics")
+	float EnqueuePerSecond;
+
+	// items per second since the previous snapshot
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Queue Metrics")
+	float DequeuePerSecond;
+
+	// time from enqueue to dequeue, averaged over all dequeued items
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Queue Metrics")
+	double AverageLatencyMilliseconds;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Queue Metrics")
+	double MaxLatencyMilliseconds;
+
+	// length of the window the rates were measured over
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Queue Metrics")
+	double SampleSeconds;
+
+	FQueueMetrics() : Depth(0), HighWaterMark(0), TotalEnqueued(0), TotalDequeued(0), EnqueuePerSecond(0.f)
+		, DequeuePerSecond(0.f), AverageLatencyMilliseconds(0.0), MaxLatencyMilliseconds(0.0), SampleSeconds(0.0)
+	{
+	}
+};
+
+/**
+ * Counters behind an instrumented queue.
+ *
+ * Producers only increment the enqueue counter of their own shard, so threads enqueueing at the same
+ * time do not fight over one cache line. Everything else is updated by the consumer.
+ * The high-water mark needs no work on the producer side either: the depth only grows between two
+ * dequeues, so its maximum is reached right before a dequeue (or now). Summing up all shards is too
+ * expensive for every dequeue, so the depth is only checked every HighWaterMarkInterval dequeues and in Sample.
+ */
+class CONTAINERS_API FQueueInstrumentation
+{
+public:
+	static constexpr int32 NumShards = 16;
+	// dequeues between two checks of the high-water mark, a power of two
+	static constexpr int64 HighWaterMarkInterval = 64;
+
+	FQueueInstrumentation();
+
+	// Producer side - returns the timestamp to store with the item
+	FORCEINLINE uint64 OnEnqueue()
+	{
+		this->EnqueueShards[FPlatformTLS::GetCurrentThreadId() % NumShards].Value.fetch_add(1, std::memory_order_relaxed);
+		return Timer::NowNanoseconds();
+	}
+
+	// Consumer side - only for items that went through OnEnqueue, EnqueueNanoseconds is its timestamp
+	void OnDequeue(uint64 EnqueueNanoseconds);
+
+	// Builds a snapshot, the rates cover the time since the previous call
+	FQueueMetrics Sample();
+
+	void Reset();
+
+private:
+	int64 GetTotalEnqueued() const;
+	// JustDequeued items are added back to the depth
+	void UpdateHighWaterMark(int64 JustDequeued);
+
+	struct alignas(PLATFORM_CACHE_LINE_SIZE) FShard
+	{
+		std::atomic<int64> Value{ 0 };
+	};
+
+	FShard EnqueueShards[NumShards];
+
+	// consumer side, atomic only so that snapshots from other threads read whole values
+	alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<int64> TotalDequeued{ 0 };
+	std::atomic<int64> HighWaterMark{ 0 };
+	std::atomic<uint64> LatencyTotal{ 0 };
+	std::atomic<uint64> LatencyMax{ 0 };
+	std::atomic<int64> LatencyCount{ 0 };
+
+	// counter values at the last Reset
+	int64 ResetEnqueued = 0;
+	int64 ResetDequeued = 0;
+
+	// previous snapshot for the rates
+	uint64 LastSampleNanoseconds = 0;
+	int64 LastEnqueued = 0;
+	int64 LastDequeued = 0;
+};
@@ -0,0 +1,273 @@
+// Developer Bastian © 2024
+// License Creative Commons DEED 4.0 (https://creativecommons.org/licenses/by-sa/4.0/deed.en)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Algo/BinarySearch.h"
+
+/**
+ * Ordered container built from a list of small sorted chunks.
+ *
+ * Every chunk holds at most MaxChunkSize elements and all elements of a chunk sort before the elements of the next one.
+ * Finding a position is a binary search over the chunks followed by one inside the chunk, so lookups are O(log n).
+ * Inserting or removing only moves elements inside one chunk, a full chunk is split in two.
+ * Compared to one sorted TArray this keeps updates cheap on large data, compared to a tree it keeps elements contiguous.
+ *
+ * PredicateType is a strict weak ordering, e.g. TLess<> or a function pointer like FTSetTestStruct::CompareNumberAscending.
+ */
+template <typename ElementType, typename PredicateType = TLess<ElementType>>
+class TSortedChunkArray
+{
+public:
+	static constexpr int32 MaxChunkSize = 512;
+
+	/**
+	 * Position of one element - chunk and index inside the chunk.
+	 * Positions are invalidated by every insert or remove.
+	 */
+	struct FPosition
+	{
+		int32 Chunk = 0;
+		int32 Index = 0;
+
+		FORCEINLINE bool operator==(const FPosition& Other) const
+		{
+			return Chunk == Other.Chunk && Index == Other.Index;
+		}
+
+		FORCEINLINE bool operator!=(const FPosition& Other) const
+		{
+			return !(*this == Other);
+		}
+	};
+
+	explicit TSortedChunkArray(PredicateType InPredicate = PredicateType())
+		: Predicate(InPredicate)
+	{}
+
+	FORCEINLINE int32 Num() const
+	{
+		return NumElements;
+	}
+
+	void Reset()
+	{
+		Chunks.Empty();
+		NumElements = 0;
+	}
+
+	/**
+	 * Replaces the content with Elements in one step - sorts them once and cuts them into half-full chunks,
+	 * so following inserts do not split right away. Much faster than inserting one by one.
+	 */
+	void Build(TArray<ElementType>&& Elements)
+	{
+		Reset();
+		Elements.Sort(Predicate);
+		constexpr int32 BuildChunkSize = MaxChunkSize / 2;
+		Chunks.Reserve(FMath::DivideAndRoundUp(Elements.Num(), BuildChunkSize));
+		for (int32 Start = 0; Start < Elements.Num(); Start += BuildChunkSize)
+		{
+			const int32 Count = FMath::Min(BuildChunkSize, Elements.Num() - Start);
+			TArray<ElementType>& Chunk = Chunks.AddDefaulted_GetRef();
+			Chunk.Reserve(MaxChunkSize);
+			for (int32 i = 0; i < Count; ++i)
+			{
+				Chunk.Add(MoveTemp(Elements[Start + i]));
+			}
+		}
+		NumElements = Elements.Num();
+		Elements.Reset();
+	}
+
+	/**
+	 * Inserts Element behind all equivalent elements.
+	 * With bAllowDuplicates false nothing is inserted if an equivalent element exists.
+	 * @returns true if the element was inserted
+	 */
+	bool Insert(const ElementType& Element, bool bAllowDuplicates = true)
+	{
+		if (Chunks.Num() == 0)
+		{
+			TArray<ElementType>& Chunk = Chunks.AddDefaulted_GetRef();
+			Chunk.Reserve(MaxChunkSize);
+			Chunk.Add(Element);
+			NumElements = 1;
+			return true;
+		}
+		const FPosition Position = UpperBound(Element);
+		if (!bAllowDuplicates)
+		{
+			const FPosition Previous = Prev(Position);
+			if (Previous != Position && !Predicate(Get(Previous), Element))
+				return false;
+		}
+		// UpperBound returns End() for the largest elements - append those to the last chunk
+		const int32 ChunkIndex = Position.Chunk < Chunks.Num() ? Position.Chunk : Chunks.Num() - 1;
+		const int32 Index = Position.Chunk < Chunks.Num() ? Position.Index : Chunks[ChunkIndex].Num();
+		Chunks[ChunkIndex].Insert(Element, Index);
+		++NumElements;
+		if (Chunks[ChunkIndex].Num() > MaxChunkSize)
+		{
+			SplitChunk(ChunkIndex);
+		}
+		return true;
+	}
+
+	/**
+	 * Removes the first element that is equivalent to Element.
+	 * If the ordering is not total (several elements compare equivalent), Matches decides which of them is removed.
+	 * @returns true if an element was removed
+	 */
+	template <typename MatchType>
+	bool Remove(const ElementType& Element, MatchType&& Matches)
+	{
+		for (FPosition Position = LowerBound(Element); Position != End(); Position = Next(Position))
+		{
+			const ElementType& Candidate = Get(Position);
+			if (Predicate(Element, Candidate))
+				return false;
+			if (Matches(Candidate))
+			{
+				RemoveAt(Position);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool Remove(const ElementType& Element)
+	{
+		return Remove(Element, [](const ElementType&) { return true; });
+	}
+
+	void RemoveAt(FPosition Position)
+	{
+		TArray<ElementType>& Chunk = Chunks[Position.Chunk];
+		Chunk.RemoveAt(Position.Index, 1, false);
+		--NumElements;
+		if (Chunk.Num() == 0)
+		{
+			Chunks.RemoveAt(Position.Chunk);
+		}
+	}
+
+	// Position of the first element that is not less than Key
+	FPosition LowerBound(const ElementType& Key) const
+	{
+		const int32 ChunkIndex = Algo::LowerBoundBy(Chunks, Key, [](const TArray<ElementType>& Chunk) -> const ElementType&
+		{
+			return Chunk.Last();
+		}, Predicate);
+		if (ChunkIndex == Chunks.Num())
+			return End();
+		return { ChunkIndex, (int32)Algo::LowerBound(Chunks[ChunkIndex], Key, Predicate) };
+	}
+
+	// Position of the first element that is greater than Key
+	FPosition UpperBound(const ElementType& Key) const
+	{
+		const int32 ChunkIndex = Algo::UpperBoundBy(Chunks, Key, [](const TArray<ElementType>& Chunk) -> const ElementType&
+		{
+			return Chunk.Last();
+		}, Predicate);
+		if (ChunkIndex == Chunks.Num())
+			return End();
+		return { ChunkIndex, (int32)Algo::UpperBound(Chunks[ChunkIndex], Key, Predicate) };
+	}
+
+	FORCEINLINE FPosition Begin() const
+	{
+		return { 0, 0 };
+	}
+
+	FORCEINLINE FPosition End() const
+	{
+		return { Chunks.Num(), 0 };
+	}
+
+	FORCEINLINE FPosition Next(FPosition Position) const
+	{
+		if (++Position.Index >= Chunks[Position.Chunk].Num())
+		{
+			++Position.Chunk;
+			Position.Index = 0;
+		}
+		return Position;
+	}
+
+	// Position before the given one, or the given one if it is Begin()
+	FORCEINLINE FPosition Prev(FPosition Position) const
+	{
+		if (Position.Index > 0)
+		{
+			--Position.Index;
+		}
+		else if (Position.Chunk > 0)
+		{
+			--Position.Chunk;
+			Position.Index = Chunks[Position.Chunk].Num() - 1;
+		}
+		return Position;
+	}
+
+	FORCEINLINE const ElementType& Get(FPosition Position) const
+	{
+		return Chunks[Position.Chunk][Position.Index];
+	}
+
+	// Calls Visitor for every element in [First, Last), chunk by chunk
+	template <typename VisitorType>
+	void ForEachInRange(FPosition First, FPosition Last, VisitorType&& Visitor) const
+	{
+		for (int32 ChunkIndex = First.Chunk; ChunkIndex <= Last.Chunk && ChunkIndex < Chunks.Num(); ++ChunkIndex)
+		{
+			const TArray<ElementType>& Chunk = Chunks[ChunkIndex];
+			const int32 Start = ChunkIndex == First.Chunk ? First.Index : 0;
+			const int32 Stop = ChunkIndex == Last.Chunk ? Last.Index : Chunk.Num();
+			for (int32 i = Start; i < Stop; ++i)
+			{
+				Visitor(Chunk[i]);
+			}
+		}
+	}
+
+	template <typename VisitorType>
+	void ForEach(VisitorType&& Visitor) const
+	{
+		ForEachInRange(Begin(), End(), Forward<VisitorType>(Visitor));
+	}
+
+	// Number of elements in [First, Last), O(number of chunks in between)
+	int32 CountInRange(FPosition First, FPosition Last) const
+	{
+		if (First.Chunk == Last.Chunk)
+			return Last.Index - First.Index;
+		int32 Count = Chunks[First.Chunk].Num() - First.Index;
+		for (int32 ChunkIndex = First.Chunk + 1; ChunkIndex < Last.Chunk; ++ChunkIndex)
+		{
+			Count += Chunks[ChunkIndex].Num();
+		}
+		return Count + Last.Index;
+	}
+
+private:
+	void SplitChunk(int32 ChunkIndex)
+	{
+		const int32 Half = Chunks[ChunkIndex].Num() / 2;
+		TArray<ElementType> Upper;
+		Upper.Reserve(MaxChunkSize);
+		TArray<ElementType>& Lower = Chunks[ChunkIndex];
+		for (int32 i = Half; i < Lower.Num(); ++i)
+		{
+			Upper.Add(MoveTemp(Lower[i]));
+		}
+		Lower.RemoveAt(Half, Lower.Num() - Half, false);
+		Chunks.Insert(MoveTemp(Upper), ChunkIndex + 1);
+	}
+
+	TArray<TArray<ElementType>> Chunks;
+	int32 NumElements = 0;
+	PredicateType Predicate;
+};
@@ -8,9 +8,18 @@
 #include "UObject/NoExportTypes.h"
 #include "Templates/SharedPointer.h"
 #include "Containers/Array.h"
+#include "Algo/Unique.h"
 #include "Runtime/Core/Public/Async/ParallelFor.h"
+#include "Async/TaskGraphInterfaces.h"
 #include "Misc/Guid.h"
 #include "Timer.h"
+#include "ContainerProfiler.h"
+#include "NamePrefixIndex.h"
+#include "ContainerSort.h"
+#include "ContainerFilterKernels.h"
+#include "ContainerChangeBatch.h"
+#include "ContainerBloomFilter.h"
+#include "ContainerStringTransform.h"
 #include "TArray.generated.h"
 
 
@@ -83,6 +92,43 @@ public:
 #pragma endregion Mandatory Functions
 };
 
+/**
+ * Timing of a serial and a parallel pass over the same array, to show how the parallel path scales.
+ */
+USTRUCT(BlueprintType)
+struct FArrayIterationReport
+{
+public:
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Array Iteration Report")
+	int32 Elements;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Array Iteration Report")
+	int32 BatchSize;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Array Iteration Report")
+	int32 Chunks;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Array Iteration Report")
+	int32 Workers;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Array Iteration Report")
+	float SerialMicroseconds;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Array Iteration Report")
+	float ParallelMicroseconds;
+
+	// SerialMicroseconds / ParallelMicroseconds - values above 1 mean the parallel path was faster
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Array Iteration Report")
+	float Speedup;
+
+	FArrayIterationReport() : Elements(0), BatchSize(0), Chunks(0), Workers(0)
+		, SerialMicroseconds(0.f), ParallelMicroseconds(0.f), Speedup(0.f)
+	{
+	}
+};
+
 /**
  * Delegates to indicate queue changes
  */
@@ -116,11 +162,24 @@ public:
 		, meta = (ToolTip = "Delegate to indicate remove event from array"))
 	FOnArrayChanged OnArrayRemove_Delegate;
 
+	UPROPERTY(BlueprintAssignable, Category = "BA Container - Array"
+		, meta = (ToolTip = "Delegate with all changes of the last frame, only fired in batched notify mode"))
+	FOnContainerChangesFlushed OnArrayChangesFlushed_Delegate;
+
 #pragma endregion Delegates
 
 private:
 	TArray<FTArrayTestStruct> BA_Array;
 
+	// lower-cased names with their array index, built on the first prefix query
+	TNamePrefixIndex<int32> NameIndex;
+
+	// pending changes while in batched notify mode
+	FContainerChangeBatcher ChangeBatcher;
+
+	// optional filter on the Numbers in front of Array_Contains
+	FContainerBloomFilter BloomFilter;
+
 public:
 	#pragma region Public Functions
 
@@ -130,13 +189,15 @@ public:
 			, ToolTip = "Add an item to the Array"))
 	FORCEINLINE void Array_Add(UPARAM(ref) FTArrayTestStruct& Value, bool Broadcast)
 	{
+		BA_CONTAINER_SCOPE("UTArray::Array_Add");
 		// Emplace avoids creating a temporary variable, 
 		// which is often undesirable for non-trivial value types.
 		// As a rule of thumb, use Add for trivial types and Emplace otherwise. 
 		// Emplace will never be less efficient than Add.
-		this->BA_Array.Emplace(Value);
-		if (Broadcast)
-			this->OnArrayAdd_Delegate.Broadcast(true);
+		const int32 Index = this->BA_Array.Emplace(Value);
+		this->NameIndex.Add(Value.Name, Index);
+		this->BloomFilter.Add(FContainerBloomFilter::Hash(Value.Number));
+		Array_NotifyAdded(Index, 1, Broadcast);
 	}
 
 	UFUNCTION(BlueprintCallable, Category = "BA Container - Array"
@@ -144,11 +205,13 @@ public:
 			, ToolTip = "Add an item to the Array"))
 	FORCEINLINE void Array_AddMoveTemp(UPARAM(ref) FTArrayTestStruct& Value, bool Broadcast)
 	{
+		BA_CONTAINER_SCOPE("UTArray::Array_AddMoveTemp");
 		// MoveTemp will cast a reference to an rvalue reference. 
 		// It essentially just shifts points instead of doing a Value copy to a new address.
-		this->BA_Array.Add(MoveTemp(Value));
-		if (Broadcast)
-			this->OnArrayAdd_Delegate.Broadcast(true);
+		const int32 Index = this->BA_Array.Add(MoveTemp(Value));
+		this->NameIndex.Add(this->BA_Array[Index].Name, Index);
+		this->BloomFilter.Add(FContainerBloomFilter::Hash(this->BA_Array[Index].Number));
+		Array_NotifyAdded(Index, 1, Broadcast);
 	}
 
 	UFUNCTION(BlueprintCallable, Category = "BA Container - Array"
@@ -156,10 +219,13 @@ public:
 			, ToolTip = "Add an item to the end of the Array. Wil use MoveTemp if possible"))
 	FORCEINLINE void Array_Push(UPARAM(ref) FTArrayTestStruct& Value, bool Broadcast)
 	{
-		if (Broadcast)
-			this->OnArrayAdd_Delegate.Broadcast(true);
+		BA_CONTAINER_SCOPE("UTArray::Array_Push");
+		const int32 Index = this->BA_Array.Num();
+		this->NameIndex.Add(Value.Name, Index);
+		this->BloomFilter.Add(FContainerBloomFilter::Hash(Value.Number));
 		// tries to use MoveTemp internally. 
 		this->BA_Array.Push(Value);
+		Array_NotifyAdded(Index, 1, Broadcast);
 	}
 
 	UFUNCTION(BlueprintCallable, Category = "BA Container - Array"
@@ -167,13 +233,28 @@ public:
 			, ToolTip = "Add an item to the Array while checking uniqueness"))
 	FORCEINLINE void Array_AddUnique(UPARAM(ref) FTArrayTestStruct& Value, bool Broadcast)
 	{
+		BA_CONTAINER_SCOPE("UTArray::Array_AddUnique");
 		// AddUnique only adds a new element to the container if an equivalent element doesn't already exist. 
 		// Equivalence is checked by using the element type's operator==:
 		// 
 		// AddUnique will have to parse the entire array checking for duplicates!
-		this->BA_Array.AddUnique(Value);
-		if (Broadcast)
-			this->OnArrayAdd_Delegate.Broadcast(true);
+		const int32 Num = this->BA_Array.Num();
+		const bool bAdded = this->BA_Array.AddUnique(Value) == Num;
+		if (bAdded)
+		{
+			this->NameIndex.Add(Value.Name, Num);
+			this->BloomFilter.Add(FContainerBloomFilter::Hash(Value.Number));
+		}
+		Array_NotifyAdded(Num, bAdded ? 1 : 0, Broadcast);
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Array"
+		, meta = (CompactNodeTitle = "Add - Batch"
+			, ToolTip = "Moves all Values to the end of the Array with one allocation and one notification. Values is empty afterwards"))
+	FORCEINLINE void Array_AddBatch(UPARAM(ref) TArray<FTArrayTestStruct>& Values, bool Broadcast)
+	{
+		BA_CONTAINER_SCOPE("UTArray::Array_AddBatch");
+		Array_AppendMoved(MoveTemp(Values), Broadcast);
 	}
 
 	UFUNCTION(BlueprintCallable, Category = "BA Container - Array"
@@ -181,9 +262,40 @@ public:
 			, ToolTip = "Insert an item to the Array into a given index. Will preserve order"))
 	FORCEINLINE void Array_InsertAt(UPARAM(ref) FTArrayTestStruct& Value, int32 Position, bool Broadcast)
 	{
+		BA_CONTAINER_SCOPE("UTArray::Array_InsertAt");
+		// inserting in the middle shifts every index behind it up by one
+		if (Position < this->BA_Array.Num())
+			this->NameIndex.RemapIds([Position](int32 Index) { return Index >= Position ? Index + 1 : Index; });
+		this->NameIndex.Add(Value.Name, Position);
 		this->BA_Array.Insert(Value, Position);
-		if (Broadcast)
-			this->OnArrayAdd_Delegate.Broadcast(true);
+		this->BloomFilter.Add(FContainerBloomFilter::Hash(Value.Number));
+		Array_NotifyAdded(Position, 1, Broadcast);
+	}
+
+	/**
+	 * Moves all Values to the end of the array in one step, Values is empty afterwards.
+	 * An empty array adopts the buffer of Values without touching a single element.
+	 * Native only - used by the bulk loaders, so there is just one broadcast for all rows.
+	 */
+	void Array_AppendMoved(TArray<FTArrayTestStruct>&& Values, bool Broadcast)
+	{
+		BA_CONTAINER_SCOPE("UTArray::Array_AppendMoved");
+		const int32 First = this->BA_Array.Num();
+		if (First == 0)
+			this->BA_Array = MoveTemp(Values);
+		else
+			this->BA_Array.Append(MoveTemp(Values));
+		// a batch larger than the array is cheaper to index with the next rebuild
+		if (this->BA_Array.Num() - First > First)
+			this->NameIndex.Invalidate();
+		else if (this->NameIndex.IsValid())
+			Array_IndexNames(First);
+		if (this->BloomFilter.IsEnabled())
+		{
+			for (int32 Index = First; Index < this->BA_Array.Num(); ++Index)
+				this->BloomFilter.Add(FContainerBloomFilter::Hash(this->BA_Array[Index].Number));
+		}
+		Array_NotifyAdded(First, this->BA_Array.Num() - First, Broadcast);
 	}
 
 #pragma endregion Adding Elements
@@ -194,9 +306,19 @@ public:
 			, ToolTip = "Removes an item from the array"))
 	FORCEINLINE void Array_Remove(UPARAM(ref) FTArrayTestStruct& Value, bool Broadcast)
 	{
-		this->BA_Array.Remove(Value);
-		if (Broadcast)
-			this->OnArrayRemove_Delegate.Broadcast(true);
+		BA_CONTAINER_SCOPE("UTArray::Array_Remove");
+		TArray<int32> Positions;
+		for (int32 i = 0; i < this->BA_Array.Num(); ++i)
+		{
+			if (this->BA_Array[i] == Value)
+				Positions.Add(i);
+		}
+		if (Positions.Num() > 0)
+		{
+			Array_RemoveSortedPositionsIndexed(Positions);
+			this->BloomFilter.Remove(Positions.Num());
+		}
+		Array_NotifyRemoved(Positions, Positions.Num(), Broadcast);
 	}
 
 	UFUNCTION(BlueprintCallable, Category = "BA Container - Array"
@@ -204,11 +326,16 @@ public:
 			, ToolTip = "Removes an item from the array on a given position. Will return true on successful removal, or false if position is not valid"))
 	FORCEINLINE bool Array_RemoveAt(int32 Position, bool Broadcast)
 	{
+		BA_CONTAINER_SCOPE("UTArray::Array_RemoveAt");
 		if (this->BA_Array.IsValidIndex(Position))
 		{
+			this->NameIndex.Remove(this->BA_Array[Position].Name, Position);
+			// every index behind Position moves down by one
+			if (Position < this->BA_Array.Num() - 1)
+				this->NameIndex.RemapIds([Position](int32 Index) { return Index > Position ? Index - 1 : Index; });
 			this->BA_Array.RemoveAt(Position);
-			if (Broadcast)
-				this->OnArrayRemove_Delegate.Broadcast(true);
+			this->BloomFilter.Remove();
+			Array_NotifyRemoved(MakeArrayView(&Position, 1), 1, Broadcast);
 			return true;
 		}
 		else
@@ -220,6 +347,12 @@ public:
 			, ToolTip = "Removes first item from array. If this is standard access pattern, think about using a queue"))
 	FORCEINLINE FTArrayTestStruct Array_Pop(int32 Position, bool Broadcast)
 	{
+		BA_CONTAINER_SCOPE("UTArray::Array_Pop");
+		if (this->BA_Array.Num() > 0)
+		{
+			this->NameIndex.Remove(this->BA_Array.Last().Name, this->BA_Array.Num() - 1);
+			this->BloomFilter.Remove();
+		}
 		return this->BA_Array.Pop(true);
 	}
 
@@ -228,14 +361,38 @@ public:
 			, ToolTip = "Removes all elements that match a defined predicate"))
 	FORCEINLINE void Array_RemoveAllStartingWith(FString StartsWith, bool Broadcast)
 	{
-		// Example for using a predicate to filter all items matching the predicate condition
-		this->BA_Array.RemoveAll(
-			[StartsWith](const FTArrayTestStruct& A) {
-				return A.Name.StartsWith(StartsWith, ESearchCase::IgnoreCase);
-			}
-		);
-		if (Broadcast)
-			this->OnArrayRemove_Delegate.Broadcast(true);
+		BA_CONTAINER_SCOPE("UTArray::Array_RemoveAllStartingWith");
+		// the name index hands out the matching positions, so only the part of the array behind the first match is moved
+		Array_EnsureNameIndex();
+		TArray<int32> Removed;
+		this->NameIndex.RemovePrefix(StartsWith, Removed);
+		if (Removed.Num() > 0)
+		{
+			this->BloomFilter.Remove(Removed.Num());
+			Removed.Sort();
+			Array_RemoveSortedPositions(Removed);
+			Array_RemapNameIndex(Removed);
+		}
+		Array_NotifyRemoved(Removed, Removed.Num(), Broadcast);
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Array"
+		, meta = (CompactNodeTitle = "Remove At - Batch"
+			, ToolTip = "Removes the items on all given positions in one pass and keeps the order of the rest. Invalid and duplicate positions are ignored. Returns the number of removed items"))
+	FORCEINLINE int32 Array_RemoveAtBatch(TArray<int32> Positions, bool Broadcast)
+	{
+		BA_CONTAINER_SCOPE("UTArray::Array_RemoveAtBatch");
+		const int32 Num = this->BA_Array.Num();
+		Positions.RemoveAllSwap([Num](int32 Position) { return Position < 0 || Position >= Num; }, false);
+		if (Positions.Num() == 0)
+			return 0;
+		Positions.Sort();
+		// sorted, so duplicates are neighbours
+		Positions.SetNum(Algo::Unique(Positions), false);
+		Array_RemoveSortedPositionsIndexed(Positions);
+		this->BloomFilter.Remove(Positions.Num());
+		Array_NotifyRemoved(Positions, Positions.Num(), Broadcast);
+		return Positions.Num();
 	}
 
 	UFUNCTION(BlueprintCallable, Category = "BA Container - Array"
@@ -243,9 +400,12 @@ public:
 			, ToolTip = "Empties the array - set NewCapacity to zero if you dont need to reserve space for new content, otherwise provide the expected capacity"))
 	FORCEINLINE void Array_Empty(int32 NewCapacity, bool Broadcast)
 	{
+		BA_CONTAINER_SCOPE("UTArray::Array_Empty");
+		const int32 NumRemoved = this->BA_Array.Num();
 		this->BA_Array.Empty(NewCapacity);
-		if (Broadcast)
-			this->OnArrayRemove_Delegate.Broadcast(true);
+		this->NameIndex.Reset();
+		this->BloomFilter.Invalidate();
+		Array_NotifyRemoved({}, NumRemoved, Broadcast);
 	}
 #pragma endregion Removing Elements
 	
@@ -255,6 +415,7 @@ public:
 			, ToolTip = "Returns the number of values within this Array"))
 	FORCEINLINE int32 Array_NumberOfValues()
 	{
+		BA_CONTAINER_SCOPE("UTArray::Array_NumberOfValues");
 		return this->BA_Array.Num();
 	}
 	
@@ -263,6 +424,16 @@ public:
 			, ToolTip = "Check if a given value exists"))
 	FORCEINLINE bool Array_Contains(UPARAM(ref) FTArrayTestStruct& Value)
 	{
+		BA_CONTAINER_SCOPE("UTArray::Array_Contains");
+		if (this->BloomFilter.IsEnabled())
+		{
+			Array_EnsureBloomFilter();
+			if (this->BloomFilter.Rejects(FContainerBloomFilter::Hash(Value.Number)))
+				return false;
+			const bool bFound = this->BA_Array.Contains(Value);
+			this->BloomFilter.RecordLookup(bFound);
+			return bFound;
+		}
 		return this->BA_Array.Contains(Value);
 	}
 
@@ -270,15 +441,42 @@ public:
 		, meta = (CompactNodeTitle = "Values"
 			, ToolTip = "Returns all array values"))
 	FORCEINLINE TArray<FTArrayTestStruct> Array_Values()
+	{
+		BA_CONTAINER_SCOPE("UTArray::Array_Values");
+		return this->BA_Array;
+	}
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "BA Container - Array"
+		, meta = (CompactNodeTitle = "Values Page"
+			, ToolTip = "Returns up to Count values starting at Offset. Use with No of values to page through large arrays without copying all of them"))
+	FORCEINLINE TArray<FTArrayTestStruct> Array_GetValuesPage(int32 Offset, int32 Count)
+	{
+		BA_CONTAINER_SCOPE("UTArray::Array_GetValuesPage");
+		const int32 First = FMath::Clamp(Offset, 0, this->BA_Array.Num());
+		// clamped before adding, Offset + Count can overflow
+		const int32 Last = First + FMath::Min(FMath::Max(Count, 0), this->BA_Array.Num() - First);
+		return TArray<FTArrayTestStruct>(this->BA_Array.GetData() + First, Last - First);
+	}
+
+	// Read-only view of the stored values, valid until the array is changed
+	FORCEINLINE TConstArrayView<FTArrayTestStruct> Array_View() const
 	{
 		return this->BA_Array;
 	}
 
+	// Calls Visitor(const FTArrayTestStruct&) for every value, in order, without copying
+	template <typename VisitorType>
+	void Array_ForEach(VisitorType&& Visitor) const
+	{
+		for (const FTArrayTestStruct& Value : this->BA_Array)
+			Visitor(Value);
+	}
+
 	#pragma region Searching
 
 	/**
-	 * Example of a Filter Function
-	 * Add your custom filter criteria in lambda function within FilterByPredicate
+	 * Example of a prefix search
+	 * Served by the name index, so the cost depends on the prefix and the number of matches, not on the array size
 	 *
 	 * @StartsWith String that the Values needs to start with
 	 * @returns TArray<FTArrayTestStruct>
@@ -288,11 +486,59 @@ public:
 			, ToolTip = "Returns all items with name starting like parameter given"))
 	FORCEINLINE TArray<FTArrayTestStruct> Array_GetNamesStartingWith(const FString& StartsWith)
 	{
-		return this->BA_Array.FilterByPredicate(
-			[StartsWith](const FTArrayTestStruct& A) {
-				return A.Name.StartsWith(StartsWith, ESearchCase::IgnoreCase);
-			}
-		);
+		BA_CONTAINER_SCOPE("UTArray::Array_GetNamesStartingWith");
+		Array_EnsureNameIndex();
+		TArray<int32> Found;
+		this->NameIndex.ForEachWithPrefix(StartsWith, [&Found](int32 Index)
+		{
+			Found.Add(Index);
+		});
+		// results keep the array order, like a filter would
+		Found.Sort();
+		TArray<FTArrayTestStruct> Result;
+		Result.Reserve(Found.Num());
+		for (int32 Index : Found)
+		{
+			Result.Add(this->BA_Array[Index]);
+		}
+		return Result;
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Array"
+		, meta = (CompactNodeTitle = "Filter Numbers"
+			, ToolTip = "Returns all items with Number between Min and Max (both included), matched 64 at a time by the vectorized filter kernels"))
+	FORCEINLINE TArray<FTArrayTestStruct> Array_FilterByNumber(int32 Min, int32 Max)
+	{
+		BA_CONTAINER_SCOPE("UTArray::Array_FilterByNumber");
+		const TArray<int32> Found = Array_SelectIndices(FContainerFilterPredicate::Between(Min, Max));
+		TArray<FTArrayTestStruct> Result;
+		Result.Reserve(Found.Num());
+		for (int32 Index : Found)
+		{
+			Result.Add(this->BA_Array[Index]);
+		}
+		return Result;
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Array"
+		, meta = (CompactNodeTitle = "Indices Above"
+			, ToolTip = "Returns the positions of all items with Number larger than the parameter"))
+	FORCEINLINE TArray<int32> Array_GetIndicesWithNumberAbove(int32 Number)
+	{
+		BA_CONTAINER_SCOPE("UTArray::Array_GetIndicesWithNumberAbove");
+		return Array_SelectIndices(FContainerFilterPredicate::Greater(Number));
+	}
+
+	/**
+	 * Positions of all elements whose Number matches Predicate, ascending.
+	 * The kernels gather Number out of the structs in blocks of 64 and compare each block with SIMD.
+	 */
+	TArray<int32> Array_SelectIndices(const FContainerFilterPredicate& Predicate) const
+	{
+		TArray<int32> Found;
+		if (this->BA_Array.Num() > 0)
+			FContainerFilterKernels::SelectIndices(&this->BA_Array.GetData()->Number, this->BA_Array.Num(), sizeof(FTArrayTestStruct), Predicate, Found);
+		return Found;
 	}
 
 #pragma endregion Searching
@@ -300,15 +546,28 @@ public:
 	#pragma region Sorting
 	UFUNCTION(BlueprintCallable, Category = "BA Container - Array"
 		, meta = (CompactNodeTitle = "Sort Array"
-			, ToolTip = "Sort the Values as FTArrayTestStruct by Enum ETestArraySorting"))
-	FORCEINLINE void Array_Sort(ETestArraySorting Sort)
+			, ToolTip = "Sort the Values as FTArrayTestStruct by Enum ETestArraySorting. The parallel backend radix sorts numbers and merge sorts names on all cores"))
+	FORCEINLINE void Array_Sort(ETestArraySorting Sort, EContainerSortBackend Backend = EContainerSortBackend::E_Default)
 	{
+		BA_CONTAINER_SCOPE("UTArray::Array_Sort");
 		// Sorting with Lambda
 		//this->BA_Array.Sort([](const FTArrayTestStruct& A, const FTArrayTestStruct& B) {
 		//	return A.Number > B.Number;
 		//	}
 		//);
 		
+		this->NameIndex.Invalidate();
+		if (Backend == EContainerSortBackend::E_Parallel)
+		{
+			TArray<int32> Order;
+			const bool bDescending = Sort == ETestArraySorting::E_NumberDesc || Sort == ETestArraySorting::E_NameDesc;
+			if (Sort == ETestArraySorting::E_NameAsc || Sort == ETestArraySorting::E_NameDesc)
+				FContainerSort::NameOrder(this->BA_Array, [](const FTArrayTestStruct& Value) -> const FString& { return Value.Name; }, bDescending, Order);
+			else
+				FContainerSort::NumberOrder(this->BA_Array, [](const FTArrayTestStruct& Value) { return Value.Number; }, bDescending, Order);
+			FContainerSort::ApplyOrder(this->BA_Array, Order);
+			return;
+		}
 		// Better to make the search logic part of your Struct class and reference this:
 		switch (Sort)
 		{
@@ -335,36 +594,282 @@ public:
 			, ToolTip = "Example to iterate over array, adding a prefix to all Struct.Names"))
 	FORCEINLINE float Array_Iterate(UPARAM(ref) FString& Prefix)
 	{
+		BA_CONTAINER_SCOPE("UTArray::Array_Iterate");
 		// for demonstration, we set a timer and report total time needed for operation
 		Timer t;
 		t.Start();
-		for (FTArrayTestStruct& Value : BA_Array)
-		{
-			Value.Name.InsertAt(0, Prefix);
-		}
+		this->NameIndex.Invalidate();
+		// every name is allocated once at its final size, instead of InsertAt moving it behind the prefix
+		FTArrayTestStruct* Data = this->BA_Array.GetData();
+		FContainerStringTransform(EContainerStringTransform::E_Prefix, Prefix).ApplyAll(this->BA_Array.Num()
+			, [Data](int32 i) -> FString& { return Data[i].Name; }, 0, false);
 		return t.Stop();
 	}
 
 	UFUNCTION(BlueprintCallable, Category = "BA Container - Array"
 		, meta = (CompactNodeTitle = "Parallel Iterate Array"
-			, ToolTip = "Example to parallel-foreach iterate over array, adding a prefix to all Struct.Names"))
-	FORCEINLINE float Array_IterateParallel(UPARAM(ref) FString& Prefix)
+			, ToolTip = "Example to parallel-foreach iterate over array, adding a prefix to all Struct.Names. BatchSize is the number of elements per worker chunk, 0 picks one automatically"))
+	FORCEINLINE float Array_IterateParallel(UPARAM(ref) FString& Prefix, int32 BatchSize = 0)
 	{
+		BA_CONTAINER_SCOPE("UTArray::Array_IterateParallel");
 		// for demonstration, we set a timer and report total time needed for operation
 		Timer t;
 		t.Start();
-		FCriticalSection Mutex;
-		ParallelFor(BA_Array.Num(), [&, Prefix](int32 i)
-		{
-			FScopeLock Lock(&Mutex);
-			// whatever logic you need to do with this element
-			BA_Array[i].Name.InsertAt(0, Prefix);
-		});
+		this->NameIndex.Invalidate();
+		// the transform holds its own copy of the prefix, every worker reads the same one
+		// every element is only touched by the chunk that owns it, so no lock is needed
+		FTArrayTestStruct* Data = this->BA_Array.GetData();
+		FContainerStringTransform(EContainerStringTransform::E_Prefix, Prefix).ApplyAll(this->BA_Array.Num()
+			, [Data](int32 i) -> FString& { return Data[i].Name; }, Array_ResolveBatchSize(this->BA_Array.Num(), BatchSize));
 		return t.Stop();
 	}
 
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Array"
+		, meta = (CompactNodeTitle = "Transform Names"
+			, ToolTip = "Adds a prefix or suffix to all names, or replaces Text with Replacement in them (case sensitive), on worker threads. Every name is allocated once at its final size. SkipIfPresent leaves names that already have the prefix or suffix alone. Returns the number of changed names"))
+	FORCEINLINE int32 Array_TransformNames(EContainerStringTransform Transform, const FString& Text, const FString& Replacement, bool SkipIfPresent, int32 BatchSize = 0)
+	{
+		BA_CONTAINER_SCOPE("UTArray::Array_TransformNames");
+		this->NameIndex.Invalidate();
+		FTArrayTestStruct* Data = this->BA_Array.GetData();
+		return FContainerStringTransform(Transform, Text, Replacement, SkipIfPresent).ApplyAll(this->BA_Array.Num()
+			, [Data](int32 i) -> FString& { return Data[i].Name; }, Array_ResolveBatchSize(this->BA_Array.Num(), BatchSize));
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Array"
+		, meta = (CompactNodeTitle = "Compare Iterate"
+			, ToolTip = "Runs the serial and the parallel iteration example once each and reports timing and speedup. The names are restored after each pass, the array is left unchanged"))
+	FORCEINLINE FArrayIterationReport Array_CompareIterate(UPARAM(ref) FString& Prefix, int32 BatchSize = 0)
+	{
+		BA_CONTAINER_SCOPE("UTArray::Array_CompareIterate");
+		FArrayIterationReport Report;
+		Report.Elements = this->BA_Array.Num();
+		Report.BatchSize = Array_ResolveBatchSize(Report.Elements, BatchSize);
+		Report.Chunks = Report.Elements > 0 ? FMath::DivideAndRoundUp(Report.Elements, Report.BatchSize) : 0;
+		Report.Workers = FMath::Min(Report.Chunks, FTaskGraphInterface::Get().GetNumWorkerThreads() + 1);
+		// both passes rename in place, each one starts from and leaves behind the original names
+		TArray<FString> Names;
+		Names.Reserve(Report.Elements);
+		for (const FTArrayTestStruct& Element : this->BA_Array)
+			Names.Add(Element.Name);
+		Report.SerialMicroseconds = Array_Iterate(Prefix);
+		for (int32 i = 0; i < Report.Elements; ++i)
+			this->BA_Array[i].Name = Names[i];
+		Report.ParallelMicroseconds = Array_IterateParallel(Prefix, BatchSize);
+		for (int32 i = 0; i < Report.Elements; ++i)
+			this->BA_Array[i].Name = MoveTemp(Names[i]);
+		this->NameIndex.Invalidate();
+		Report.Speedup = Report.ParallelMicroseconds > 0.f ? Report.SerialMicroseconds / Report.ParallelMicroseconds : 0.f;
+		return Report;
+	}
+
+	/**
+	 * Runs Operation once for every element, in parallel.
+	 * The array is cut into contiguous chunks of BatchSize elements and each worker takes a whole chunk,
+	 * so neighbouring elements stay on the same core and there is no per-element scheduling.
+	 * No lock is taken: Operation must only modify the element it is given.
+	 *
+	 * @Operation Callable with signature void(FTArrayTestStruct&)
+	 * @BatchSize Number of elements per chunk - 0 or less picks a size from the number of worker threads
+	 * @returns Number of chunks that were processed
+	 */
+	template <typename OperationType>
+	int32 Array_ParallelForEach(OperationType&& Operation, int32 BatchSize = 0)
+	{
+		BA_CONTAINER_SCOPE("UTArray::Array_ParallelForEach");
+		const int32 Num = this->BA_Array.Num();
+		if (Num == 0)
+			return 0;
+		// Operation may rename elements or change their Number
+		this->NameIndex.Invalidate();
+		this->BloomFilter.Invalidate();
+
+		const int32 ChunkSize = Array_ResolveBatchSize(Num, BatchSize);
+		const int32 NumChunks = FMath::DivideAndRoundUp(Num, ChunkSize);
+		FTArrayTestStruct* Data = this->BA_Array.GetData();
+		ParallelFor(NumChunks, [Data, Num, ChunkSize, &Operation](int32 ChunkIndex)
+		{
+			const int32 Start = ChunkIndex * ChunkSize;
+			const int32 End = FMath::Min(Start + ChunkSize, Num);
+			for (int32 i = Start; i < End; ++i)
+			{
+				Operation(Data[i]);
+			}
+		}, NumChunks > 1 ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+		return NumChunks;
+	}
+
+	#pragma region Bloom Filter
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Array"
+		, meta = (CompactNodeTitle = "Set Bloom Filter"
+			, ToolTip = "Puts a Bloom filter on the Numbers in front of Contains, so most checks for absent values skip the linear scan. Sized automatically, costs about 10 bits per value"))
+	FORCEINLINE void Array_SetBloomFilterEnabled(bool Enabled)
+	{
+		this->BloomFilter.SetEnabled(Enabled);
+	}
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "BA Container - Array"
+		, meta = (CompactNodeTitle = "Bloom Filter Stats"
+			, ToolTip = "Returns how many checks the Bloom filter answered and its false positive rate since it was enabled"))
+	FORCEINLINE FContainerBloomFilterStats Array_GetBloomFilterStats()
+	{
+		return this->BloomFilter.GetStats();
+	}
+#pragma endregion Bloom Filter
+
+	#pragma region Notifications
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Array"
+		, meta = (CompactNodeTitle = "Set Notify Mode"
+			, ToolTip = "Immediate fires the add and remove delegates on every change. Batched collects the changed indices and fires OnArrayChangesFlushed once per frame"))
+	FORCEINLINE void Array_SetNotifyMode(EContainerNotifyMode Mode)
+	{
+		// leaving batched mode flushes what was recorded so far
+		this->ChangeBatcher.SetMode(Mode, this, [this]() { Array_FlushNotifications(); });
+	}
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "BA Container - Array"
+		, meta = (CompactNodeTitle = "Notify Mode"
+			, ToolTip = "Returns how changes are reported"))
+	FORCEINLINE EContainerNotifyMode Array_GetNotifyMode()
+	{
+		return this->ChangeBatcher.GetMode();
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Array"
+		, meta = (CompactNodeTitle = "Flush Notifications"
+			, ToolTip = "Fires OnArrayChangesFlushed with the changes collected so far instead of waiting for the next frame"))
+	FORCEINLINE void Array_FlushNotifications()
+	{
+		FContainerChangeBatch Batch;
+		if (this->ChangeBatcher.TakePending(Batch))
+			this->OnArrayChangesFlushed_Delegate.Broadcast(Batch);
+	}
+#pragma endregion Notifications
+
 #pragma endregion Public Functions
 
+private:
+	/**
+	 * Picks the chunk size for parallel iteration.
+	 * Without an explicit size we aim for about four chunks per worker, which keeps all workers busy
+	 * even if some chunks are slower, but never go below 256 elements so the scheduling cost stays small.
+	 */
+	static int32 Array_ResolveBatchSize(int32 Num, int32 BatchSize)
+	{
+		if (BatchSize > 0)
+			return BatchSize;
+		const int32 Workers = FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+		return FMath::Max(256, FMath::DivideAndRoundUp(Num, Workers * 4));
+	}
+
+	// Refills the Bloom filter if it is stale or too full
+	void Array_EnsureBloomFilter()
+	{
+		if (!this->BloomFilter.NeedsRebuild())
+			return;
+		this->BloomFilter.Rebuild(this->BA_Array.Num(), [this](FContainerBloomFilter& Filter)
+		{
+			for (const FTArrayTestStruct& Value : this->BA_Array)
+				Filter.Add(FContainerBloomFilter::Hash(Value.Number));
+		});
+	}
+
+	// Builds the name index if an operation dropped it
+	void Array_EnsureNameIndex()
+	{
+		if (this->NameIndex.IsValid())
+			return;
+		this->NameIndex.Reset(this->BA_Array.Num());
+		Array_IndexNames(0);
+	}
+
+	// Adds the elements from First to the end to the name index
+	void Array_IndexNames(int32 First)
+	{
+		for (int32 i = First; i < this->BA_Array.Num(); ++i)
+		{
+			this->NameIndex.Add(this->BA_Array[i].Name, i);
+		}
+	}
+
+	// Removes the elements on the ascending, unique Positions in one pass, keeping the order of the remaining elements
+	void Array_RemoveSortedPositions(const TArray<int32>& Positions)
+	{
+		int32 Write = Positions[0];
+		int32 NextRemoved = 0;
+		for (int32 Read = Positions[0]; Read < this->BA_Array.Num(); ++Read)
+		{
+			if (NextRemoved < Positions.Num() && Positions[NextRemoved] == Read)
+			{
+				++NextRemoved;
+				continue;
+			}
+			this->BA_Array[Write++] = MoveTemp(this->BA_Array[Read]);
+		}
+		this->BA_Array.RemoveAt(Write, this->BA_Array.Num() - Write, false);
+	}
+
+	// Array_RemoveSortedPositions that also takes the removed elements out of the name index
+	void Array_RemoveSortedPositionsIndexed(const TArray<int32>& Positions)
+	{
+		if (this->NameIndex.IsValid())
+		{
+			for (const int32 Position : Positions)
+				this->NameIndex.Remove(this->BA_Array[Position].Name, Position);
+		}
+		Array_RemoveSortedPositions(Positions);
+		Array_RemapNameIndex(Positions);
+	}
+
+	// Every remaining index moves down by the number of removed elements in front of it
+	void Array_RemapNameIndex(const TArray<int32>& RemovedPositions)
+	{
+		if (!this->NameIndex.IsValid() || RemovedPositions.Num() == 0)
+			return;
+		this->NameIndex.RemapIds([&RemovedPositions](int32 Index)
+		{
+			return Index - (int32)Algo::LowerBound(RemovedPositions, Index);
+		});
+	}
+
+	// Fires OnArrayAdd or, in batched mode, records the positions First to First + Count - 1
+	void Array_NotifyAdded(int32 First, int32 Count, bool Broadcast)
+	{
+		if (!Broadcast)
+			return;
+		if (!this->ChangeBatcher.IsBatched())
+		{
+			this->OnArrayAdd_Delegate.Broadcast(true);
+			return;
+		}
+		if (Count > 0)
+			this->ChangeBatcher.Record([First, Count](FContainerChangeBatch& Batch)
+			{
+				Batch.NumAdded += Count;
+				Batch.AddedIndices.Reserve(Batch.AddedIndices.Num() + Count);
+				for (int32 Index = First; Index < First + Count; ++Index)
+					Batch.AddedIndices.Add(Index);
+			});
+	}
+
+	// Fires OnArrayRemove or, in batched mode, records Count removals - Positions may be empty if they are not known
+	void Array_NotifyRemoved(TConstArrayView<int32> Positions, int32 Count, bool Broadcast)
+	{
+		if (!Broadcast)
+			return;
+		if (!this->ChangeBatcher.IsBatched())
+		{
+			this->OnArrayRemove_Delegate.Broadcast(true);
+			return;
+		}
+		if (Count > 0)
+			this->ChangeBatcher.Record([Positions, Count](FContainerChangeBatch& Batch)
+			{
+				Batch.NumRemoved += Count;
+				Batch.RemovedIndices.Append(Positions.GetData(), Positions.Num());
+			});
+	}
+
 	
 
 };
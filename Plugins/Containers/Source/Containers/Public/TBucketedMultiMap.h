@@ -0,0 +1,433 @@
+// Developer Bastian © 2024
+// License Creative Commons DEED 4.0 (https://creativecommons.org/licenses/by-sa/4.0/deed.en)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "Containers/Map.h"
+#include "Misc/Guid.h"
+#include "TMultiMap.h"
+#include "ContainerProfiler.h"
+#include "ContainerChangeBatch.h"
+
+#include "TBucketedMultiMap.generated.h"
+
+/**
+ * Class with the interface of UTMultiMap, but a different layout:
+ * every key owns one array with all of its values (a bucket) and the total number of values is kept.
+ *
+ * TMultiMap stores one hash entry per key-value pair, so the values of a key are spread over the
+ * hash chain. Here they are contiguous - counting them is O(1), finding them returns a view into
+ * the bucket and exporting all values is one linear pass over the buckets.
+ * In exchange the order of values within a key is insertion order instead of hash order.
+ */
+UCLASS(BlueprintType, Transient)
+class UTBucketedMultiMap : public UObject
+{
+	GENERATED_BODY()
+
+public:
+
+	UTBucketedMultiMap()
+	{}
+
+	~UTBucketedMultiMap()
+	{
+		this->Buckets.Reset();
+	}
+
+	#pragma region Delegates
+
+	UPROPERTY(BlueprintAssignable, Category = "BA Container - Bucketed MultiMap"
+		, meta = (ToolTip = "Delegate to indicate a value was added to a key"))
+	FOnMultiMapChanged OnMultiMapAddKey_Delegate;
+
+	UPROPERTY(BlueprintAssignable, Category = "BA Container - Bucketed MultiMap"
+		, meta = (ToolTip = "Delegate to indicate values were removed from a key"))
+	FOnMultiMapChanged OnMultiMapRemoveFromKey_Delegate;
+
+	UPROPERTY(BlueprintAssignable, Category = "BA Container - Bucketed MultiMap"
+		, meta = (ToolTip = "Delegate with the keys changed during the last frame, only fired in batched notify mode"))
+	FOnContainerChangesFlushed OnMultiMapChangesFlushed_Delegate;
+
+#pragma endregion Delegates
+
+private:
+	TMap<FGuid, TArray<FTMultiMapTestStruct>> Buckets;
+
+	// number of values over all buckets
+	int32 NumValues = 0;
+
+	// pending changes while in batched notify mode
+	FContainerChangeBatcher ChangeBatcher;
+
+public:
+
+	#pragma region Public Functions
+
+	#pragma region Add and Remove
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Bucketed MultiMap"
+		, meta = (CompactNodeTitle = "Add key-value pair"
+			, ToolTip = "Add a key-value association to the multi map."))
+	FORCEINLINE void MM_Add(UPARAM(ref) FGuid& Key, UPARAM(ref) FTMultiMapTestStruct& Value)
+	{
+		BA_CONTAINER_SCOPE("UTBucketedMultiMap::MM_Add");
+		this->Buckets.FindOrAdd(Key).Add(Value);
+		++this->NumValues;
+		if (!this->ChangeBatcher.IsBatched())
+			this->OnMultiMapAddKey_Delegate.Broadcast(Key);
+		else
+			MM_RecordChange(Key, 1, true);
+	}
+
+	/**
+	 * Moves all Values into their buckets, keyed by their Guid, Values is empty afterwards.
+	 * Native only - used by the bulk loaders, no delegate is broadcast.
+	 */
+	void MM_AppendMoved(TArray<FTMultiMapTestStruct>&& Values)
+	{
+		BA_CONTAINER_SCOPE("UTBucketedMultiMap::MM_AppendMoved");
+		for (FTMultiMapTestStruct& Value : Values)
+		{
+			const FGuid Key = Value.Guid;
+			this->Buckets.FindOrAdd(Key).Add(MoveTemp(Value));
+		}
+		this->NumValues += Values.Num();
+		Values.Reset();
+	}
+
+	/**
+	 * Moves all values of one key in a single step - an empty key adopts the array without copying.
+	 * Native only, no delegate is broadcast.
+	 */
+	void MM_AppendBucketMoved(const FGuid& Key, TArray<FTMultiMapTestStruct>&& Values)
+	{
+		if (Values.Num() == 0)
+			return;
+		this->NumValues += Values.Num();
+		TArray<FTMultiMapTestStruct>& Bucket = this->Buckets.FindOrAdd(Key);
+		if (Bucket.Num() == 0)
+			Bucket = MoveTemp(Values);
+		else
+			Bucket.Append(MoveTemp(Values));
+	}
+
+	/**
+	 * Moves whole groups of values, every key once - an empty key adopts the group's array - with
+	 * one notification listing each key once if Broadcast. Groups is empty afterwards. Native only - used by FContainerGroupBy.
+	 */
+	void MM_AddGroupsMoved(TArray<TPair<FGuid, TArray<FTMultiMapTestStruct>>>&& Groups, bool Broadcast)
+	{
+		BA_CONTAINER_SCOPE("UTBucketedMultiMap::MM_AddGroupsMoved");
+		FContainerChangeBatch Changes;
+		this->Buckets.Reserve(this->Buckets.Num() + Groups.Num());
+		if (Broadcast)
+			Changes.AddedKeys.Reserve(Groups.Num());
+		for (TPair<FGuid, TArray<FTMultiMapTestStruct>>& Group : Groups)
+		{
+			Changes.NumAdded += Group.Value.Num();
+			if (Broadcast && Group.Value.Num() > 0)
+				Changes.AddedKeys.Add(Group.Key);
+			MM_AppendBucketMoved(Group.Key, MoveTemp(Group.Value));
+		}
+		Groups.Reset();
+		if (Broadcast && Changes.NumAdded > 0)
+			MM_NotifyBatch(MoveTemp(Changes));
+	}
+
+	/**
+	 * The bulk functions report all keys in one FContainerChangeBatch on OnMultiMapChangesFlushed - right away in
+	 * immediate mode, with the next flush in batched mode - as the add and remove delegates carry only one key.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Bucketed MultiMap"
+		, meta = (CompactNodeTitle = "Add Batch"
+			, ToolTip = "Moves all Values into the multi map, keyed by their Guid, with one notification. Values is empty afterwards"))
+	FORCEINLINE void MM_AddBatch(UPARAM(ref) TArray<FTMultiMapTestStruct>& Values, bool Broadcast)
+	{
+		BA_CONTAINER_SCOPE("UTBucketedMultiMap::MM_AddBatch");
+		FContainerChangeBatch Changes;
+		if (Broadcast)
+		{
+			// the values are moved away, so the keys are taken before
+			Changes.NumAdded = Values.Num();
+			Changes.AddedKeys.Reserve(Values.Num());
+			for (const FTMultiMapTestStruct& Value : Values)
+				Changes.AddedKeys.Add(Value.Guid);
+		}
+		MM_AppendMoved(MoveTemp(Values));
+		if (Broadcast)
+			MM_NotifyBatch(MoveTemp(Changes));
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Bucketed MultiMap"
+		, meta = (CompactNodeTitle = "Remove Batch"
+			, ToolTip = "Removes all values of all Keys with one notification. Returns the number of removed values"))
+	FORCEINLINE int32 MM_RemoveBatch(const TArray<FGuid>& Keys, bool Broadcast)
+	{
+		BA_CONTAINER_SCOPE("UTBucketedMultiMap::MM_RemoveBatch");
+		FContainerChangeBatch Changes;
+		for (const FGuid& Key : Keys)
+		{
+			const int32 NumRemoved = MM_RemoveBucket(Key);
+			if (NumRemoved == 0)
+				continue;
+			Changes.NumRemoved += NumRemoved;
+			if (Broadcast)
+				Changes.RemovedKeys.Add(Key);
+		}
+		const int32 NumRemoved = Changes.NumRemoved;
+		if (Broadcast && NumRemoved > 0)
+			MM_NotifyBatch(MoveTemp(Changes));
+		return NumRemoved;
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Bucketed MultiMap"
+		, meta = (CompactNodeTitle = "Remove All"
+			, ToolTip = "Remove all values of the specified key from the multi map"))
+	FORCEINLINE int32 MM_RemoveAll(UPARAM(ref) FGuid& Key)
+	{
+		BA_CONTAINER_SCOPE("UTBucketedMultiMap::MM_RemoveAll");
+		if (!this->ChangeBatcher.IsBatched())
+			this->OnMultiMapRemoveFromKey_Delegate.Broadcast(Key);
+		const int32 NumRemoved = MM_RemoveBucket(Key);
+		if (this->ChangeBatcher.IsBatched())
+			MM_RecordChange(Key, NumRemoved, false);
+		return NumRemoved;
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Bucketed MultiMap"
+		, meta = (CompactNodeTitle = "Remove First"
+			, ToolTip = "Remove the first association between the specified key and value from the map"))
+	FORCEINLINE int32 MM_RemoveFirst(UPARAM(ref) FGuid& Key, UPARAM(ref) FTMultiMapTestStruct& Value)
+	{
+		BA_CONTAINER_SCOPE("UTBucketedMultiMap::MM_RemoveFirst");
+		if (!this->ChangeBatcher.IsBatched())
+			this->OnMultiMapRemoveFromKey_Delegate.Broadcast(Key);
+		int32 NumRemoved = 0;
+		if (TArray<FTMultiMapTestStruct>* Bucket = this->Buckets.Find(Key))
+		{
+			// keeps the insertion order of the other values
+			NumRemoved = Bucket->RemoveSingle(Value);
+			this->NumValues -= NumRemoved;
+			if (Bucket->Num() == 0)
+				this->Buckets.Remove(Key);
+		}
+		if (this->ChangeBatcher.IsBatched())
+			MM_RecordChange(Key, NumRemoved, false);
+		return NumRemoved;
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Bucketed MultiMap"
+		, meta = (CompactNodeTitle = "Empty"
+			, ToolTip = "Empties the multi map - set NewCapacity to zero if you dont need to reserve space for new content, otherwise provide the expected number of keys"))
+	FORCEINLINE void MM_Empty(int32 NewCapacity)
+	{
+		BA_CONTAINER_SCOPE("UTBucketedMultiMap::MM_Empty");
+		this->Buckets.Empty(NewCapacity);
+		this->NumValues = 0;
+	}
+#pragma endregion Add and Remove
+
+	#pragma region Find and Count
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Bucketed MultiMap"
+		, meta = (CompactNodeTitle = "Number of values"
+			, ToolTip = "Returns the number of values within this multi map associated with the specified key. Constant time"))
+	FORCEINLINE int32 MM_NumberOfValues(UPARAM(ref) FGuid& Key)
+	{
+		BA_CONTAINER_SCOPE("UTBucketedMultiMap::MM_NumberOfValues");
+		const TArray<FTMultiMapTestStruct>* Bucket = this->Buckets.Find(Key);
+		return Bucket != nullptr ? Bucket->Num() : 0;
+	}
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "BA Container - Bucketed MultiMap"
+		, meta = (CompactNodeTitle = "Number of all values"
+			, ToolTip = "Returns the number of key-value pairs of the whole multi map"))
+	FORCEINLINE int32 MM_NumberOfAllValues()
+	{
+		return this->NumValues;
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Bucketed MultiMap"
+		, meta = (CompactNodeTitle = "Multi Find"
+			, ToolTip = "Finds all values associated with the specified key"))
+	FORCEINLINE TArray<FTMultiMapTestStruct> MM_MultiFind(UPARAM(ref) FGuid& Key)
+	{
+		BA_CONTAINER_SCOPE("UTBucketedMultiMap::MM_MultiFind");
+		const TArray<FTMultiMapTestStruct>* Bucket = this->Buckets.Find(Key);
+		return Bucket != nullptr ? *Bucket : TArray<FTMultiMapTestStruct>();
+	}
+
+	// Read-only view of the values of Key in insertion order, valid until the multi map is changed
+	FORCEINLINE TConstArrayView<FTMultiMapTestStruct> MM_MultiFindView(const FGuid& Key) const
+	{
+		const TArray<FTMultiMapTestStruct>* Bucket = this->Buckets.Find(Key);
+		return Bucket != nullptr ? TConstArrayView<FTMultiMapTestStruct>(*Bucket) : TConstArrayView<FTMultiMapTestStruct>();
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Bucketed MultiMap"
+		, meta = (CompactNodeTitle = "KvP Exists"
+			, ToolTip = "Check if a given key-value pair exists"))
+	FORCEINLINE bool MM_KeyValueExist(UPARAM(ref) FGuid& Key, UPARAM(ref) FTMultiMapTestStruct& Value)
+	{
+		BA_CONTAINER_SCOPE("UTBucketedMultiMap::MM_KeyValueExist");
+		const TArray<FTMultiMapTestStruct>* Bucket = this->Buckets.Find(Key);
+		return Bucket != nullptr && Bucket->Contains(Value);
+	}
+#pragma endregion Find and Count
+
+	#pragma region Get Values and Keys
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Bucketed MultiMap"
+		, meta = (CompactNodeTitle = "Get Keys"
+			, ToolTip = "Gets all keys of the multi map"))
+	FORCEINLINE TArray<FGuid> MM_GetKeys()
+	{
+		BA_CONTAINER_SCOPE("UTBucketedMultiMap::MM_GetKeys");
+		TArray<FGuid> keys;
+		this->Buckets.GetKeys(keys);
+		return keys;
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Bucketed MultiMap"
+		, meta = (CompactNodeTitle = "Get All Values"
+			, ToolTip = "Gets all values of the multi map, grouped by key, in one pass"))
+	FORCEINLINE TArray<FTMultiMapTestStruct> MM_GetAllValues()
+	{
+		BA_CONTAINER_SCOPE("UTBucketedMultiMap::MM_GetAllValues");
+		TArray<FTMultiMapTestStruct> values;
+		values.Reserve(this->NumValues);
+		for (const TPair<FGuid, TArray<FTMultiMapTestStruct>>& KvP : this->Buckets)
+			values.Append(KvP.Value);
+		return values;
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Bucketed MultiMap"
+		, meta = (CompactNodeTitle = "Values Page"
+			, ToolTip = "Returns up to Count values starting at Offset, grouped by key. Use with Number of all values to page through large multi maps"))
+	FORCEINLINE TArray<FTMultiMapTestStruct> MM_GetValuesPage(int32 Offset, int32 Count)
+	{
+		BA_CONTAINER_SCOPE("UTBucketedMultiMap::MM_GetValuesPage");
+		TArray<FTMultiMapTestStruct> Page;
+		if (Offset < 0 || Count <= 0 || Offset >= this->NumValues)
+			return Page;
+		Page.Reserve(FMath::Min(Count, this->NumValues - Offset));
+		// whole buckets in front of the page are skipped by their size
+		int32 Position = 0;
+		for (const TPair<FGuid, TArray<FTMultiMapTestStruct>>& KvP : this->Buckets)
+		{
+			const int32 BucketNum = KvP.Value.Num();
+			if (Position + BucketNum > Offset)
+			{
+				const int32 First = FMath::Max(Offset - Position, 0);
+				const int32 Take = FMath::Min(BucketNum - First, Count - Page.Num());
+				Page.Append(KvP.Value.GetData() + First, Take);
+				if (Page.Num() == Count)
+					break;
+			}
+			Position += BucketNum;
+		}
+		return Page;
+	}
+
+	// Read-only access to the buckets, valid until the multi map is changed
+	FORCEINLINE const TMap<FGuid, TArray<FTMultiMapTestStruct>>& MM_View() const
+	{
+		return this->Buckets;
+	}
+
+	// Calls Visitor(const FGuid&, const FTMultiMapTestStruct&) for every pair, grouped by key, without copying
+	template <typename VisitorType>
+	void MM_ForEach(VisitorType&& Visitor) const
+	{
+		for (const TPair<FGuid, TArray<FTMultiMapTestStruct>>& KvP : this->Buckets)
+		{
+			for (const FTMultiMapTestStruct& Value : KvP.Value)
+				Visitor(KvP.Key, Value);
+		}
+	}
+
+	// Calls Visitor(const FTMultiMapTestStruct&) for every value of Key in insertion order
+	template <typename VisitorType>
+	void MM_ForEachValue(const FGuid& Key, VisitorType&& Visitor) const
+	{
+		for (const FTMultiMapTestStruct& Value : MM_MultiFindView(Key))
+			Visitor(Value);
+	}
+#pragma endregion Get Values and Keys
+
+	#pragma region Notifications
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Bucketed MultiMap"
+		, meta = (CompactNodeTitle = "Set Notify Mode"
+			, ToolTip = "Immediate fires the add and remove delegates on every change. Batched collects the changed keys and fires OnMultiMapChangesFlushed once per frame"))
+	FORCEINLINE void MM_SetNotifyMode(EContainerNotifyMode Mode)
+	{
+		// leaving batched mode flushes what was recorded so far
+		this->ChangeBatcher.SetMode(Mode, this, [this]() { MM_FlushNotifications(); });
+	}
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "BA Container - Bucketed MultiMap"
+		, meta = (CompactNodeTitle = "Notify Mode"
+			, ToolTip = "Returns how changes are reported"))
+	FORCEINLINE EContainerNotifyMode MM_GetNotifyMode()
+	{
+		return this->ChangeBatcher.GetMode();
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Bucketed MultiMap"
+		, meta = (CompactNodeTitle = "Flush Notifications"
+			, ToolTip = "Fires OnMultiMapChangesFlushed with the changes collected so far instead of waiting for the next frame"))
+	FORCEINLINE void MM_FlushNotifications()
+	{
+		FContainerChangeBatch Batch;
+		if (this->ChangeBatcher.TakePending(Batch))
+			this->OnMultiMapChangesFlushed_Delegate.Broadcast(Batch);
+	}
+#pragma endregion Notifications
+
+#pragma endregion Public Functions
+
+private:
+	// Removes the bucket of Key, returns the number of values it held
+	int32 MM_RemoveBucket(const FGuid& Key)
+	{
+		TArray<FTMultiMapTestStruct> Bucket;
+		if (!this->Buckets.RemoveAndCopyValue(Key, Bucket))
+			return 0;
+		this->NumValues -= Bucket.Num();
+		return Bucket.Num();
+	}
+
+	// Fires OnMultiMapChangesFlushed with Changes or, in batched mode, adds them to the pending batch
+	void MM_NotifyBatch(FContainerChangeBatch&& Changes)
+	{
+		if (!this->ChangeBatcher.IsBatched())
+		{
+			this->OnMultiMapChangesFlushed_Delegate.Broadcast(Changes);
+			return;
+		}
+		this->ChangeBatcher.Record([&Changes](FContainerChangeBatch& Batch)
+		{
+			Batch.Append(MoveTemp(Changes));
+		});
+	}
+
+	// Records Count added or removed values of Key, the key is listed once per call
+	void MM_RecordChange(const FGuid& Key, int32 Count, bool bAdded)
+	{
+		if (Count <= 0)
+			return;
+		this->ChangeBatcher.Record([&Key, Count, bAdded](FContainerChangeBatch& Batch)
+		{
+			if (bAdded)
+			{
+				Batch.NumAdded += Count;
+				Batch.AddedKeys.Add(Key);
+			}
+			else
+			{
+				Batch.NumRemoved += Count;
+				Batch.RemovedKeys.Add(Key);
+			}
+		});
+	}
+};
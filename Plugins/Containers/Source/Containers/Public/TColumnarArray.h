@@ -0,0 +1,509 @@
+// Developer Bastian © 2024
+// License Creative Commons DEED 4.0 (https://creativecommons.org/licenses/by-sa/4.0/deed.en)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "Containers/Array.h"
+#include "Algo/Sort.h"
+#include "TArray.h"
+#include "ContainerSort.h"
+#include "ContainerFilterKernels.h"
+#include "ContainerProfiler.h"
+#include "ContainerNameArena.h"
+#include "ContainerStringTransform.h"
+
+#include "TColumnarArray.generated.h"
+
+/**
+ * Columnar (structure of arrays) variant of UTArray.
+ * Names and Numbers of FTArrayTestStruct are kept in two separate contiguous arrays, row i is Names[i] / Numbers[i].
+ * Scans, filters and aggregates over Number only read the int32 column - 4 bytes per row instead of a whole struct
+ * with its FString header - so many more rows fit into every cache line.
+ * The Name column holds handles into an FContainerNameArena: a name shared by many rows is stored once,
+ * name filters and sorts work on the distinct names and compare rows by handle.
+ */
+UCLASS(BlueprintType, Transient)
+class UTColumnarArray : public UObject
+{
+	GENERATED_BODY()
+
+public:
+
+	UTColumnarArray()
+	{}
+
+	#pragma region Delegates
+
+	UPROPERTY(BlueprintAssignable, Category = "BA Container - Columnar Array"
+		, meta = (ToolTip = "Delegate to indicate add event to columnar array"))
+	FOnArrayChanged OnArrayAdd_Delegate;
+
+	UPROPERTY(BlueprintAssignable, Category = "BA Container - Columnar Array"
+		, meta = (ToolTip = "Delegate to indicate remove event from columnar array"))
+	FOnArrayChanged OnArrayRemove_Delegate;
+
+#pragma endregion Delegates
+
+private:
+	// handles into NameArena
+	TArray<FContainerNameArena::FHandle> Names;
+	TArray<int32> Numbers;
+
+	FContainerNameArena NameArena;
+
+public:
+	#pragma region Public Functions
+
+	#pragma region Adding Elements
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Columnar Array"
+		, meta = (CompactNodeTitle = "Add"
+			, ToolTip = "Add an item to the end of the columnar array"))
+	FORCEINLINE void Columnar_Add(UPARAM(ref) FTArrayTestStruct& Value, bool Broadcast)
+	{
+		BA_CONTAINER_SCOPE("UTColumnarArray::Columnar_Add");
+		this->Names.Add(this->NameArena.Intern(Value.Name));
+		this->Numbers.Add(Value.Number);
+		if (Broadcast)
+			this->OnArrayAdd_Delegate.Broadcast(true);
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Columnar Array"
+		, meta = (CompactNodeTitle = "Insert At"
+			, ToolTip = "Insert an item into a given index of the columnar array. Will preserve order"))
+	FORCEINLINE void Columnar_InsertAt(UPARAM(ref) FTArrayTestStruct& Value, int32 Position, bool Broadcast)
+	{
+		BA_CONTAINER_SCOPE("UTColumnarArray::Columnar_InsertAt");
+		this->Names.Insert(this->NameArena.Intern(Value.Name), Position);
+		this->Numbers.Insert(Value.Number, Position);
+		if (Broadcast)
+			this->OnArrayAdd_Delegate.Broadcast(true);
+	}
+
+	/**
+	 * Splits all Values into the two columns, Values is empty afterwards - the names are interned, not moved.
+	 * Native only - one broadcast for all rows.
+	 */
+	void Columnar_AppendMoved(TArray<FTArrayTestStruct>&& Values, bool Broadcast)
+	{
+		BA_CONTAINER_SCOPE("UTColumnarArray::Columnar_AppendMoved");
+		this->Names.Reserve(this->Names.Num() + Values.Num());
+		this->Numbers.Reserve(this->Numbers.Num() + Values.Num());
+		for (FTArrayTestStruct& Value : Values)
+		{
+			this->Names.Add(this->NameArena.Intern(Value.Name));
+			this->Numbers.Add(Value.Number);
+		}
+		Values.Reset();
+		if (Broadcast)
+			this->OnArrayAdd_Delegate.Broadcast(true);
+	}
+#pragma endregion Adding Elements
+
+	#pragma region Removing Elements
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Columnar Array"
+		, meta = (CompactNodeTitle = "Remove"
+			, ToolTip = "Removes all items equal to the given one - like FTArrayTestStruct, equal means same Number"))
+	FORCEINLINE void Columnar_Remove(UPARAM(ref) FTArrayTestStruct& Value, bool Broadcast)
+	{
+		BA_CONTAINER_SCOPE("UTColumnarArray::Columnar_Remove");
+		const int32 Number = Value.Number;
+		Columnar_RemoveRows([this, Number](int32 Row)
+		{
+			return this->Numbers[Row] == Number;
+		});
+		if (Broadcast)
+			this->OnArrayRemove_Delegate.Broadcast(true);
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Columnar Array"
+		, meta = (CompactNodeTitle = "Remove At"
+			, ToolTip = "Removes the item on a given position. Will return true on successful removal, or false if position is not valid"))
+	FORCEINLINE bool Columnar_RemoveAt(int32 Position, bool Broadcast)
+	{
+		BA_CONTAINER_SCOPE("UTColumnarArray::Columnar_RemoveAt");
+		if (!this->Numbers.IsValidIndex(Position))
+			return false;
+		this->Names.RemoveAt(Position);
+		this->Numbers.RemoveAt(Position);
+		if (Broadcast)
+			this->OnArrayRemove_Delegate.Broadcast(true);
+		return true;
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Columnar Array"
+		, meta = (CompactNodeTitle = "Remove All Starting With"
+			, ToolTip = "Removes all items whose name starts with the given string, ignoring case"))
+	FORCEINLINE void Columnar_RemoveAllStartingWith(FString StartsWith, bool Broadcast)
+	{
+		BA_CONTAINER_SCOPE("UTColumnarArray::Columnar_RemoveAllStartingWith");
+		const TBitArray<> Matches = Columnar_MatchNames([&StartsWith](FStringView Name)
+		{
+			return Name.StartsWith(StartsWith, ESearchCase::IgnoreCase);
+		});
+		Columnar_RemoveRows([this, &Matches](int32 Row)
+		{
+			return Matches[this->Names[Row]];
+		});
+		if (Broadcast)
+			this->OnArrayRemove_Delegate.Broadcast(true);
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Columnar Array"
+		, meta = (CompactNodeTitle = "Empty"
+			, ToolTip = "Empties both columns and frees all stored names at once - set NewCapacity to zero if you dont need to reserve space for new content, otherwise provide the expected capacity"))
+	FORCEINLINE void Columnar_Empty(int32 NewCapacity, bool Broadcast)
+	{
+		BA_CONTAINER_SCOPE("UTColumnarArray::Columnar_Empty");
+		this->Names.Empty(NewCapacity);
+		this->Numbers.Empty(NewCapacity);
+		this->NameArena.Empty();
+		if (Broadcast)
+			this->OnArrayRemove_Delegate.Broadcast(true);
+	}
+#pragma endregion Removing Elements
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "BA Container - Columnar Array"
+		, meta = (CompactNodeTitle = "No of values"
+			, ToolTip = "Returns the number of rows"))
+	FORCEINLINE int32 Columnar_NumberOfValues()
+	{
+		return this->Numbers.Num();
+	}
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "BA Container - Columnar Array"
+		, meta = (CompactNodeTitle = "No of names"
+			, ToolTip = "Returns the number of distinct names stored since the last Empty, including names of removed rows"))
+	FORCEINLINE int32 Columnar_NumberOfNames()
+	{
+		return this->NameArena.Num();
+	}
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "BA Container - Columnar Array"
+		, meta = (CompactNodeTitle = "Contains"
+			, ToolTip = "Check if a row with the same Number exists - only the Number column is scanned"))
+	FORCEINLINE bool Columnar_Contains(UPARAM(ref) FTArrayTestStruct& Value)
+	{
+		BA_CONTAINER_SCOPE("UTColumnarArray::Columnar_Contains");
+		return this->Numbers.Contains(Value.Number);
+	}
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "BA Container - Columnar Array"
+		, meta = (CompactNodeTitle = "Get"
+			, ToolTip = "Returns the row on the given position as struct, or an empty struct if the position is not valid"))
+	FORCEINLINE FTArrayTestStruct Columnar_Get(int32 Position)
+	{
+		FTArrayTestStruct Value;
+		if (this->Numbers.IsValidIndex(Position))
+		{
+			Value.Name = this->NameArena.ToString(this->Names[Position]);
+			Value.Number = this->Numbers[Position];
+		}
+		return Value;
+	}
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "BA Container - Columnar Array"
+		, meta = (CompactNodeTitle = "Values"
+			, ToolTip = "Returns all rows as structs. Builds a new array, prefer the column functions for large data"))
+	FORCEINLINE TArray<FTArrayTestStruct> Columnar_Values()
+	{
+		BA_CONTAINER_SCOPE("UTColumnarArray::Columnar_Values");
+		TArray<FTArrayTestStruct> Values;
+		Values.SetNum(this->Numbers.Num());
+		for (int32 Row = 0; Row < Values.Num(); ++Row)
+		{
+			Values[Row].Name = this->NameArena.ToString(this->Names[Row]);
+			Values[Row].Number = this->Numbers[Row];
+		}
+		return Values;
+	}
+
+	// Read-only access to the columns, row i of both belongs together. Names are handles, resolved by Columnar_GetNameArena
+	FORCEINLINE TConstArrayView<FContainerNameArena::FHandle> Columnar_GetNames() const
+	{
+		return this->Names;
+	}
+
+	FORCEINLINE const FContainerNameArena& Columnar_GetNameArena() const
+	{
+		return this->NameArena;
+	}
+
+	FORCEINLINE TConstArrayView<int32> Columnar_GetNumbers() const
+	{
+		return this->Numbers;
+	}
+
+	#pragma region Searching
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Columnar Array"
+		, meta = (CompactNodeTitle = "Find Name Start"
+			, ToolTip = "Returns all items with name starting like parameter given - only the Name column is scanned"))
+	FORCEINLINE TArray<FTArrayTestStruct> Columnar_GetNamesStartingWith(const FString& StartsWith)
+	{
+		BA_CONTAINER_SCOPE("UTColumnarArray::Columnar_GetNamesStartingWith");
+		const TBitArray<> Matches = Columnar_MatchNames([&StartsWith](FStringView Name)
+		{
+			return Name.StartsWith(StartsWith, ESearchCase::IgnoreCase);
+		});
+		TArray<int32> Rows;
+		for (int32 Row = 0; Row < this->Names.Num(); ++Row)
+		{
+			if (Matches[this->Names[Row]])
+				Rows.Add(Row);
+		}
+		return Columnar_GatherRows(Rows);
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Columnar Array"
+		, meta = (CompactNodeTitle = "Rows Named"
+			, ToolTip = "Returns the positions of all rows with exactly this name (case sensitive) - the name is looked up once, then the rows are compared by handle"))
+	FORCEINLINE TArray<int32> Columnar_GetRowsWithName(const FString& Name)
+	{
+		BA_CONTAINER_SCOPE("UTColumnarArray::Columnar_GetRowsWithName");
+		const FContainerNameArena::FHandle Handle = this->NameArena.Find(Name);
+		if (Handle == INDEX_NONE)
+			return TArray<int32>();
+		TArray<int32> Rows;
+		FContainerFilterKernels::SelectIndices(this->Names.GetData(), this->Names.Num(), sizeof(FContainerNameArena::FHandle), FContainerFilterPredicate::Between(Handle, Handle), Rows);
+		return Rows;
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Columnar Array"
+		, meta = (CompactNodeTitle = "Rows Above"
+			, ToolTip = "Returns the positions of all rows with Number larger than the parameter - only the Number column is scanned"))
+	FORCEINLINE TArray<int32> Columnar_GetRowsWithNumberAbove(int32 Number)
+	{
+		BA_CONTAINER_SCOPE("UTColumnarArray::Columnar_GetRowsWithNumberAbove");
+		return Columnar_SelectRows(FContainerFilterPredicate::Greater(Number));
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Columnar Array"
+		, meta = (CompactNodeTitle = "Rows Below"
+			, ToolTip = "Returns the positions of all rows with Number smaller than the parameter - only the Number column is scanned"))
+	FORCEINLINE TArray<int32> Columnar_GetRowsWithNumberBelow(int32 Number)
+	{
+		BA_CONTAINER_SCOPE("UTColumnarArray::Columnar_GetRowsWithNumberBelow");
+		return Columnar_SelectRows(FContainerFilterPredicate::Less(Number));
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Columnar Array"
+		, meta = (CompactNodeTitle = "Rows In"
+			, ToolTip = "Returns the positions of all rows whose Number is one of the given values - only the Number column is scanned"))
+	FORCEINLINE TArray<int32> Columnar_GetRowsWithNumberIn(const TArray<int32>& Values)
+	{
+		BA_CONTAINER_SCOPE("UTColumnarArray::Columnar_GetRowsWithNumberIn");
+		return Columnar_SelectRows(FContainerFilterPredicate::InSet(Values));
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Columnar Array"
+		, meta = (CompactNodeTitle = "Filter Numbers"
+			, ToolTip = "Returns all items with Number between Min and Max (both included). The Name column is only read for the matches"))
+	FORCEINLINE TArray<FTArrayTestStruct> Columnar_FilterByNumber(int32 Min, int32 Max)
+	{
+		BA_CONTAINER_SCOPE("UTColumnarArray::Columnar_FilterByNumber");
+		return Columnar_GatherRows(Columnar_SelectRows(FContainerFilterPredicate::Between(Min, Max)));
+	}
+#pragma endregion Searching
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Columnar Array"
+		, meta = (CompactNodeTitle = "Transform Names"
+			, ToolTip = "Adds a prefix or suffix to all names, or replaces Text with Replacement in them (case sensitive). Every distinct name is transformed once, into one buffer, and names of removed rows are dropped. SkipIfPresent leaves names that already have the prefix or suffix alone. Returns the number of changed rows"))
+	FORCEINLINE int32 Columnar_TransformNames(EContainerStringTransform Transform, const FString& Text, const FString& Replacement, bool SkipIfPresent)
+	{
+		BA_CONTAINER_SCOPE("UTColumnarArray::Columnar_TransformNames");
+		// only the names rows still use go into the new arena
+		TBitArray<> Used(false, this->NameArena.Num());
+		for (const FContainerNameArena::FHandle Name : this->Names)
+			Used[Name] = true;
+		TArray<FContainerNameArena::FHandle> UsedNames;
+		for (TConstSetBitIterator<> It(Used); It; ++It)
+			UsedNames.Add(It.GetIndex());
+
+		const FContainerStringTransform Operation(Transform, Text, Replacement, SkipIfPresent);
+		FContainerNameArena Transformed;
+		TArray<FContainerNameArena::FHandle> NewHandles;
+		Operation.ApplyAll(this->NameArena, UsedNames, Transformed, NewHandles);
+
+		TArray<FContainerNameArena::FHandle> Remap;
+		Remap.SetNumUninitialized(this->NameArena.Num());
+		TBitArray<> Changed(false, this->NameArena.Num());
+		for (int32 i = 0; i < UsedNames.Num(); ++i)
+		{
+			Remap[UsedNames[i]] = NewHandles[i];
+			Changed[UsedNames[i]] = !Operation.IsUnchanged(this->NameArena.Get(UsedNames[i]));
+		}
+		int32 NumChanged = 0;
+		for (FContainerNameArena::FHandle& Name : this->Names)
+		{
+			NumChanged += Changed[Name] ? 1 : 0;
+			Name = Remap[Name];
+		}
+		this->NameArena = MoveTemp(Transformed);
+		return NumChanged;
+	}
+
+	#pragma region Aggregates
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "BA Container - Columnar Array"
+		, meta = (CompactNodeTitle = "Sum"
+			, ToolTip = "Sum of all Numbers"))
+	FORCEINLINE int64 Columnar_SumNumbers()
+	{
+		BA_CONTAINER_SCOPE("UTColumnarArray::Columnar_SumNumbers");
+		int64 Sum = 0;
+		for (const int32 Number : this->Numbers)
+			Sum += Number;
+		return Sum;
+	}
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "BA Container - Columnar Array"
+		, meta = (CompactNodeTitle = "Average"
+			, ToolTip = "Average of all Numbers, 0 if empty"))
+	FORCEINLINE double Columnar_AverageNumber()
+	{
+		return this->Numbers.Num() > 0 ? (double)Columnar_SumNumbers() / this->Numbers.Num() : 0.0;
+	}
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "BA Container - Columnar Array"
+		, meta = (CompactNodeTitle = "Min / Max"
+			, ToolTip = "Smallest and largest Number, returns false if empty"))
+	FORCEINLINE bool Columnar_MinMaxNumber(int32& Min, int32& Max)
+	{
+		BA_CONTAINER_SCOPE("UTColumnarArray::Columnar_MinMaxNumber");
+		Min = MAX_int32;
+		Max = MIN_int32;
+		for (const int32 Number : this->Numbers)
+		{
+			Min = FMath::Min(Min, Number);
+			Max = FMath::Max(Max, Number);
+		}
+		return this->Numbers.Num() > 0;
+	}
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "BA Container - Columnar Array"
+		, meta = (CompactNodeTitle = "Count Above"
+			, ToolTip = "Number of rows with Number larger than the parameter"))
+	FORCEINLINE int32 Columnar_CountNumberAbove(int32 Number)
+	{
+		BA_CONTAINER_SCOPE("UTColumnarArray::Columnar_CountNumberAbove");
+		return FContainerFilterKernels::CountMatches(this->Numbers.GetData(), this->Numbers.Num(), sizeof(int32), FContainerFilterPredicate::Greater(Number));
+	}
+#pragma endregion Aggregates
+
+	#pragma region Sorting
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Columnar Array"
+		, meta = (CompactNodeTitle = "Sort"
+			, ToolTip = "Sort the rows by Enum ETestArraySorting. Only the sort column is compared, then both columns are permuted once. Sorting by name ranks the distinct names once and sorts the rows by rank"))
+	FORCEINLINE void Columnar_Sort(ETestArraySorting Sort, EContainerSortBackend Backend = EContainerSortBackend::E_Default)
+	{
+		BA_CONTAINER_SCOPE("UTColumnarArray::Columnar_Sort");
+		const bool bByName = Sort == ETestArraySorting::E_NameAsc || Sort == ETestArraySorting::E_NameDesc;
+		const bool bDescending = Sort == ETestArraySorting::E_NumberDesc || Sort == ETestArraySorting::E_NameDesc;
+		TArray<int32> Order;
+		// names equal when ignoring case share a rank, so sorting by rank orders them like FString's operator<
+		const TArray<int32> Ranks = bByName ? Columnar_RankNames() : TArray<int32>();
+		if (Backend == EContainerSortBackend::E_Parallel)
+		{
+			if (bByName)
+				FContainerSort::NumberOrder(this->Names, [&Ranks](FContainerNameArena::FHandle Name) { return Ranks[Name]; }, bDescending, Order);
+			else
+				FContainerSort::NumberOrder(this->Numbers, [](int32 Number) { return Number; }, bDescending, Order);
+		}
+		else
+		{
+			Order.SetNumUninitialized(this->Numbers.Num());
+			for (int32 Row = 0; Row < Order.Num(); ++Row)
+				Order[Row] = Row;
+			const TArray<int32>& N = this->Names;
+			const TArray<int32>& V = this->Numbers;
+			if (bByName)
+				Algo::Sort(Order, [&N, &Ranks, bDescending](int32 A, int32 B) { return bDescending ? Ranks[N[B]] < Ranks[N[A]] : Ranks[N[A]] < Ranks[N[B]]; });
+			else
+				Algo::Sort(Order, [&V, bDescending](int32 A, int32 B) { return bDescending ? V[B] < V[A] : V[A] < V[B]; });
+		}
+		FContainerSort::ApplyOrder(this->Names, Order);
+		FContainerSort::ApplyOrder(this->Numbers, Order);
+	}
+#pragma endregion Sorting
+
+#pragma endregion Public Functions
+
+private:
+	// Removes every row ShouldRemove(Row) returns true for, compacting both columns in one pass
+	template <typename PredicateType>
+	void Columnar_RemoveRows(PredicateType&& ShouldRemove)
+	{
+		int32 Write = 0;
+		for (int32 Row = 0; Row < this->Numbers.Num(); ++Row)
+		{
+			if (ShouldRemove(Row))
+				continue;
+			if (Write != Row)
+			{
+				this->Names[Write] = this->Names[Row];
+				this->Numbers[Write] = this->Numbers[Row];
+			}
+			++Write;
+		}
+		this->Names.SetNum(Write, false);
+		this->Numbers.SetNum(Write, false);
+	}
+
+	// One bit per interned name, set if Predicate(FStringView) holds - evaluated once per distinct name instead of once per row
+	template <typename PredicateType>
+	TBitArray<> Columnar_MatchNames(PredicateType&& Predicate) const
+	{
+		TBitArray<> Matches(false, this->NameArena.Num());
+		for (FContainerNameArena::FHandle Handle = 0; Handle < this->NameArena.Num(); ++Handle)
+		{
+			if (Predicate(this->NameArena.Get(Handle)))
+				Matches[Handle] = true;
+		}
+		return Matches;
+	}
+
+	// Rank of every interned name in case insensitive order
+	TArray<int32> Columnar_RankNames() const
+	{
+		const FContainerNameArena& Arena = this->NameArena;
+		TArray<FContainerNameArena::FHandle> Sorted;
+		Sorted.SetNumUninitialized(Arena.Num());
+		for (FContainerNameArena::FHandle Handle = 0; Handle < Sorted.Num(); ++Handle)
+			Sorted[Handle] = Handle;
+		Algo::Sort(Sorted, [&Arena](FContainerNameArena::FHandle A, FContainerNameArena::FHandle B)
+		{
+			return FCString::Stricmp(Arena.GetChars(A), Arena.GetChars(B)) < 0;
+		});
+		TArray<int32> Ranks;
+		Ranks.SetNumUninitialized(Arena.Num());
+		int32 Rank = 0;
+		for (int32 i = 0; i < Sorted.Num(); ++i)
+		{
+			if (i > 0 && FCString::Stricmp(Arena.GetChars(Sorted[i - 1]), Arena.GetChars(Sorted[i])) != 0)
+				++Rank;
+			Ranks[Sorted[i]] = Rank;
+		}
+		return Ranks;
+	}
+
+	// Positions of all rows whose Number matches, evaluated by the vectorized filter kernels
+	TArray<int32> Columnar_SelectRows(const FContainerFilterPredicate& Predicate) const
+	{
+		TArray<int32> Rows;
+		FContainerFilterKernels::SelectIndices(this->Numbers.GetData(), this->Numbers.Num(), sizeof(int32), Predicate, Rows);
+		return Rows;
+	}
+
+	// Builds structs for the given rows
+	TArray<FTArrayTestStruct> Columnar_GatherRows(const TArray<int32>& Rows) const
+	{
+		TArray<FTArrayTestStruct> Values;
+		Values.SetNum(Rows.Num());
+		for (int32 i = 0; i < Rows.Num(); ++i)
+		{
+			Values[i].Name = this->NameArena.ToString(this->Names[Rows[i]]);
+			Values[i].Number = this->Numbers[Rows[i]];
+		}
+		return Values;
+	}
+};
@@ -10,7 +10,14 @@
 #include "Misc/Guid.h"
 #include "Misc/SpinLock.h"
 #include "Containers/Map.h"
+#include "SortedChunkArray.h"
+#include "ContainerSort.h"
+#include "ContainerFilterKernels.h"
+#include "ContainerChangeBatch.h"
+#include "ContainerBloomFilter.h"
+#include "ContainerStringTransform.h"
 #include "Timer.h"
+#include "ContainerProfiler.h"
 
 #include "TMap.generated.h"
 
@@ -70,8 +77,53 @@ public:
 	{
 		return A.Name > B.Name;
 	}
+
+	// Same order as comparing FGuid::ToString() with >, the digits are just A, B, C and D in hex,
+	// but compared as integers instead of allocating two strings per comparison
+	static bool CompareKeyDescending(const FGuid& A, const FGuid& B)
+	{
+		if (A.A != B.A)
+			return A.A > B.A;
+		if (A.B != B.B)
+			return A.B > B.B;
+		if (A.C != B.C)
+			return A.C > B.C;
+		return A.D > B.D;
+	}
 #pragma endregion Sorting
 };
+
+/**
+ * Entry of the population index of UTMap: ordered by Number, ties broken by Guid,
+ * so every entry has exactly one position and can be removed again.
+ */
+struct FMapPopulationKey
+{
+	int32 Number = 0;
+	FGuid Guid;
+
+	FMapPopulationKey()
+	{}
+
+	FMapPopulationKey(int32 InNumber, const FGuid& InGuid) : Number(InNumber), Guid(InGuid)
+	{}
+
+	FORCEINLINE bool operator<(const FMapPopulationKey& Other) const
+	{
+		return Number != Other.Number ? Number < Other.Number : Guid < Other.Guid;
+	}
+
+	// first and last possible entry for a Number, used as bounds of range queries
+	static FMapPopulationKey First(int32 Number)
+	{
+		return FMapPopulationKey(Number, FGuid(0, 0, 0, 0));
+	}
+
+	static FMapPopulationKey Last(int32 Number)
+	{
+		return FMapPopulationKey(Number, FGuid(MAX_uint32, MAX_uint32, MAX_uint32, MAX_uint32));
+	}
+};
 #pragma endregion Struct
 
 /**
@@ -108,11 +160,25 @@ public:
 		, meta = (ToolTip = "Delegate to indicate a value was removed from map"))
 	FOnMapChanged OnMapDelete_Delegate;
 
+	UPROPERTY(BlueprintAssignable, Category = "BA Container - Map"
+		, meta = (ToolTip = "Delegate with the keys changed during the last frame, only fired in batched notify mode"))
+	FOnContainerChangesFlushed OnMapChangesFlushed_Delegate;
+
 #pragma endregion Delegates
 
 private:
 	TMap<FGuid, FMapTestStruct> BA_Map;
 
+	// optional secondary index on FMapTestStruct::Number, see Map_SetPopulationIndexEnabled
+	bool bPopulationIndexEnabled = false;
+	TSortedChunkArray<FMapPopulationKey> PopulationIndex;
+
+	// pending changes while in batched notify mode
+	FContainerChangeBatcher ChangeBatcher;
+
+	// optional filter on the keys in front of Map_GetValue
+	FContainerBloomFilter BloomFilter;
+
 public:
 
 	#pragma region Public Functions
@@ -123,9 +189,18 @@ public:
 			, ToolTip = "Add one Key-Value pair to the map"))
 	FORCEINLINE void Map_Add(UPARAM(ref) FMapTestStruct& Value, bool Broadcast)
 	{
+		BA_CONTAINER_SCOPE("UTMap::Map_Add");
+		if (this->bPopulationIndexEnabled)
+		{
+			// Add replaces an existing value, so its old index entry has to go
+			if (const FMapTestStruct* Existing = this->BA_Map.Find(Value.Guid))
+				this->PopulationIndex.Remove(FMapPopulationKey(Existing->Number, Value.Guid));
+			this->PopulationIndex.Insert(FMapPopulationKey(Value.Number, Value.Guid));
+		}
 		BA_Map.Add(Value.Guid, Value);
+		this->BloomFilter.Add(FContainerBloomFilter::Hash(Value.Guid));
 		if (Broadcast)
-			this->OnMapAdd_Delegate.Broadcast(Value);
+			Map_NotifyAdded(Value);
 	}
 
 	UFUNCTION(BlueprintCallable, Category = "BA Container - Map"
@@ -133,12 +208,101 @@ public:
 			, ToolTip = "Remove all associations between the specified key and value from the multi map"))
 	FORCEINLINE FMapTestStruct Map_Remove(UPARAM(ref) FGuid& Key, bool Broadcast)
 	{
+		BA_CONTAINER_SCOPE("UTMap::Map_Remove");
 		FMapTestStruct tmpValue;
 		bool found = this->BA_Map.RemoveAndCopyValue(Key, tmpValue);
+		if (found && this->bPopulationIndexEnabled)
+			this->PopulationIndex.Remove(FMapPopulationKey(tmpValue.Number, Key));
+		if (found)
+			this->BloomFilter.Remove();
 		if (Broadcast && found)
-			this->OnMapDelete_Delegate.Broadcast(tmpValue);
+			Map_NotifyRemoved(tmpValue);
 		return tmpValue;
 	}
+
+	/**
+	 * Moves all Values into the map, keyed by their Guid, Values is empty afterwards.
+	 * Reserves once for all rows, so the map rehashes at most one time.
+	 * Native only - used by the bulk loaders, so there is just one broadcast for all rows.
+	 */
+	void Map_AppendMoved(TArray<FMapTestStruct>&& Values, bool Broadcast)
+	{
+		BA_CONTAINER_SCOPE("UTMap::Map_AppendMoved");
+		FContainerChangeBatch Changes;
+		if (Broadcast)
+		{
+			// the values are moved away, so the keys are taken before
+			Changes.NumAdded = Values.Num();
+			Changes.AddedKeys.Reserve(Values.Num());
+			for (const FMapTestStruct& Value : Values)
+				Changes.AddedKeys.Add(Value.Guid);
+		}
+		// large batches rebuild the index once instead of updating it per row
+		const bool bUpdateIndex = this->bPopulationIndexEnabled && Values.Num() <= this->BA_Map.Num();
+		this->BA_Map.Reserve(this->BA_Map.Num() + Values.Num());
+		for (FMapTestStruct& Value : Values)
+		{
+			const FGuid Key = Value.Guid;
+			if (bUpdateIndex)
+			{
+				if (const FMapTestStruct* Existing = this->BA_Map.Find(Key))
+					this->PopulationIndex.Remove(FMapPopulationKey(Existing->Number, Key));
+				this->PopulationIndex.Insert(FMapPopulationKey(Value.Number, Key));
+			}
+			this->BA_Map.Add(Key, MoveTemp(Value));
+			this->BloomFilter.Add(FContainerBloomFilter::Hash(Key));
+		}
+		Values.Reset();
+		if (this->bPopulationIndexEnabled && !bUpdateIndex)
+			Map_RebuildPopulationIndex();
+		if (Broadcast)
+			Map_NotifyBatch(MoveTemp(Changes));
+	}
+
+	/**
+	 * The bulk functions report all keys in one FContainerChangeBatch on OnMapChangesFlushed - right away in
+	 * immediate mode, with the next flush in batched mode - as the add and remove delegates carry only one value.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Map"
+		, meta = (CompactNodeTitle = "Add Batch"
+			, ToolTip = "Moves all Values into the map, keyed by their Guid, with one reservation and one notification. Values is empty afterwards"))
+	FORCEINLINE void Map_AddBatch(UPARAM(ref) TArray<FMapTestStruct>& Values, bool Broadcast)
+	{
+		BA_CONTAINER_SCOPE("UTMap::Map_AddBatch");
+		Map_AppendMoved(MoveTemp(Values), Broadcast);
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Map"
+		, meta = (CompactNodeTitle = "Remove Batch"
+			, ToolTip = "Removes the values of all Keys with one notification. Returns the number of removed values"))
+	FORCEINLINE int32 Map_RemoveBatch(const TArray<FGuid>& Keys, bool Broadcast)
+	{
+		BA_CONTAINER_SCOPE("UTMap::Map_RemoveBatch");
+		// removing most of the map is cheaper with one rebuild of the index than with one update per key
+		const bool bUpdateIndex = this->bPopulationIndexEnabled && Keys.Num() <= this->BA_Map.Num() / 2;
+		FContainerChangeBatch Changes;
+		if (Broadcast)
+			Changes.RemovedKeys.Reserve(Keys.Num());
+		for (const FGuid& Key : Keys)
+		{
+			const FMapTestStruct* Existing = this->BA_Map.Find(Key);
+			if (Existing == nullptr)
+				continue;
+			if (bUpdateIndex)
+				this->PopulationIndex.Remove(FMapPopulationKey(Existing->Number, Key));
+			this->BA_Map.Remove(Key);
+			++Changes.NumRemoved;
+			if (Broadcast)
+				Changes.RemovedKeys.Add(Key);
+		}
+		const int32 NumRemoved = Changes.NumRemoved;
+		this->BloomFilter.Remove(NumRemoved);
+		if (NumRemoved > 0 && this->bPopulationIndexEnabled && !bUpdateIndex)
+			Map_RebuildPopulationIndex();
+		if (Broadcast && NumRemoved > 0)
+			Map_NotifyBatch(MoveTemp(Changes));
+		return NumRemoved;
+	}
 #pragma endregion Add and Remove
 
 	#pragma region Map Misc
@@ -147,6 +311,7 @@ public:
 			, ToolTip = "Returns the number of values within this map"))
 	FORCEINLINE int32 Map_NumberOfValues()
 	{
+		BA_CONTAINER_SCOPE("UTMap::Map_NumberOfValues");
 		return this->BA_Map.Num();
 	}
 
@@ -155,16 +320,106 @@ public:
 			, ToolTip = "Empties the map - set NewCapacity to zero if you dont need to reserve space for new content, otherwise provide the expected capacity"))
 	FORCEINLINE void Map_Empty(int32 NewCapacity)
 	{
+		BA_CONTAINER_SCOPE("UTMap::Map_Empty");
 		this->BA_Map.Empty(NewCapacity);
+		this->PopulationIndex.Reset();
+		this->BloomFilter.Invalidate();
 	}
 #pragma endregion Map Misc
 
+	#pragma region Population Index
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Map"
+		, meta = (CompactNodeTitle = "Population Index"
+			, ToolTip = "Enables an ordered index on FMapTestStruct.Number. It is kept up to date on add and remove and answers population range queries in O(log n + k). Enabling builds it once from the current content"))
+	FORCEINLINE void Map_SetPopulationIndexEnabled(bool Enabled)
+	{
+		BA_CONTAINER_SCOPE("UTMap::Map_SetPopulationIndexEnabled");
+		if (Enabled == this->bPopulationIndexEnabled)
+			return;
+		this->bPopulationIndexEnabled = Enabled;
+		if (Enabled)
+			Map_RebuildPopulationIndex();
+		else
+			this->PopulationIndex.Reset();
+	}
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "BA Container - Map"
+		, meta = (CompactNodeTitle = "Has Population Index"
+			, ToolTip = "Checks whether the population index is enabled"))
+	FORCEINLINE bool Map_HasPopulationIndex()
+	{
+		return this->bPopulationIndexEnabled;
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Map"
+		, meta = (CompactNodeTitle = "Keys in Population Range"
+			, ToolTip = "Gets the keys of all cities with Min <= population <= Max, ordered by population. Uses the population index if enabled, otherwise scans the map"))
+	FORCEINLINE TArray<FGuid> Map_GetKeysInPopulationRange(int32 Min, int32 Max)
+	{
+		BA_CONTAINER_SCOPE("UTMap::Map_GetKeysInPopulationRange");
+		TArray<FGuid> keys;
+		Map_ForEachInPopulationRange(Min, Max, [&keys](const FGuid& Key)
+		{
+			keys.Add(Key);
+		});
+		return keys;
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Map"
+		, meta = (CompactNodeTitle = "Keys above Population"
+			, ToolTip = "Gets the keys of all cities with population larger than parameter, ordered by population"))
+	FORCEINLINE TArray<FGuid> Map_GetKeysWithPopulationAbove(int32 Population)
+	{
+		BA_CONTAINER_SCOPE("UTMap::Map_GetKeysWithPopulationAbove");
+		if (Population == MAX_int32)
+			return TArray<FGuid>();
+		return Map_GetKeysInPopulationRange(Population + 1, MAX_int32);
+	}
+
+	/**
+	 * Calls Visitor with the key of every city with Min <= population <= Max.
+	 * With the index enabled this is a lookup plus an in-order walk and no value is touched,
+	 * otherwise every entry of the map is checked (and keys come in map order).
+	 */
+	template <typename VisitorType>
+	void Map_ForEachInPopulationRange(int32 Min, int32 Max, VisitorType&& Visitor)
+	{
+		if (Min > Max)
+			return;
+		if (this->bPopulationIndexEnabled)
+		{
+			const auto First = this->PopulationIndex.LowerBound(FMapPopulationKey::First(Min));
+			const auto Last = this->PopulationIndex.UpperBound(FMapPopulationKey::Last(Max));
+			this->PopulationIndex.ForEachInRange(First, Last, [&Visitor](const FMapPopulationKey& Entry)
+			{
+				Visitor(Entry.Guid);
+			});
+			return;
+		}
+		for (const TPair<FGuid, FMapTestStruct>& KvP : this->BA_Map)
+		{
+			if (KvP.Value.Number >= Min && KvP.Value.Number <= Max)
+				Visitor(KvP.Key);
+		}
+	}
+#pragma endregion Population Index
+
 	#pragma region Get Values and Keys
 	UFUNCTION(BlueprintCallable, Category = "BA Container - Map"
 		, meta = (CompactNodeTitle = "Get Value"
 			, ToolTip = "Returns a values matching the given key - or an empty default struct if key is not found"))
 	FORCEINLINE FMapTestStruct Map_GetValue(UPARAM(ref) FGuid& Key)
 	{
+		BA_CONTAINER_SCOPE("UTMap::Map_GetValue");
+		if (this->BloomFilter.IsEnabled())
+		{
+			Map_EnsureBloomFilter();
+			if (this->BloomFilter.Rejects(FContainerBloomFilter::Hash(Key)))
+				return FMapTestStruct();
+			const FMapTestStruct* Value = this->BA_Map.Find(Key);
+			this->BloomFilter.RecordLookup(Value != nullptr);
+			return Value != nullptr ? *Value : FMapTestStruct();
+		}
 		return this->BA_Map.FindRef(Key);
 	}
 
@@ -173,6 +428,7 @@ public:
 			, ToolTip = "Gets all keys of the map"))
 	FORCEINLINE TArray<FGuid> Map_GetKeys()
 	{
+		BA_CONTAINER_SCOPE("UTMap::Map_GetKeys");
 		TArray<FGuid> keys;
 		this->BA_Map.GenerateKeyArray(keys);
 		return keys;
@@ -183,22 +439,80 @@ public:
 			, ToolTip = "Gets all values of the map"))
 	FORCEINLINE TArray<FMapTestStruct> Map_GetValues()
 	{
+		BA_CONTAINER_SCOPE("UTMap::Map_GetValues");
 		TArray<FMapTestStruct> values;
 		this->BA_Map.GenerateValueArray(values);
 		return values;
 	}
 
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Map"
+		, meta = (CompactNodeTitle = "Keys Page"
+			, ToolTip = "Returns up to Count keys starting at Offset in iteration order. Use with Number of values to page through large maps"))
+	FORCEINLINE TArray<FGuid> Map_GetKeysPage(int32 Offset, int32 Count)
+	{
+		BA_CONTAINER_SCOPE("UTMap::Map_GetKeysPage");
+		TArray<FGuid> Page;
+		Map_ForEachInPage(Offset, Count, Page, [&Page](const FGuid& Key, const FMapTestStruct& Value)
+		{
+			Page.Add(Key);
+		});
+		return Page;
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Map"
+		, meta = (CompactNodeTitle = "Values Page"
+			, ToolTip = "Returns up to Count values starting at Offset in iteration order. Use with Number of values to page through large maps"))
+	FORCEINLINE TArray<FMapTestStruct> Map_GetValuesPage(int32 Offset, int32 Count)
+	{
+		BA_CONTAINER_SCOPE("UTMap::Map_GetValuesPage");
+		TArray<FMapTestStruct> Page;
+		Map_ForEachInPage(Offset, Count, Page, [&Page](const FGuid& Key, const FMapTestStruct& Value)
+		{
+			Page.Add(Value);
+		});
+		return Page;
+	}
+
+	// Read-only access to the stored pairs, valid until the map is changed
+	FORCEINLINE const TMap<FGuid, FMapTestStruct>& Map_View() const
+	{
+		return this->BA_Map;
+	}
+
+	// Calls Visitor(const FGuid&, const FMapTestStruct&) for every pair in iteration order, without copying
+	template <typename VisitorType>
+	void Map_ForEach(VisitorType&& Visitor) const
+	{
+		for (const TPair<FGuid, FMapTestStruct>& KvP : this->BA_Map)
+			Visitor(KvP.Key, KvP.Value);
+	}
+
 	UFUNCTION(BlueprintCallable, Category = "BA Container - Map"
 		, meta = (CompactNodeTitle = "Filter Cities"
 			, ToolTip = "Gets all cities with population larger than parameter"))
 	FORCEINLINE TMap<FGuid, FMapTestStruct> Map_FilterCities(int32 Population)
 	{
-		TMap<FGuid, FMapTestStruct> filtered = this->BA_Map.FilterByPredicate(
-			[Population](const TPair<FGuid, FMapTestStruct>& KvP)
+		BA_CONTAINER_SCOPE("UTMap::Map_FilterCities");
+		if (this->bPopulationIndexEnabled)
+		{
+			// only the matching entries are visited
+			TMap<FGuid, FMapTestStruct> filtered;
+			if (Population == MAX_int32)
+				return filtered;
+			const auto First = this->PopulationIndex.LowerBound(FMapPopulationKey::First(Population + 1));
+			const auto Last = this->PopulationIndex.End();
+			filtered.Reserve(this->PopulationIndex.CountInRange(First, Last));
+			this->PopulationIndex.ForEachInRange(First, Last, [this, &filtered](const FMapPopulationKey& Entry)
 			{
-				return KvP.Value.Number > Population;
-			}
-		);
+				filtered.Add(Entry.Guid, this->BA_Map.FindChecked(Entry.Guid));
+			});
+			return filtered;
+		}
+		// without the index the populations are compared 64 at a time by the vectorized filter kernels
+		TMap<FGuid, FMapTestStruct> filtered;
+		FContainerFilterKernels::ForEachMatch(this->BA_Map, FContainerFilterPredicate::Greater(Population)
+			, [](const TPair<FGuid, FMapTestStruct>& KvP) { return KvP.Value.Number; }
+			, [&filtered](const TPair<FGuid, FMapTestStruct>& KvP) { filtered.Add(KvP.Key, KvP.Value); });
 		return filtered;
 	}
 #pragma endregion Get Values and Keys
@@ -206,9 +520,28 @@ public:
 	#pragma region Sorting Values and Keys
 UFUNCTION(BlueprintCallable, Category = "BA Container - Map"
 		, meta = (CompactNodeTitle = "Value Sort"
-			, ToolTip = "Sort the values of the map using ETestMapSorting and static functions of the value struct"))
-	FORCEINLINE void Map_ValueSort(ETestMapSorting Sorting)
+			, ToolTip = "Sort the values of the map using ETestMapSorting and static functions of the value struct. The parallel backend radix sorts numbers and merge sorts names on all cores"))
+	FORCEINLINE void Map_ValueSort(ETestMapSorting Sorting, EContainerSortBackend Backend = EContainerSortBackend::E_Default)
 	{
+		BA_CONTAINER_SCOPE("UTMap::Map_ValueSort");
+		if (Backend == EContainerSortBackend::E_Parallel)
+		{
+			// the map keeps insertion order, so it is rebuilt in sorted order - keys do not change, the population index stays valid
+			TArray<TPair<FGuid, FMapTestStruct>> Pairs;
+			Pairs.Reserve(this->BA_Map.Num());
+			for (TPair<FGuid, FMapTestStruct>& KvP : this->BA_Map)
+				Pairs.Emplace(KvP.Key, MoveTemp(KvP.Value));
+			TArray<int32> Order;
+			const bool bDescending = Sorting == ETestMapSorting::E_NumberDesc || Sorting == ETestMapSorting::E_NameDesc;
+			if (Sorting == ETestMapSorting::E_NameAsc || Sorting == ETestMapSorting::E_NameDesc)
+				FContainerSort::NameOrder(Pairs, [](const TPair<FGuid, FMapTestStruct>& Pair) -> const FString& { return Pair.Value.Name; }, bDescending, Order);
+			else
+				FContainerSort::NumberOrder(Pairs, [](const TPair<FGuid, FMapTestStruct>& Pair) { return Pair.Value.Number; }, bDescending, Order);
+			this->BA_Map.Empty(Pairs.Num());
+			for (int32 Index : Order)
+				this->BA_Map.Add(Pairs[Index].Key, MoveTemp(Pairs[Index].Value));
+			return;
+		}
 		switch (Sorting)
 		{
 		case ETestMapSorting::E_NumberAsc:
@@ -232,11 +565,8 @@ UFUNCTION(BlueprintCallable, Category = "BA Container - Map"
 			, ToolTip = "Sort the keys of the map"))
 	FORCEINLINE void Map_KeySort()
 	{
-		this->BA_Map.KeySort([](const FGuid& A, const FGuid& B) 
-		{
-			return A.ToString() > B.ToString();
-		}
-		);
+		BA_CONTAINER_SCOPE("UTMap::Map_KeySort");
+		this->BA_Map.KeySort(FMapTestStruct::CompareKeyDescending);
 	}
 #pragma endregion Sorting Values and Kesys
 
@@ -246,22 +576,14 @@ UFUNCTION(BlueprintCallable, Category = "BA Container - Map"
 			, ToolTip = "Example to iterate over map values, adding a prefix to all Struct.Names"))
 	FORCEINLINE float Map_Iterate(UPARAM(ref) FString& Prefix)
 	{
-		// make parameter local
-		FString lPrefix = Prefix;
+		BA_CONTAINER_SCOPE("UTMap::Map_Iterate");
 		// for demonstration, we set a timer and report total time needed for operation
 		Timer t; t.Start();
-		TArray<FGuid> keys;
-		TArray<FMapTestStruct> values;
-		// get all keys from map and iterate		
-		this->BA_Map.GenerateKeyArray(keys);
-		for (FGuid& guid : keys)
-		{
-			FMapTestStruct* value = this->BA_Map.Find(guid);
-			if (value)
-				value->Name.InsertAt(0, lPrefix);
-		}
+		// iterating the pairs directly saves a key array and a hash lookup per value
+		const FContainerStringTransform AddPrefix(EContainerStringTransform::E_Prefix, Prefix);
+		for (TPair<FGuid, FMapTestStruct>& KvP : this->BA_Map)
+			AddPrefix.Apply(KvP.Value.Name);
 		return t.Stop();
-		// ==> took about 3200 CPU cycles
 	}
 
 	UFUNCTION(BlueprintCallable, Category = "BA Container - Map"
@@ -269,32 +591,163 @@ UFUNCTION(BlueprintCallable, Category = "BA Container - Map"
 			, ToolTip = "Example to parallel iterate over map values, adding a prefix to all Struct.Names"))
 	FORCEINLINE float Map_ParallelIterate(UPARAM(ref) FString& Prefix)
 	{
-		// make parameter local
-		FString lPrefix = Prefix;
+		BA_CONTAINER_SCOPE("UTMap::Map_ParallelIterate");
 		// for demonstration, we set a timer and report total time needed for operation
 		Timer t; t.Start();
-		// create vars
-		TArray<FGuid> keys;
-		TArray<FMapTestStruct> values;
-		// get all keys from map 		
-		this->BA_Map.GenerateKeyArray(keys);
-		// Iteration
-		FCriticalSection Mutex;
-		ParallelFor(keys.Num(), [&, lPrefix](int32 i)
-			{
-				FMapTestStruct* value = this->BA_Map.Find(keys[i]);
-				if (value)
-				{
-					//FScopeLock Lock(&Mutex);
-					value->Name.InsertAt(0, lPrefix);
-				}
-			}, EParallelForFlags::None);
+		Map_TransformNames(EContainerStringTransform::E_Prefix, Prefix, FString(), false);
 		return t.Stop();
-		// ==> took about 330 CPU cycles without lock
-		// ==> took about 26000 CPU cycles with lock
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Map"
+		, meta = (CompactNodeTitle = "Transform Names"
+			, ToolTip = "Adds a prefix or suffix to the names of all values, or replaces Text with Replacement in them (case sensitive), on worker threads. Every name is allocated once at its final size. SkipIfPresent leaves names that already have the prefix or suffix alone. Returns the number of changed names"))
+	FORCEINLINE int32 Map_TransformNames(EContainerStringTransform Transform, const FString& Text, const FString& Replacement, bool SkipIfPresent)
+	{
+		BA_CONTAINER_SCOPE("UTMap::Map_TransformNames");
+		// the values of a map can not be reached by index, so the workers get one pointer per name -
+		// every name is only touched by the chunk that owns its pointer, so no lock is needed
+		TArray<FString*> Names;
+		Names.Reserve(this->BA_Map.Num());
+		for (TPair<FGuid, FMapTestStruct>& KvP : this->BA_Map)
+			Names.Add(&KvP.Value.Name);
+		FString** Data = Names.GetData();
+		return FContainerStringTransform(Transform, Text, Replacement, SkipIfPresent).ApplyAll(Names.Num()
+			, [Data](int32 i) -> FString& { return *Data[i]; });
 	}
 #pragma endregion Iteration Examples
-	
+
+	#pragma region Bloom Filter
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Map"
+		, meta = (CompactNodeTitle = "Set Bloom Filter"
+			, ToolTip = "Puts a Bloom filter on the keys in front of Get Value, so most lookups of absent keys skip the hash probe. Sized automatically, costs about 10 bits per value"))
+	FORCEINLINE void Map_SetBloomFilterEnabled(bool Enabled)
+	{
+		this->BloomFilter.SetEnabled(Enabled);
+	}
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "BA Container - Map"
+		, meta = (CompactNodeTitle = "Bloom Filter Stats"
+			, ToolTip = "Returns how many lookups the Bloom filter answered and its false positive rate since it was enabled"))
+	FORCEINLINE FContainerBloomFilterStats Map_GetBloomFilterStats()
+	{
+		return this->BloomFilter.GetStats();
+	}
+#pragma endregion Bloom Filter
+
+	#pragma region Notifications
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Map"
+		, meta = (CompactNodeTitle = "Set Notify Mode"
+			, ToolTip = "Immediate fires the add and remove delegates with a copy of the value on every change. Batched collects the changed keys and fires OnMapChangesFlushed once per frame"))
+	FORCEINLINE void Map_SetNotifyMode(EContainerNotifyMode Mode)
+	{
+		// leaving batched mode flushes what was recorded so far
+		this->ChangeBatcher.SetMode(Mode, this, [this]() { Map_FlushNotifications(); });
+	}
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "BA Container - Map"
+		, meta = (CompactNodeTitle = "Notify Mode"
+			, ToolTip = "Returns how changes are reported"))
+	FORCEINLINE EContainerNotifyMode Map_GetNotifyMode()
+	{
+		return this->ChangeBatcher.GetMode();
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Map"
+		, meta = (CompactNodeTitle = "Flush Notifications"
+			, ToolTip = "Fires OnMapChangesFlushed with the changes collected so far instead of waiting for the next frame"))
+	FORCEINLINE void Map_FlushNotifications()
+	{
+		FContainerChangeBatch Batch;
+		if (this->ChangeBatcher.TakePending(Batch))
+			this->OnMapChangesFlushed_Delegate.Broadcast(Batch);
+	}
+#pragma endregion Notifications
 
 #pragma endregion Public Functions
+
+private:
+	// Fires OnMapAdd or, in batched mode, only records the key
+	void Map_NotifyAdded(const FMapTestStruct& Value)
+	{
+		if (!this->ChangeBatcher.IsBatched())
+		{
+			this->OnMapAdd_Delegate.Broadcast(Value);
+			return;
+		}
+		this->ChangeBatcher.Record([&Value](FContainerChangeBatch& Batch)
+		{
+			++Batch.NumAdded;
+			Batch.AddedKeys.Add(Value.Guid);
+		});
+	}
+
+	// Fires OnMapChangesFlushed with Changes or, in batched mode, adds them to the pending batch
+	void Map_NotifyBatch(FContainerChangeBatch&& Changes)
+	{
+		if (!this->ChangeBatcher.IsBatched())
+		{
+			this->OnMapChangesFlushed_Delegate.Broadcast(Changes);
+			return;
+		}
+		this->ChangeBatcher.Record([&Changes](FContainerChangeBatch& Batch)
+		{
+			Batch.Append(MoveTemp(Changes));
+		});
+	}
+
+	// Fires OnMapDelete or, in batched mode, only records the key
+	void Map_NotifyRemoved(const FMapTestStruct& Value)
+	{
+		if (!this->ChangeBatcher.IsBatched())
+		{
+			this->OnMapDelete_Delegate.Broadcast(Value);
+			return;
+		}
+		this->ChangeBatcher.Record([&Value](FContainerChangeBatch& Batch)
+		{
+			++Batch.NumRemoved;
+			Batch.RemovedKeys.Add(Value.Guid);
+		});
+	}
+
+	// Calls Visitor for the pairs [Offset, Offset + Count) of the iteration order, Page is reserved for them
+	template <typename PageType, typename VisitorType>
+	void Map_ForEachInPage(int32 Offset, int32 Count, PageType& Page, VisitorType&& Visitor) const
+	{
+		if (Offset < 0 || Count <= 0 || Offset >= this->BA_Map.Num())
+			return;
+		const int32 End = Offset + FMath::Min(Count, this->BA_Map.Num() - Offset);
+		Page.Reserve(End - Offset);
+		// TMap has no random access, skipping only steps the iterator and copies nothing
+		int32 Position = 0;
+		for (auto It = this->BA_Map.CreateConstIterator(); It && Position < End; ++It, ++Position)
+		{
+			if (Position >= Offset)
+				Visitor(It->Key, It->Value);
+		}
+	}
+
+	// Refills the Bloom filter if it is stale or too full
+	void Map_EnsureBloomFilter()
+	{
+		if (!this->BloomFilter.NeedsRebuild())
+			return;
+		this->BloomFilter.Rebuild(this->BA_Map.Num(), [this](FContainerBloomFilter& Filter)
+		{
+			for (const TPair<FGuid, FMapTestStruct>& KvP : this->BA_Map)
+				Filter.Add(FContainerBloomFilter::Hash(KvP.Key));
+		});
+	}
+
+	void Map_RebuildPopulationIndex()
+	{
+		BA_CONTAINER_SCOPE("UTMap::Map_RebuildPopulationIndex");
+		TArray<FMapPopulationKey> Entries;
+		Entries.Reserve(this->BA_Map.Num());
+		for (const TPair<FGuid, FMapTestStruct>& KvP : this->BA_Map)
+		{
+			Entries.Emplace(KvP.Value.Number, KvP.Key);
+		}
+		this->PopulationIndex.Build(MoveTemp(Entries));
+	}
 };
\ No newline at end of file
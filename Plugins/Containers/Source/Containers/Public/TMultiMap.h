@@ -9,6 +9,9 @@
 #include "Templates/SharedPointer.h"
 #include "Containers/Map.h"
 #include "Misc/Guid.h"
+#include "ContainerProfiler.h"
+#include "ContainerChangeBatch.h"
+#include "ContainerBloomFilter.h"
 
 #include "TMultiMap.generated.h"
 
@@ -77,11 +80,21 @@ public:
 		, meta = (ToolTip = "Delegate to indicate dequeue event on queue"))
 	FOnMultiMapChanged OnMultiMapRemoveFromKey_Delegate;
 
+	UPROPERTY(BlueprintAssignable, Category = "BA Container - MultiMap"
+		, meta = (ToolTip = "Delegate with the keys changed during the last frame, only fired in batched notify mode"))
+	FOnContainerChangesFlushed OnMultiMapChangesFlushed_Delegate;
+
 #pragma endregion Delegates
 
 private:
 	TMultiMap<FGuid, FTMultiMapTestStruct> BA_MultiMap;
 
+	// pending changes while in batched notify mode
+	FContainerChangeBatcher ChangeBatcher;
+
+	// optional filter on the key-value pairs in front of MM_KeyValueExist
+	FContainerBloomFilter BloomFilter;
+
 public:
 
 	#pragma region Public Functions
@@ -91,8 +104,106 @@ public:
 			, ToolTip = "Add a key-value association to the multi map."))
 	FORCEINLINE void MM_Add(UPARAM(ref) FGuid& Key, UPARAM(ref) FTMultiMapTestStruct& Value)
 	{
+		BA_CONTAINER_SCOPE("UTMultiMap::MM_Add");
 		this->BA_MultiMap.Add(Key, Value);
-		this->OnMultiMapAddKey_Delegate.Broadcast(Key);
+		this->BloomFilter.Add(FContainerBloomFilter::Hash(Key, Value.Number));
+		if (!this->ChangeBatcher.IsBatched())
+			this->OnMultiMapAddKey_Delegate.Broadcast(Key);
+		else
+			MM_RecordChange(Key, 1, true);
+	}
+
+	/**
+	 * Moves all Values into the multi map, keyed by their Guid, Values is empty afterwards.
+	 * Reserves once for all rows, so the multi map rehashes at most one time.
+	 * Native only - used by the bulk loaders, no delegate is broadcast.
+	 */
+	void MM_AppendMoved(TArray<FTMultiMapTestStruct>&& Values)
+	{
+		BA_CONTAINER_SCOPE("UTMultiMap::MM_AppendMoved");
+		this->BA_MultiMap.Reserve(this->BA_MultiMap.Num() + Values.Num());
+		for (FTMultiMapTestStruct& Value : Values)
+		{
+			const FGuid Key = Value.Guid;
+			this->BloomFilter.Add(FContainerBloomFilter::Hash(Key, Value.Number));
+			this->BA_MultiMap.Add(Key, MoveTemp(Value));
+		}
+		Values.Reset();
+	}
+
+	/**
+	 * Moves whole groups of values, every key once, with one reservation and - if Broadcast - one
+	 * notification listing each key once. Groups is empty afterwards. Native only - used by FContainerGroupBy.
+	 */
+	void MM_AddGroupsMoved(TArray<TPair<FGuid, TArray<FTMultiMapTestStruct>>>&& Groups, bool Broadcast)
+	{
+		BA_CONTAINER_SCOPE("UTMultiMap::MM_AddGroupsMoved");
+		FContainerChangeBatch Changes;
+		for (const TPair<FGuid, TArray<FTMultiMapTestStruct>>& Group : Groups)
+			Changes.NumAdded += Group.Value.Num();
+		this->BA_MultiMap.Reserve(this->BA_MultiMap.Num() + Changes.NumAdded);
+		if (Broadcast)
+			Changes.AddedKeys.Reserve(Groups.Num());
+		for (TPair<FGuid, TArray<FTMultiMapTestStruct>>& Group : Groups)
+		{
+			for (FTMultiMapTestStruct& Value : Group.Value)
+			{
+				this->BloomFilter.Add(FContainerBloomFilter::Hash(Group.Key, Value.Number));
+				this->BA_MultiMap.Add(Group.Key, MoveTemp(Value));
+			}
+			if (Broadcast)
+				Changes.AddedKeys.Add(Group.Key);
+		}
+		Groups.Reset();
+		if (Broadcast && Changes.NumAdded > 0)
+			MM_NotifyBatch(MoveTemp(Changes));
+	}
+
+	/**
+	 * The bulk functions report all keys in one FContainerChangeBatch on OnMultiMapChangesFlushed - right away in
+	 * immediate mode, with the next flush in batched mode - as the add and remove delegates carry only one key.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "BA Container - MultiMap"
+		, meta = (CompactNodeTitle = "Add Batch"
+			, ToolTip = "Moves all Values into the multi map, keyed by their Guid, with one reservation and one notification. Values is empty afterwards"))
+	FORCEINLINE void MM_AddBatch(UPARAM(ref) TArray<FTMultiMapTestStruct>& Values, bool Broadcast)
+	{
+		BA_CONTAINER_SCOPE("UTMultiMap::MM_AddBatch");
+		FContainerChangeBatch Changes;
+		if (Broadcast)
+		{
+			// the values are moved away, so the keys are taken before
+			Changes.NumAdded = Values.Num();
+			Changes.AddedKeys.Reserve(Values.Num());
+			for (const FTMultiMapTestStruct& Value : Values)
+				Changes.AddedKeys.Add(Value.Guid);
+		}
+		MM_AppendMoved(MoveTemp(Values));
+		if (Broadcast)
+			MM_NotifyBatch(MoveTemp(Changes));
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - MultiMap"
+		, meta = (CompactNodeTitle = "Remove Batch"
+			, ToolTip = "Removes all values of all Keys with one notification. Returns the number of removed values"))
+	FORCEINLINE int32 MM_RemoveBatch(const TArray<FGuid>& Keys, bool Broadcast)
+	{
+		BA_CONTAINER_SCOPE("UTMultiMap::MM_RemoveBatch");
+		FContainerChangeBatch Changes;
+		for (const FGuid& Key : Keys)
+		{
+			const int32 NumRemoved = this->BA_MultiMap.Remove(Key);
+			if (NumRemoved == 0)
+				continue;
+			Changes.NumRemoved += NumRemoved;
+			if (Broadcast)
+				Changes.RemovedKeys.Add(Key);
+		}
+		const int32 NumRemoved = Changes.NumRemoved;
+		this->BloomFilter.Remove(NumRemoved);
+		if (Broadcast && NumRemoved > 0)
+			MM_NotifyBatch(MoveTemp(Changes));
+		return NumRemoved;
 	}
 
 	UFUNCTION(BlueprintCallable, Category = "BA Container - MultiMap"
@@ -100,6 +211,7 @@ public:
 			, ToolTip = "Returns the number of values within this multi map associated with the specified key"))
 	FORCEINLINE int32 MM_NumberOfValues(UPARAM(ref) FGuid& Key)
 	{
+		BA_CONTAINER_SCOPE("UTMultiMap::MM_NumberOfValues");
 		return this->BA_MultiMap.Num(Key);
 	}
 
@@ -108,6 +220,7 @@ public:
 			, ToolTip = "Finds all values associated with the specified key"))
 	FORCEINLINE TArray<FTMultiMapTestStruct> MM_MultiFind(UPARAM(ref) FGuid& Key)
 	{
+		BA_CONTAINER_SCOPE("UTMultiMap::MM_MultiFind");
 		TArray<FTMultiMapTestStruct> FoundValues;
 		this->BA_MultiMap.MultiFind(Key, FoundValues);
 		return FoundValues;
@@ -118,8 +231,14 @@ public:
 			, ToolTip = "Remove all associations between the specified key and value from the multi map"))
 	FORCEINLINE int32 MM_RemoveAll(UPARAM(ref) FGuid& Key)
 	{
-		this->OnMultiMapRemoveFromKey_Delegate.Broadcast(Key);
-		return this->BA_MultiMap.Remove(Key);
+		BA_CONTAINER_SCOPE("UTMultiMap::MM_RemoveAll");
+		if (!this->ChangeBatcher.IsBatched())
+			this->OnMultiMapRemoveFromKey_Delegate.Broadcast(Key);
+		const int32 NumRemoved = this->BA_MultiMap.Remove(Key);
+		this->BloomFilter.Remove(NumRemoved);
+		if (this->ChangeBatcher.IsBatched())
+			MM_RecordChange(Key, NumRemoved, false);
+		return NumRemoved;
 	}
 
 	UFUNCTION(BlueprintCallable, Category = "BA Container - MultiMap"
@@ -127,8 +246,14 @@ public:
 			, ToolTip = "Remove the first association between the specified key and value from the map"))
 	FORCEINLINE int32 MM_RemoveFirst(UPARAM(ref) FGuid& Key, UPARAM(ref) FTMultiMapTestStruct& Value)
 	{
-		this->OnMultiMapRemoveFromKey_Delegate.Broadcast(Key);
-		return this->BA_MultiMap.RemoveSingle(Key, Value);
+		BA_CONTAINER_SCOPE("UTMultiMap::MM_RemoveFirst");
+		if (!this->ChangeBatcher.IsBatched())
+			this->OnMultiMapRemoveFromKey_Delegate.Broadcast(Key);
+		const int32 NumRemoved = this->BA_MultiMap.RemoveSingle(Key, Value);
+		this->BloomFilter.Remove(NumRemoved);
+		if (this->ChangeBatcher.IsBatched())
+			MM_RecordChange(Key, NumRemoved, false);
+		return NumRemoved;
 		return 1;
 	}
 
@@ -137,6 +262,7 @@ public:
 			, ToolTip = "Gets all keys of the multi map"))
 	FORCEINLINE TArray<FGuid> MM_GetKeys()
 	{
+		BA_CONTAINER_SCOPE("UTMultiMap::MM_GetKeys");
 		TArray<FGuid> keys;
 		this->BA_MultiMap.GetKeys(keys);
 		return keys;
@@ -147,7 +273,9 @@ public:
 			, ToolTip = "Empties the multi map - set NewCapacity to zero if you dont need to reserve space for new content, otherwise provide the expected capacity"))
 	FORCEINLINE void MM_Empty(int32 NewCapacity)
 	{
+		BA_CONTAINER_SCOPE("UTMultiMap::MM_Empty");
 		this->BA_MultiMap.Empty(NewCapacity);
+		this->BloomFilter.Invalidate();
 	}
 
 	UFUNCTION(BlueprintCallable, Category = "BA Container - MultiMap"
@@ -155,7 +283,16 @@ public:
 			, ToolTip = "Check if a given key-value pair exists"))
 	FORCEINLINE bool MM_KeyValueExist(UPARAM(ref) FGuid& Key, UPARAM(ref) FTMultiMapTestStruct& Value)
 	{
+		BA_CONTAINER_SCOPE("UTMultiMap::MM_KeyValueExist");
+		if (this->BloomFilter.IsEnabled())
+		{
+			MM_EnsureBloomFilter();
+			if (this->BloomFilter.Rejects(FContainerBloomFilter::Hash(Key, Value.Number)))
+				return false;
+		}
 		const FTMultiMapTestStruct* FoundValuePtr = this->BA_MultiMap.FindPair(Key, Value);
+		if (this->BloomFilter.IsEnabled())
+			this->BloomFilter.RecordLookup(FoundValuePtr != nullptr);
 		if (FoundValuePtr == nullptr)
 			return false;
 		else
@@ -167,6 +304,7 @@ public:
 			, ToolTip = "Gets all values of the multi map"))
 	FORCEINLINE TArray<FTMultiMapTestStruct> MM_GetAllValues()
 	{
+		BA_CONTAINER_SCOPE("UTMultiMap::MM_GetAllValues");
 		TSet<FGuid> keys;
 		TArray<FTMultiMapTestStruct> values;
 		// get all keys from multi map and iterate		
@@ -183,5 +321,150 @@ public:
 		return values;
 	}
 
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "BA Container - MultiMap"
+		, meta = (CompactNodeTitle = "Number of all values"
+			, ToolTip = "Returns the number of key-value pairs of the whole multi map"))
+	FORCEINLINE int32 MM_NumberOfAllValues()
+	{
+		return this->BA_MultiMap.Num();
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - MultiMap"
+		, meta = (CompactNodeTitle = "Values Page"
+			, ToolTip = "Returns up to Count values starting at Offset in iteration order. Use with Number of all values to page through large multi maps"))
+	FORCEINLINE TArray<FTMultiMapTestStruct> MM_GetValuesPage(int32 Offset, int32 Count)
+	{
+		BA_CONTAINER_SCOPE("UTMultiMap::MM_GetValuesPage");
+		TArray<FTMultiMapTestStruct> Page;
+		if (Offset < 0 || Count <= 0 || Offset >= this->BA_MultiMap.Num())
+			return Page;
+		const int32 End = Offset + FMath::Min(Count, this->BA_MultiMap.Num() - Offset);
+		Page.Reserve(End - Offset);
+		// no random access, skipping only steps the iterator and copies nothing
+		int32 Position = 0;
+		for (auto It = this->BA_MultiMap.CreateConstIterator(); It && Position < End; ++It, ++Position)
+		{
+			if (Position >= Offset)
+				Page.Add(It->Value);
+		}
+		return Page;
+	}
+
+	// Read-only access to the stored pairs, valid until the multi map is changed
+	FORCEINLINE const TMultiMap<FGuid, FTMultiMapTestStruct>& MM_View() const
+	{
+		return this->BA_MultiMap;
+	}
+
+	// Calls Visitor(const FGuid&, const FTMultiMapTestStruct&) for every pair in iteration order, without copying
+	template <typename VisitorType>
+	void MM_ForEach(VisitorType&& Visitor) const
+	{
+		for (const TPair<FGuid, FTMultiMapTestStruct>& KvP : this->BA_MultiMap)
+			Visitor(KvP.Key, KvP.Value);
+	}
+
+	// Calls Visitor(const FTMultiMapTestStruct&) for every value of Key, without copying them into an array
+	template <typename VisitorType>
+	void MM_ForEachValue(const FGuid& Key, VisitorType&& Visitor) const
+	{
+		for (auto It = this->BA_MultiMap.CreateConstKeyIterator(Key); It; ++It)
+			Visitor(It.Value());
+	}
+
+	#pragma region Bloom Filter
+	UFUNCTION(BlueprintCallable, Category = "BA Container - MultiMap"
+		, meta = (CompactNodeTitle = "Set Bloom Filter"
+			, ToolTip = "Puts a Bloom filter on the key-value pairs in front of KvP Exists, so most checks of absent pairs skip the key probe. Sized automatically, costs about 10 bits per value"))
+	FORCEINLINE void MM_SetBloomFilterEnabled(bool Enabled)
+	{
+		this->BloomFilter.SetEnabled(Enabled);
+	}
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "BA Container - MultiMap"
+		, meta = (CompactNodeTitle = "Bloom Filter Stats"
+			, ToolTip = "Returns how many checks the Bloom filter answered and its false positive rate since it was enabled"))
+	FORCEINLINE FContainerBloomFilterStats MM_GetBloomFilterStats()
+	{
+		return this->BloomFilter.GetStats();
+	}
+#pragma endregion Bloom Filter
+
+	#pragma region Notifications
+	UFUNCTION(BlueprintCallable, Category = "BA Container - MultiMap"
+		, meta = (CompactNodeTitle = "Set Notify Mode"
+			, ToolTip = "Immediate fires the add and remove delegates on every change. Batched collects the changed keys and fires OnMultiMapChangesFlushed once per frame"))
+	FORCEINLINE void MM_SetNotifyMode(EContainerNotifyMode Mode)
+	{
+		// leaving batched mode flushes what was recorded so far
+		this->ChangeBatcher.SetMode(Mode, this, [this]() { MM_FlushNotifications(); });
+	}
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "BA Container - MultiMap"
+		, meta = (CompactNodeTitle = "Notify Mode"
+			, ToolTip = "Returns how changes are reported"))
+	FORCEINLINE EContainerNotifyMode MM_GetNotifyMode()
+	{
+		return this->ChangeBatcher.GetMode();
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - MultiMap"
+		, meta = (CompactNodeTitle = "Flush Notifications"
+			, ToolTip = "Fires OnMultiMapChangesFlushed with the changes collected so far instead of waiting for the next frame"))
+	FORCEINLINE void MM_FlushNotifications()
+	{
+		FContainerChangeBatch Batch;
+		if (this->ChangeBatcher.TakePending(Batch))
+			this->OnMultiMapChangesFlushed_Delegate.Broadcast(Batch);
+	}
+#pragma endregion Notifications
+
 #pragma endregion Public Functions
+
+private:
+	// Fires OnMultiMapChangesFlushed with Changes or, in batched mode, adds them to the pending batch
+	void MM_NotifyBatch(FContainerChangeBatch&& Changes)
+	{
+		if (!this->ChangeBatcher.IsBatched())
+		{
+			this->OnMultiMapChangesFlushed_Delegate.Broadcast(Changes);
+			return;
+		}
+		this->ChangeBatcher.Record([&Changes](FContainerChangeBatch& Batch)
+		{
+			Batch.Append(MoveTemp(Changes));
+		});
+	}
+
+	// Refills the Bloom filter if it is stale or too full
+	void MM_EnsureBloomFilter()
+	{
+		if (!this->BloomFilter.NeedsRebuild())
+			return;
+		this->BloomFilter.Rebuild(this->BA_MultiMap.Num(), [this](FContainerBloomFilter& Filter)
+		{
+			for (const TPair<FGuid, FTMultiMapTestStruct>& KvP : this->BA_MultiMap)
+				Filter.Add(FContainerBloomFilter::Hash(KvP.Key, KvP.Value.Number));
+		});
+	}
+
+	// Records Count added or removed values of Key, the key is listed once per call
+	void MM_RecordChange(const FGuid& Key, int32 Count, bool bAdded)
+	{
+		if (Count <= 0)
+			return;
+		this->ChangeBatcher.Record([&Key, Count, bAdded](FContainerChangeBatch& Batch)
+		{
+			if (bAdded)
+			{
+				Batch.NumAdded += Count;
+				Batch.AddedKeys.Add(Key);
+			}
+			else
+			{
+				Batch.NumRemoved += Count;
+				Batch.RemovedKeys.Add(Key);
+			}
+		});
+	}
 };
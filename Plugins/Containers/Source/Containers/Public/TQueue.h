@@ -7,6 +7,11 @@
 #include "CoreMinimal.h"
 #include "UObject/NoExportTypes.h"
 #include "Containers/Queue.h"
+#include "HAL/Event.h"
+#include "ContainerProfiler.h"
+#include "ContainerChangeBatch.h"
+#include "QueueInstrumentation.h"
+#include <atomic>
 
 #include "TQueue.generated.h"
 
@@ -35,6 +40,47 @@ public:
  */
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnQueueChanged, bool, changed);
 
+/**
+ * Lets consumers of a UTQueue sleep until there is something to do.
+ * Producers only trigger the event while a consumer waits, otherwise an enqueue pays one atomic load.
+ */
+class FQueueItemsSignal
+{
+public:
+	// Producer side, after an item was enqueued
+	FORCEINLINE void Notify()
+	{
+		if (this->NumWaiting.load() > 0)
+			this->Event->Trigger();
+	}
+
+	// Wakes every waiting consumer, e.g. to let it see a stop request
+	void WakeAll()
+	{
+		this->Event->Trigger();
+	}
+
+	/**
+	 * Blocks until Notify or WakeAll, unless HasWork() is true once the wait is announced.
+	 * Another consumer starting to wait may swallow a wake-up that came before - it checks HasWork
+	 * right after and takes the work itself, so nothing is lost.
+	 */
+	template <typename PredicateType>
+	void Wait(PredicateType&& HasWork)
+	{
+		this->NumWaiting.fetch_add(1);
+		this->Event->Reset();
+		// work that came before the reset is seen here, work after it triggers the event again
+		if (!HasWork())
+			this->Event->Wait();
+		this->NumWaiting.fetch_sub(1);
+	}
+
+private:
+	FEventRef Event{ EEventMode::ManualReset };
+	std::atomic<int32> NumWaiting{ 0 };
+};
+
 
 /**
  * Class to encapsulate TQueue
@@ -68,11 +114,36 @@ public:
 		, meta = (ToolTip = "Delegate to indicate dequeue event on queue"))
 	FOnQueueChanged OnQueue_Dequeue_Delegate;
 
+	UPROPERTY(BlueprintAssignable, Category = "BA Container - Queue"
+		, meta = (ToolTip = "Delegate with the number of enqueued and dequeued items of the last frame, only fired in batched notify mode"))
+	FOnContainerChangesFlushed OnQueueChangesFlushed_Delegate;
+
 #pragma endregion Delegates
 
 private:
+	// item plus its enqueue time, 0 if it was enqueued while the queue was not instrumented
+	struct FQueueEntry
+	{
+		FQueueTestStruct Item;
+		uint64 EnqueueNanoseconds = 0;
+	};
+
 	// Standard is Multiple-producers single-consumer (MPSC) 
-	TQueue<FQueueTestStruct, EQueueMode::Mpsc> BA_Queue;
+	TQueue<FQueueEntry, EQueueMode::Mpsc> BA_Queue;
+
+	// created on the first SetInstrumented(true) and kept, producers on other threads may still use it
+	TUniquePtr<FQueueInstrumentation> Instrumentation;
+	std::atomic<bool> bInstrumented{ false };
+
+	// TQueue allows a single consumer at a time - taken by every function that removes or peeks
+	UE::FSpinLock ConsumerLock;
+
+	// pending changes while in batched notify mode - producers on other threads only count,
+	// the flush always runs on the game thread
+	FContainerChangeBatcher ChangeBatcher;
+
+	// wakes consumers that sleep until items arrive
+	FQueueItemsSignal ItemsSignal;
 
 public:
 
@@ -83,8 +154,16 @@ public:
 			, ToolTip = "Adds an item to the head of the queue"))
 	FORCEINLINE void Enqueue(UPARAM(ref) FQueueTestStruct& QueueItem)
 	{
-		this->BA_Queue.Enqueue(QueueItem);
-		this->OnQueue_Enqueue_Delegate.Broadcast(true);
+		BA_CONTAINER_SCOPE("UTQueue::Enqueue");
+		FQueueEntry Entry{ QueueItem };
+		if (this->bInstrumented.load(std::memory_order_acquire))
+			Entry.EnqueueNanoseconds = this->Instrumentation->OnEnqueue();
+		this->BA_Queue.Enqueue(MoveTemp(Entry));
+		this->ItemsSignal.Notify();
+		if (!this->ChangeBatcher.IsBatched())
+			this->OnQueue_Enqueue_Delegate.Broadcast(true);
+		else
+			this->ChangeBatcher.Record([](FContainerChangeBatch& Batch) { ++Batch.NumAdded; });
 	}
 
 	UFUNCTION(BlueprintCallable, Category = "BA Container - Queue"
@@ -92,10 +171,14 @@ public:
 			, ToolTip = "Removes and returns the item from the tail of the queue"))
 	FORCEINLINE FQueueTestStruct Dequeue()
 	{
-		FQueueTestStruct QueueItem;
-		this->BA_Queue.Dequeue(QueueItem);
-		this->OnQueue_Dequeue_Delegate.Broadcast(true);
-		return QueueItem;
+		BA_CONTAINER_SCOPE("UTQueue::Dequeue");
+		FQueueEntry Entry;
+		const bool bDequeued = Queue_DequeueEntry(Entry);
+		if (!this->ChangeBatcher.IsBatched())
+			this->OnQueue_Dequeue_Delegate.Broadcast(true);
+		else if (bDequeued)
+			this->ChangeBatcher.Record([](FContainerChangeBatch& Batch) { ++Batch.NumRemoved; });
+		return MoveTemp(Entry.Item);
 	}
 
 	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "BA Container - Queue"
@@ -103,6 +186,9 @@ public:
 			, ToolTip = "Checks whether the queue is empty"))
 	FORCEINLINE bool IsEmpty()
 	{
+		BA_CONTAINER_SCOPE("UTQueue::IsEmpty");
+		// reads the consumer end, which another consumer may be freeing right now
+		UE::TScopeLock<UE::FSpinLock> Lock(this->ConsumerLock);
 		return this->BA_Queue.IsEmpty();
 	}
 
@@ -111,9 +197,11 @@ public:
 			, ToolTip = "Peek at the queue's tail item without removing it"))
 	FORCEINLINE FQueueTestStruct Peek()
 	{
-		FQueueTestStruct QueueItem;
-		this->BA_Queue.Peek(QueueItem);
-		return QueueItem;
+		BA_CONTAINER_SCOPE("UTQueue::Peek");
+		UE::TScopeLock<UE::FSpinLock> Lock(this->ConsumerLock);
+		if (const FQueueEntry* Entry = this->BA_Queue.Peek())
+			return Entry->Item;
+		return FQueueTestStruct();
 	}
 
 	UFUNCTION(BlueprintCallable, Category = "BA Container - Queue"
@@ -121,8 +209,161 @@ public:
 			, ToolTip = "Removes the item from the tail of the queue. Returns true if a value was removed, false if the queue was empty"))
 	FORCEINLINE bool Pop()
 	{
+		BA_CONTAINER_SCOPE("UTQueue::Pop");
+		UE::TScopeLock<UE::FSpinLock> Lock(this->ConsumerLock);
+		const FQueueEntry* Entry = this->BA_Queue.Peek();
+		if (Entry == nullptr)
+			return false;
+		if (Entry->EnqueueNanoseconds != 0)
+			this->Instrumentation->OnDequeue(Entry->EnqueueNanoseconds);
 		return this->BA_Queue.Pop();
 	}
 
+	/**
+	 * Moves up to MaxItems items to the end of OutItems with one take of the consumer lock.
+	 * With Wait false it returns 0 right away if another consumer holds the lock.
+	 * Native only - meant for worker threads, so no delegate is broadcast; batched notify mode still counts the items.
+	 */
+	int32 DequeueBatch(TArray<FQueueTestStruct>& OutItems, int32 MaxItems, bool Wait = true)
+	{
+		BA_CONTAINER_SCOPE("UTQueue::DequeueBatch");
+		if (Wait)
+			this->ConsumerLock.Lock();
+		else if (!this->ConsumerLock.TryLock())
+			return 0;
+		int32 NumDequeued = 0;
+		FQueueEntry Entry;
+		while (NumDequeued < MaxItems && this->BA_Queue.Dequeue(Entry))
+		{
+			if (Entry.EnqueueNanoseconds != 0)
+				this->Instrumentation->OnDequeue(Entry.EnqueueNanoseconds);
+			OutItems.Add(MoveTemp(Entry.Item));
+			++NumDequeued;
+		}
+		this->ConsumerLock.Unlock();
+		if (NumDequeued > 0 && this->ChangeBatcher.IsBatched())
+			this->ChangeBatcher.Record([NumDequeued](FContainerChangeBatch& Batch) { Batch.NumRemoved += NumDequeued; });
+		return NumDequeued;
+	}
+
+	/**
+	 * Enqueues all Items in their order, Items is empty afterwards.
+	 * Native only - used by the queue snapshots, so no delegate is broadcast; batched notify mode still counts the items.
+	 */
+	void EnqueueMoved(TArray<FQueueTestStruct>&& Items)
+	{
+		BA_CONTAINER_SCOPE("UTQueue::EnqueueMoved");
+		const bool bTimestamps = this->bInstrumented.load(std::memory_order_acquire);
+		for (FQueueTestStruct& Item : Items)
+		{
+			FQueueEntry Entry{ MoveTemp(Item) };
+			if (bTimestamps)
+				Entry.EnqueueNanoseconds = this->Instrumentation->OnEnqueue();
+			this->BA_Queue.Enqueue(MoveTemp(Entry));
+		}
+		const int32 NumEnqueued = Items.Num();
+		Items.Reset();
+		if (NumEnqueued > 0)
+			this->ItemsSignal.Notify();
+		if (NumEnqueued > 0 && this->ChangeBatcher.IsBatched())
+			this->ChangeBatcher.Record([NumEnqueued](FContainerChangeBatch& Batch) { Batch.NumAdded += NumEnqueued; });
+	}
+
+	// Consumers that want to sleep until items arrive wait on this, see UTQueueConsumerPool
+	FORCEINLINE FQueueItemsSignal& GetItemsSignal()
+	{
+		return this->ItemsSignal;
+	}
+
+	#pragma region Instrumentation
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Queue"
+		, meta = (CompactNodeTitle = "Set Instrumented"
+			, ToolTip = "Tracks depth, high-water mark, rates and latency of items enqueued from now on. Costs a timestamp per item and one counter increment per call"))
+	FORCEINLINE void SetInstrumented(bool Instrumented)
+	{
+		BA_CONTAINER_SCOPE("UTQueue::SetInstrumented");
+		if (Instrumented == this->bInstrumented.load(std::memory_order_relaxed))
+			return;
+		if (Instrumented)
+		{
+			if (!this->Instrumentation.IsValid())
+				this->Instrumentation = MakeUnique<FQueueInstrumentation>();
+			else
+				this->Instrumentation->Reset();
+		}
+		// items enqueued while instrumented keep their timestamp and are still counted on dequeue
+		this->bInstrumented.store(Instrumented, std::memory_order_release);
+	}
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "BA Container - Queue"
+		, meta = (CompactNodeTitle = "Is Instrumented?"
+			, ToolTip = "Checks whether the queue collects metrics"))
+	FORCEINLINE bool IsInstrumented()
+	{
+		return this->bInstrumented.load(std::memory_order_relaxed);
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Queue"
+		, meta = (CompactNodeTitle = "Get Metrics"
+			, ToolTip = "Gets depth, high-water mark, totals, latency and the rates since the previous call. Only items enqueued while instrumented are counted"))
+	FORCEINLINE FQueueMetrics GetMetrics()
+	{
+		BA_CONTAINER_SCOPE("UTQueue::GetMetrics");
+		if (!this->Instrumentation.IsValid())
+			return FQueueMetrics();
+		return this->Instrumentation->Sample();
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Queue"
+		, meta = (CompactNodeTitle = "Reset Metrics"
+			, ToolTip = "Restarts totals, high-water mark and latency from now on, the depth stays"))
+	FORCEINLINE void ResetMetrics()
+	{
+		if (this->Instrumentation.IsValid())
+			this->Instrumentation->Reset();
+	}
+#pragma endregion Instrumentation
+
+	#pragma region Notifications
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Queue"
+		, meta = (CompactNodeTitle = "Set Notify Mode"
+			, ToolTip = "Immediate fires the enqueue and dequeue delegates on every call. Batched counts them and fires OnQueueChangesFlushed once per frame on the game thread"))
+	FORCEINLINE void SetNotifyMode(EContainerNotifyMode Mode)
+	{
+		// leaving batched mode flushes what was recorded so far
+		this->ChangeBatcher.SetMode(Mode, this, [this]() { FlushNotifications(); });
+	}
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "BA Container - Queue"
+		, meta = (CompactNodeTitle = "Notify Mode"
+			, ToolTip = "Returns how changes are reported"))
+	FORCEINLINE EContainerNotifyMode GetNotifyMode()
+	{
+		return this->ChangeBatcher.GetMode();
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Queue"
+		, meta = (CompactNodeTitle = "Flush Notifications"
+			, ToolTip = "Fires OnQueueChangesFlushed with the changes counted so far instead of waiting for the next frame"))
+	FORCEINLINE void FlushNotifications()
+	{
+		FContainerChangeBatch Batch;
+		if (this->ChangeBatcher.TakePending(Batch))
+			this->OnQueueChangesFlushed_Delegate.Broadcast(Batch);
+	}
+#pragma endregion Notifications
+
 #pragma endregion Public Functions
+
+private:
+	// Dequeues under the consumer lock and reports the item to the instrumentation
+	bool Queue_DequeueEntry(FQueueEntry& OutEntry)
+	{
+		UE::TScopeLock<UE::FSpinLock> Lock(this->ConsumerLock);
+		if (!this->BA_Queue.Dequeue(OutEntry))
+			return false;
+		if (OutEntry.EnqueueNanoseconds != 0)
+			this->Instrumentation->OnDequeue(OutEntry.EnqueueNanoseconds);
+		return true;
+	}
 };
@@ -0,0 +1,280 @@
+// Developer Bastian © 2024
+// License Creative Commons DEED 4.0 (https://creativecommons.org/licenses/by-sa/4.0/deed.en)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "BoundedMpmcQueue.h"
+#include "TQueue.h"
+#include "ContainerProfiler.h"
+#include "ContainerChangeBatch.h"
+#include <atomic>
+
+#include "TRingQueue.generated.h"
+
+/**
+ * Class to encapsulate a bounded ring buffer queue - same Blueprint surface as UTQueue.
+ *
+ * Unlike TQueue, which allocates a node per item and allows a single consumer, the ring buffer
+ * allocates its cells once and is safe for multiple producers and multiple consumers (MPMC).
+ * In exchange it is bounded: a full queue rejects new items instead of growing. Enqueue reports
+ * this with its return value and every rejection is counted, see RingQueue_GetRejectedCount.
+ */
+UCLASS(BlueprintType, Transient)
+class UTRingQueue : public UObject
+{
+	GENERATED_BODY()
+
+public:
+
+	UTRingQueue()
+		: BA_Queue(MakeUnique<TBoundedMpmcQueue<FQueueTestStruct>>(DefaultCapacity))
+	{}
+
+	#pragma region Delegates
+
+	UPROPERTY(BlueprintAssignable, Category = "BA Container - Ring Queue"
+		, meta = (ToolTip = "Delegate to indicate enqueue event on queue"))
+	FOnQueueChanged OnQueue_Enqueue_Delegate;
+
+	UPROPERTY(BlueprintAssignable, Category = "BA Container - Ring Queue"
+		, meta = (ToolTip = "Delegate to indicate dequeue event on queue"))
+	FOnQueueChanged OnQueue_Dequeue_Delegate;
+
+	UPROPERTY(BlueprintAssignable, Category = "BA Container - Ring Queue"
+		, meta = (ToolTip = "Delegate with the number of enqueued and dequeued items of the last frame, only fired in batched notify mode"))
+	FOnContainerChangesFlushed OnQueueChangesFlushed_Delegate;
+
+#pragma endregion Delegates
+
+	static constexpr int32 DefaultCapacity = 1024;
+
+private:
+	TUniquePtr<TBoundedMpmcQueue<FQueueTestStruct>> BA_Queue;
+
+	// number of items rejected because the queue was full
+	std::atomic<int64> RejectedCount{ 0 };
+
+	// pending changes while in batched notify mode
+	FContainerChangeBatcher ChangeBatcher;
+
+public:
+
+	#pragma region Public Functions
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Ring Queue"
+		, meta = (CompactNodeTitle = "Set Capacity"
+			, ToolTip = "Replaces the ring buffer by an empty one with at least Capacity cells (rounded up to a power of two). Drops all queued items - call before producers and consumers start"))
+	FORCEINLINE void RingQueue_SetCapacity(int32 Capacity)
+	{
+		BA_CONTAINER_SCOPE("UTRingQueue::RingQueue_SetCapacity");
+		this->BA_Queue = MakeUnique<TBoundedMpmcQueue<FQueueTestStruct>>((uint32)FMath::Max(Capacity, 2));
+		this->RejectedCount = 0;
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Ring Queue"
+		, meta = (CompactNodeTitle = "Enqueue to Queue"
+			, ToolTip = "Adds an item to the head of the queue. Returns false if the queue is full, the item is not added then"))
+	FORCEINLINE bool Enqueue(UPARAM(ref) FQueueTestStruct& QueueItem)
+	{
+		BA_CONTAINER_SCOPE("UTRingQueue::Enqueue");
+		if (!RingQueue_Push(QueueItem))
+			return false;
+		RingQueue_NotifyAdded(1);
+		return true;
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Ring Queue"
+		, meta = (CompactNodeTitle = "Try Enqueue"
+			, ToolTip = "Same as Enqueue, but also returns how full the queue is afterwards (0 to 1) so producers can slow down before items get rejected"))
+	FORCEINLINE bool TryEnqueue(UPARAM(ref) FQueueTestStruct& QueueItem, float& FillRatio)
+	{
+		BA_CONTAINER_SCOPE("UTRingQueue::TryEnqueue");
+		const bool bAdded = RingQueue_Push(QueueItem);
+		if (bAdded)
+			RingQueue_NotifyAdded(1);
+		FillRatio = RingQueue_GetFillRatio();
+		return bAdded;
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Ring Queue"
+		, meta = (CompactNodeTitle = "Enqueue Batch"
+			, ToolTip = "Moves items to the queue in order until it is full, with one notification. Returns the number of added items - the rejected ones stay in Items"))
+	FORCEINLINE int32 EnqueueBatch(UPARAM(ref) TArray<FQueueTestStruct>& Items)
+	{
+		BA_CONTAINER_SCOPE("UTRingQueue::EnqueueBatch");
+		int32 NumAdded = 0;
+		while (NumAdded < Items.Num() && this->BA_Queue->TryEnqueue(MoveTemp(Items[NumAdded])))
+			++NumAdded;
+		if (NumAdded < Items.Num())
+			this->RejectedCount += Items.Num() - NumAdded;
+		Items.RemoveAt(0, NumAdded, false);
+		RingQueue_NotifyAdded(NumAdded);
+		return NumAdded;
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Ring Queue"
+		, meta = (CompactNodeTitle = "Dequeue from Queue"
+			, ToolTip = "Removes and returns the item from the tail of the queue"))
+	FORCEINLINE FQueueTestStruct Dequeue()
+	{
+		BA_CONTAINER_SCOPE("UTRingQueue::Dequeue");
+		FQueueTestStruct QueueItem;
+		if (this->BA_Queue->TryDequeue(QueueItem))
+			RingQueue_NotifyRemoved(1);
+		return QueueItem;
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Ring Queue"
+		, meta = (CompactNodeTitle = "Try Dequeue"
+			, ToolTip = "Removes the item from the tail of the queue. Returns false if the queue was empty"))
+	FORCEINLINE bool TryDequeue(FQueueTestStruct& QueueItem)
+	{
+		BA_CONTAINER_SCOPE("UTRingQueue::TryDequeue");
+		if (!this->BA_Queue->TryDequeue(QueueItem))
+			return false;
+		RingQueue_NotifyRemoved(1);
+		return true;
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Ring Queue"
+		, meta = (CompactNodeTitle = "Dequeue Batch"
+			, ToolTip = "Removes up to MaxItems items from the tail of the queue with one notification"))
+	FORCEINLINE TArray<FQueueTestStruct> DequeueBatch(int32 MaxItems)
+	{
+		BA_CONTAINER_SCOPE("UTRingQueue::DequeueBatch");
+		TArray<FQueueTestStruct> Items;
+		Items.Reserve(FMath::Clamp(MaxItems, 0, (int32)this->BA_Queue->Num()));
+		FQueueTestStruct QueueItem;
+		while (Items.Num() < MaxItems && this->BA_Queue->TryDequeue(QueueItem))
+			Items.Add(MoveTemp(QueueItem));
+		RingQueue_NotifyRemoved(Items.Num());
+		return Items;
+	}
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "BA Container - Ring Queue"
+		, meta = (CompactNodeTitle = "Queue Empty?"
+			, ToolTip = "Checks whether the queue is empty"))
+	FORCEINLINE bool IsEmpty()
+	{
+		BA_CONTAINER_SCOPE("UTRingQueue::IsEmpty");
+		return this->BA_Queue->IsEmpty();
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Ring Queue"
+		, meta = (CompactNodeTitle = "Peek Queue"
+			, ToolTip = "Peek at the queue's tail item without removing it. Safe while other threads dequeue"))
+	FORCEINLINE FQueueTestStruct Peek()
+	{
+		BA_CONTAINER_SCOPE("UTRingQueue::Peek");
+		FQueueTestStruct QueueItem;
+		this->BA_Queue->Peek(QueueItem);
+		return QueueItem;
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Ring Queue"
+		, meta = (CompactNodeTitle = "Pop Queue"
+			, ToolTip = "Removes the item from the tail of the queue. Returns true if a value was removed, false if the queue was empty"))
+	FORCEINLINE bool Pop()
+	{
+		BA_CONTAINER_SCOPE("UTRingQueue::Pop");
+		FQueueTestStruct QueueItem;
+		return this->BA_Queue->TryDequeue(QueueItem);
+	}
+
+	#pragma region Backpressure
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "BA Container - Ring Queue"
+		, meta = (CompactNodeTitle = "Number of items"
+			, ToolTip = "Returns the number of queued items - a snapshot while other threads enqueue or dequeue"))
+	FORCEINLINE int32 RingQueue_Num()
+	{
+		return (int32)this->BA_Queue->Num();
+	}
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "BA Container - Ring Queue"
+		, meta = (CompactNodeTitle = "Capacity"
+			, ToolTip = "Returns the number of cells of the ring buffer"))
+	FORCEINLINE int32 RingQueue_GetCapacity()
+	{
+		return (int32)this->BA_Queue->Capacity();
+	}
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "BA Container - Ring Queue"
+		, meta = (CompactNodeTitle = "Fill Ratio"
+			, ToolTip = "Returns how full the queue is, from 0 (empty) to 1 (full)"))
+	FORCEINLINE float RingQueue_GetFillRatio()
+	{
+		return (float)this->BA_Queue->Num() / (float)this->BA_Queue->Capacity();
+	}
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "BA Container - Ring Queue"
+		, meta = (CompactNodeTitle = "Rejected Items"
+			, ToolTip = "Returns the number of items rejected because the queue was full since the last Set Capacity"))
+	FORCEINLINE int64 RingQueue_GetRejectedCount()
+	{
+		return this->RejectedCount.load(std::memory_order_relaxed);
+	}
+#pragma endregion Backpressure
+
+	#pragma region Notifications
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Ring Queue"
+		, meta = (CompactNodeTitle = "Set Notify Mode"
+			, ToolTip = "Immediate fires the enqueue and dequeue delegates on every call. Batched counts them and fires OnQueueChangesFlushed once per frame on the game thread"))
+	FORCEINLINE void SetNotifyMode(EContainerNotifyMode Mode)
+	{
+		// leaving batched mode flushes what was recorded so far
+		this->ChangeBatcher.SetMode(Mode, this, [this]() { FlushNotifications(); });
+	}
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "BA Container - Ring Queue"
+		, meta = (CompactNodeTitle = "Notify Mode"
+			, ToolTip = "Returns how changes are reported"))
+	FORCEINLINE EContainerNotifyMode GetNotifyMode()
+	{
+		return this->ChangeBatcher.GetMode();
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Ring Queue"
+		, meta = (CompactNodeTitle = "Flush Notifications"
+			, ToolTip = "Fires OnQueueChangesFlushed with the changes counted so far instead of waiting for the next frame"))
+	FORCEINLINE void FlushNotifications()
+	{
+		FContainerChangeBatch Batch;
+		if (this->ChangeBatcher.TakePending(Batch))
+			this->OnQueueChangesFlushed_Delegate.Broadcast(Batch);
+	}
+#pragma endregion Notifications
+
+#pragma endregion Public Functions
+
+private:
+	// Enqueues a copy of QueueItem and counts the rejection if the queue is full
+	FORCEINLINE bool RingQueue_Push(const FQueueTestStruct& QueueItem)
+	{
+		if (this->BA_Queue->TryEnqueue(QueueItem))
+			return true;
+		++this->RejectedCount;
+		return false;
+	}
+
+	void RingQueue_NotifyAdded(int32 Count)
+	{
+		if (Count <= 0)
+			return;
+		if (!this->ChangeBatcher.IsBatched())
+			this->OnQueue_Enqueue_Delegate.Broadcast(true);
+		else
+			this->ChangeBatcher.Record([Count](FContainerChangeBatch& Batch) { Batch.NumAdded += Count; });
+	}
+
+	void RingQueue_NotifyRemoved(int32 Count)
+	{
+		if (Count <= 0)
+			return;
+		if (!this->ChangeBatcher.IsBatched())
+			this->OnQueue_Dequeue_Delegate.Broadcast(true);
+		else
+			this->ChangeBatcher.Record([Count](FContainerChangeBatch& Batch) { Batch.NumRemoved += Count; });
+	}
+};
@@ -10,6 +10,13 @@
 #include "Templates/SharedPointer.h"
 #include "Containers/Set.h"
 #include "Misc/Guid.h"
+#include "ContainerProfiler.h"
+#include "NamePrefixIndex.h"
+#include "ContainerSort.h"
+#include "ContainerFilterKernels.h"
+#include "ContainerChangeBatch.h"
+#include "ContainerBloomFilter.h"
+#include <atomic>
 
 #include "TSet.generated.h"
 
@@ -113,12 +120,28 @@ public:
 		, meta = (ToolTip = "Delegate to indicate dequeue event on queue"))
 	FOnSetChanged OnSetRemove_Delegate;
 
+	UPROPERTY(BlueprintAssignable, Category = "BA Container - Set"
+		, meta = (ToolTip = "Delegate with the changes of the last frame, only fired in batched notify mode. The set has no positions, AddedNumbers and RemovedNumbers hold the Number of the changed values"))
+	FOnContainerChangesFlushed OnSetChangesFlushed_Delegate;
+
 #pragma endregion Delegates
 
 private:
 	TSet<FTSetTestStruct> BA_Set;
 
+	// lower-cased names with their element id, built on the first prefix query
+	TNamePrefixIndex<FSetElementId> NameIndex;
+
+	// pending changes while in batched notify mode
+	FContainerChangeBatcher ChangeBatcher;
+
+	// optional filter on the Numbers in front of Set_ItemExists
+	FContainerBloomFilter BloomFilter;
+
 public:
+	// below this many values the set algebra functions run on the calling thread
+	static constexpr int32 SetAlgebraParallelThreshold = 16384;
+
 	#pragma region Public Functions
 
 	UFUNCTION(BlueprintCallable, Category = "BA Container - Set"
@@ -126,8 +149,69 @@ public:
 			, ToolTip = "Add an item to the Set"))
 	FORCEINLINE void Set_Add(UPARAM(ref) FTSetTestStruct& Value)
 	{
-		this->BA_Set.Add(Value);
-		this->OnSetAdd_Delegate.Broadcast(true);
+		BA_CONTAINER_SCOPE("UTSet::Set_Add");
+		Set_AddIndexed(Value);
+		Set_NotifyAdded(MakeArrayView(&Value.Number, 1));
+	}
+
+	/**
+	 * Moves all Values into the set, Values is empty afterwards.
+	 * Reserves once for all rows, so the set rehashes at most one time.
+	 * Native only - used by the bulk loaders, so there is just one broadcast for all rows.
+	 */
+	void Set_AppendMoved(TArray<FTSetTestStruct>&& Values, bool Broadcast)
+	{
+		BA_CONTAINER_SCOPE("UTSet::Set_AppendMoved");
+		// a batch larger than the set is cheaper to index with the next rebuild
+		if (Values.Num() > this->BA_Set.Num())
+			this->NameIndex.Invalidate();
+		// the values are moved away, a batch needs their numbers before
+		TArray<int32> Numbers;
+		if (Broadcast && this->ChangeBatcher.IsBatched())
+		{
+			Numbers.Reserve(Values.Num());
+			for (const FTSetTestStruct& Value : Values)
+				Numbers.Add(Value.Number);
+		}
+		this->BA_Set.Reserve(this->BA_Set.Num() + Values.Num());
+		for (FTSetTestStruct& Value : Values)
+		{
+			Set_AddIndexed(MoveTemp(Value));
+		}
+		Values.Reset();
+		if (Broadcast)
+			Set_NotifyAdded(Numbers);
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Set"
+		, meta = (CompactNodeTitle = "Append"
+			, ToolTip = "Moves all Values into the set with one reservation and one notification. Values is empty afterwards"))
+	FORCEINLINE void Set_Append(UPARAM(ref) TArray<FTSetTestStruct>& Values, bool Broadcast)
+	{
+		BA_CONTAINER_SCOPE("UTSet::Set_Append");
+		Set_AppendMoved(MoveTemp(Values), Broadcast);
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Set"
+		, meta = (CompactNodeTitle = "Remove Batch"
+			, ToolTip = "Removes all given values from the set with one notification. Returns the number of removed values"))
+	FORCEINLINE int32 Set_RemoveBatch(const TArray<FTSetTestStruct>& Values, bool Broadcast)
+	{
+		BA_CONTAINER_SCOPE("UTSet::Set_RemoveBatch");
+		TArray<int32> Numbers;
+		for (const FTSetTestStruct& Value : Values)
+		{
+			const FSetElementId Id = this->BA_Set.FindId(Value);
+			if (!Id.IsValidId())
+				continue;
+			this->NameIndex.Remove(this->BA_Set[Id].Name, Id);
+			this->BA_Set.Remove(Id);
+			this->BloomFilter.Remove();
+			Numbers.Add(Value.Number);
+		}
+		if (Broadcast && Numbers.Num() > 0)
+			Set_NotifyRemoved(Numbers);
+		return Numbers.Num();
 	}
 
 	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "BA Container - Set"
@@ -135,6 +219,7 @@ public:
 			, ToolTip = "Returns the number of values within this set"))
 	FORCEINLINE int32 Set_NumberOfValues()
 	{
+		BA_CONTAINER_SCOPE("UTSet::Set_NumberOfValues");
 		return this->BA_Set.Num();
 	}
 	
@@ -143,8 +228,22 @@ public:
 			, ToolTip = "Remove an item from the set"))
 	FORCEINLINE void Set_Remove(UPARAM(ref) FTSetTestStruct& Value)
 	{
-		this->OnSetRemove_Delegate.Broadcast(true);
-		this->BA_Set.Remove(Value);
+		BA_CONTAINER_SCOPE("UTSet::Set_Remove");
+		if (!this->ChangeBatcher.IsBatched())
+			this->OnSetRemove_Delegate.Broadcast(true);
+		const FSetElementId Id = this->BA_Set.FindId(Value);
+		if (Id.IsValidId())
+		{
+			this->NameIndex.Remove(this->BA_Set[Id].Name, Id);
+			this->BA_Set.Remove(Id);
+			this->BloomFilter.Remove();
+			if (this->ChangeBatcher.IsBatched())
+				this->ChangeBatcher.Record([&Value](FContainerChangeBatch& Batch)
+				{
+					++Batch.NumRemoved;
+					Batch.RemovedNumbers.Add(Value.Number);
+				});
+		}
 	}
 
 	UFUNCTION(BlueprintCallable, Category = "BA Container - Set"
@@ -152,7 +251,10 @@ public:
 			, ToolTip = "Empties the set - set NewCapacity to zero if you dont need to reserve space for new content, otherwise provide the expected capacity"))
 	FORCEINLINE void Set_Empty(int32 NewCapacity)
 	{
+		BA_CONTAINER_SCOPE("UTSet::Set_Empty");
 		this->BA_Set.Empty(NewCapacity);
+		this->NameIndex.Reset();
+		this->BloomFilter.Invalidate();
 	}
 
 	UFUNCTION(BlueprintCallable, Category = "BA Container - Set"
@@ -160,6 +262,16 @@ public:
 			, ToolTip = "Check if a given value exists"))
 	FORCEINLINE bool Set_ItemExists(UPARAM(ref) FTSetTestStruct& Value)
 	{
+		BA_CONTAINER_SCOPE("UTSet::Set_ItemExists");
+		if (this->BloomFilter.IsEnabled())
+		{
+			Set_EnsureBloomFilter();
+			if (this->BloomFilter.Rejects(FContainerBloomFilter::Hash(Value.Number)))
+				return false;
+			const bool bFound = this->BA_Set.Contains(Value);
+			this->BloomFilter.RecordLookup(bFound);
+			return bFound;
+		}
 		return this->BA_Set.Contains(Value);
 	}
 
@@ -168,14 +280,217 @@ public:
 			, ToolTip = "Gets all values of the set"))
 	FORCEINLINE TArray<FTSetTestStruct> Set_GetAllValues()
 	{
+		BA_CONTAINER_SCOPE("UTSet::Set_GetAllValues");
 		return this->BA_Set.Array();
 	}
 
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Set"
+		, meta = (CompactNodeTitle = "Values Page"
+			, ToolTip = "Returns up to Count values starting at Offset in iteration order. Use with Number of values to page through large sets without copying all of them"))
+	FORCEINLINE TArray<FTSetTestStruct> Set_GetValuesPage(int32 Offset, int32 Count)
+	{
+		BA_CONTAINER_SCOPE("UTSet::Set_GetValuesPage");
+		TArray<FTSetTestStruct> Page;
+		if (Offset < 0 || Count <= 0 || Offset >= this->BA_Set.Num())
+			return Page;
+		Page.Reserve(FMath::Min(Count, this->BA_Set.Num() - Offset));
+		// without removed slots the element id is the position, so the page starts right at Offset
+		int32 Id = 0;
+		if (this->BA_Set.Num() == this->BA_Set.GetMaxIndex())
+		{
+			Id = Offset;
+		}
+		else
+		{
+			for (int32 Skipped = 0; Skipped < Offset || !this->BA_Set.IsValidId(FSetElementId::FromInteger(Id)); ++Id)
+			{
+				if (this->BA_Set.IsValidId(FSetElementId::FromInteger(Id)))
+					++Skipped;
+			}
+		}
+		for (; Id < this->BA_Set.GetMaxIndex() && Page.Num() < Count; ++Id)
+		{
+			const FSetElementId ElementId = FSetElementId::FromInteger(Id);
+			if (this->BA_Set.IsValidId(ElementId))
+				Page.Add(this->BA_Set[ElementId]);
+		}
+		return Page;
+	}
+
+	// Read-only access to the stored values, valid until the set is changed
+	FORCEINLINE const TSet<FTSetTestStruct>& Set_View() const
+	{
+		return this->BA_Set;
+	}
+
+	// Calls Visitor(const FTSetTestStruct&) for every value in iteration order, without copying
+	template <typename VisitorType>
+	void Set_ForEach(VisitorType&& Visitor) const
+	{
+		for (const FTSetTestStruct& Value : this->BA_Set)
+			Visitor(Value);
+	}
+
+	#pragma region Set Algebra
+
+	/**
+	 * The set algebra functions iterate the smaller set and probe the larger one.
+	 * Above SetAlgebraParallelThreshold values the iteration is split over the worker threads,
+	 * every worker walks its own range of element ids and the matches are joined in id order.
+	 * Other may be null, it counts as an empty set.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Set"
+		, meta = (CompactNodeTitle = "Union"
+			, ToolTip = "Returns a new set with the values of this set and Other. A value in both sets is taken from the larger one"))
+	FORCEINLINE UTSet* Set_Union(UTSet* Other)
+	{
+		BA_CONTAINER_SCOPE("UTSet::Set_Union");
+		UTSet* Result = NewObject<UTSet>();
+		const TSet<FTSetTestStruct>& Small = Set_SmallerOf(Other);
+		const TSet<FTSetTestStruct>& Large = &Small == &this->BA_Set ? Set_SetOf(Other) : this->BA_Set;
+		TArray<FSetElementId> Ids;
+		Set_CollectIds(Small, [&Large](const FTSetTestStruct& Value) { return !Large.Contains(Value); }, Ids);
+		Result->BA_Set = Large;
+		Result->BA_Set.Reserve(Large.Num() + Ids.Num());
+		for (const FSetElementId Id : Ids)
+			Result->BA_Set.Add(Small[Id]);
+		return Result;
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Set"
+		, meta = (CompactNodeTitle = "Intersect"
+			, ToolTip = "Returns a new set with the values that are in this set and in Other. The values are taken from the smaller set"))
+	FORCEINLINE UTSet* Set_Intersect(UTSet* Other)
+	{
+		BA_CONTAINER_SCOPE("UTSet::Set_Intersect");
+		UTSet* Result = NewObject<UTSet>();
+		const TSet<FTSetTestStruct>& Small = Set_SmallerOf(Other);
+		const TSet<FTSetTestStruct>& Large = &Small == &this->BA_Set ? Set_SetOf(Other) : this->BA_Set;
+		TArray<FSetElementId> Ids;
+		Set_CollectIds(Small, [&Large](const FTSetTestStruct& Value) { return Large.Contains(Value); }, Ids);
+		Result->BA_Set.Reserve(Ids.Num());
+		for (const FSetElementId Id : Ids)
+			Result->BA_Set.Add(Small[Id]);
+		return Result;
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Set"
+		, meta = (CompactNodeTitle = "Difference"
+			, ToolTip = "Returns a new set with the values of this set that are not in Other"))
+	FORCEINLINE UTSet* Set_Difference(UTSet* Other)
+	{
+		BA_CONTAINER_SCOPE("UTSet::Set_Difference");
+		UTSet* Result = NewObject<UTSet>();
+		const TSet<FTSetTestStruct>& OtherSet = Set_SetOf(Other);
+		TArray<FSetElementId> Ids;
+		if (this->BA_Set.Num() <= OtherSet.Num())
+		{
+			Set_CollectIds(this->BA_Set, [&OtherSet](const FTSetTestStruct& Value) { return !OtherSet.Contains(Value); }, Ids);
+			Result->BA_Set.Reserve(Ids.Num());
+			for (const FSetElementId Id : Ids)
+				Result->BA_Set.Add(this->BA_Set[Id]);
+			return Result;
+		}
+		// Other is smaller - copy this set and take out what both have
+		Set_CollectIds(OtherSet, [this](const FTSetTestStruct& Value) { return this->BA_Set.Contains(Value); }, Ids);
+		Result->BA_Set = this->BA_Set;
+		for (const FSetElementId Id : Ids)
+			Result->BA_Set.Remove(OtherSet[Id]);
+		return Result;
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Set"
+		, meta = (CompactNodeTitle = "Is Subset Of"
+			, ToolTip = "Checks whether every value of this set is in Other"))
+	FORCEINLINE bool Set_IsSubsetOf(UTSet* Other)
+	{
+		BA_CONTAINER_SCOPE("UTSet::Set_IsSubsetOf");
+		const TSet<FTSetTestStruct>& OtherSet = Set_SetOf(Other);
+		if (this->BA_Set.Num() > OtherSet.Num())
+			return false;
+		std::atomic<bool> bMissing{ false };
+		// one missing value decides it, the other workers leave their range at the next element
+		Set_ParallelForEachId(this->BA_Set, [&](FSetElementId Id, int32)
+		{
+			if (!OtherSet.Contains(this->BA_Set[Id]))
+				bMissing.store(true, std::memory_order_relaxed);
+		}, &bMissing);
+		return !bMissing.load();
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Set"
+		, meta = (CompactNodeTitle = "Union With"
+			, ToolTip = "Adds the values of Other that are not in this set, with one notification. Returns the number of added values"))
+	FORCEINLINE int32 Set_UnionWith(UTSet* Other, bool Broadcast)
+	{
+		BA_CONTAINER_SCOPE("UTSet::Set_UnionWith");
+		const TSet<FTSetTestStruct>& OtherSet = Set_SetOf(Other);
+		if (&OtherSet == &this->BA_Set)
+			return 0;
+		TArray<FSetElementId> Ids;
+		Set_CollectIds(OtherSet, [this](const FTSetTestStruct& Value) { return !this->BA_Set.Contains(Value); }, Ids);
+		TArray<int32> Numbers;
+		Numbers.Reserve(Ids.Num());
+		this->BA_Set.Reserve(this->BA_Set.Num() + Ids.Num());
+		for (const FSetElementId Id : Ids)
+		{
+			Set_AddIndexed(OtherSet[Id]);
+			Numbers.Add(OtherSet[Id].Number);
+		}
+		if (Broadcast && Numbers.Num() > 0)
+			Set_NotifyAdded(Numbers);
+		return Numbers.Num();
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Set"
+		, meta = (CompactNodeTitle = "Intersect With"
+			, ToolTip = "Removes the values that are not in Other, with one notification. Returns the number of removed values"))
+	FORCEINLINE int32 Set_IntersectWith(UTSet* Other, bool Broadcast)
+	{
+		BA_CONTAINER_SCOPE("UTSet::Set_IntersectWith");
+		const TSet<FTSetTestStruct>& OtherSet = Set_SetOf(Other);
+		if (&OtherSet == &this->BA_Set)
+			return 0;
+		// every value that goes has to be visited, so this set is walked whatever its size
+		TArray<FSetElementId> Ids;
+		Set_CollectIds(this->BA_Set, [&OtherSet](const FTSetTestStruct& Value) { return !OtherSet.Contains(Value); }, Ids);
+		return Set_RemoveIds(Ids, Broadcast);
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Set"
+		, meta = (CompactNodeTitle = "Difference With"
+			, ToolTip = "Removes the values that are in Other, with one notification. Returns the number of removed values"))
+	FORCEINLINE int32 Set_DifferenceWith(UTSet* Other, bool Broadcast)
+	{
+		BA_CONTAINER_SCOPE("UTSet::Set_DifferenceWith");
+		const TSet<FTSetTestStruct>& OtherSet = Set_SetOf(Other);
+		TArray<FSetElementId> Ids;
+		if (&OtherSet == &this->BA_Set)
+		{
+			Set_CollectIds(this->BA_Set, [](const FTSetTestStruct&) { return true; }, Ids);
+		}
+		else if (this->BA_Set.Num() <= OtherSet.Num())
+		{
+			Set_CollectIds(this->BA_Set, [&OtherSet](const FTSetTestStruct& Value) { return OtherSet.Contains(Value); }, Ids);
+		}
+		else
+		{
+			// probe this set with the smaller one, its ids are looked up after the join
+			TArray<FSetElementId> OtherIds;
+			Set_CollectIds(OtherSet, [this](const FTSetTestStruct& Value) { return this->BA_Set.Contains(Value); }, OtherIds);
+			Ids.Reserve(OtherIds.Num());
+			for (const FSetElementId Id : OtherIds)
+				Ids.Add(this->BA_Set.FindId(OtherSet[Id]));
+		}
+		return Set_RemoveIds(Ids, Broadcast);
+	}
+#pragma endregion Set Algebra
+
 	#pragma region Searching
 
 	/**
-	 * Example of a Filter Function
-	 * Add your custom filter criteria in lambda function within FilterByPredicate
+	 * Example of a prefix search
+	 * Served by the name index, so the set is neither copied nor scanned
 	 *
 	 * @StartsWith String that the Values needs to start with
 	 * @returns TArray<FTSetTestStruct>
@@ -185,28 +500,123 @@ public:
 			, ToolTip = "Returns all items with name starting like parameter given"))
 	FORCEINLINE TArray<FTSetTestStruct> Set_GetNamesStartingWith(const FString& StartsWith)
 	{
-		return this->BA_Set.Array().FilterByPredicate(
-			[StartsWith](const FTSetTestStruct& A) {
-				return A.Name.StartsWith(StartsWith, ESearchCase::IgnoreCase);
-			}
-		);
+		BA_CONTAINER_SCOPE("UTSet::Set_GetNamesStartingWith");
+		Set_EnsureNameIndex();
+		TArray<FSetElementId> Found;
+		this->NameIndex.ForEachWithPrefix(StartsWith, [&Found](FSetElementId Id)
+		{
+			Found.Add(Id);
+		});
+		// results keep the iteration order of the set
+		Found.Sort([](const FSetElementId& A, const FSetElementId& B)
+		{
+			return A.AsInteger() < B.AsInteger();
+		});
+		TArray<FTSetTestStruct> Result;
+		Result.Reserve(Found.Num());
+		for (const FSetElementId& Id : Found)
+		{
+			Result.Add(this->BA_Set[Id]);
+		}
+		return Result;
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Set"
+		, meta = (CompactNodeTitle = "Filter Numbers"
+			, ToolTip = "Returns all items with Number between Min and Max (both included), matched 64 at a time by the vectorized filter kernels"))
+	FORCEINLINE TArray<FTSetTestStruct> Set_FilterByNumber(int32 Min, int32 Max)
+	{
+		BA_CONTAINER_SCOPE("UTSet::Set_FilterByNumber");
+		TArray<FTSetTestStruct> Result;
+		FContainerFilterKernels::ForEachMatch(this->BA_Set, FContainerFilterPredicate::Between(Min, Max)
+			, [](const FTSetTestStruct& Value) { return Value.Number; }
+			, [&Result](const FTSetTestStruct& Value) { Result.Add(Value); });
+		return Result;
 	}
 
 #pragma endregion Searching
 
+	#pragma region Bloom Filter
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Set"
+		, meta = (CompactNodeTitle = "Set Bloom Filter"
+			, ToolTip = "Puts a Bloom filter on the Numbers in front of Value Exists, so most checks for absent values skip the hash probe. Sized automatically, costs about 10 bits per value"))
+	FORCEINLINE void Set_SetBloomFilterEnabled(bool Enabled)
+	{
+		this->BloomFilter.SetEnabled(Enabled);
+	}
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "BA Container - Set"
+		, meta = (CompactNodeTitle = "Bloom Filter Stats"
+			, ToolTip = "Returns how many checks the Bloom filter answered and its false positive rate since it was enabled"))
+	FORCEINLINE FContainerBloomFilterStats Set_GetBloomFilterStats()
+	{
+		return this->BloomFilter.GetStats();
+	}
+#pragma endregion Bloom Filter
+
+	#pragma region Notifications
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Set"
+		, meta = (CompactNodeTitle = "Set Notify Mode"
+			, ToolTip = "Immediate fires the add and remove delegates on every change. Batched collects the Numbers of the changed values and fires OnSetChangesFlushed once per frame"))
+	FORCEINLINE void Set_SetNotifyMode(EContainerNotifyMode Mode)
+	{
+		// leaving batched mode flushes what was recorded so far
+		this->ChangeBatcher.SetMode(Mode, this, [this]() { Set_FlushNotifications(); });
+	}
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "BA Container - Set"
+		, meta = (CompactNodeTitle = "Notify Mode"
+			, ToolTip = "Returns how changes are reported"))
+	FORCEINLINE EContainerNotifyMode Set_GetNotifyMode()
+	{
+		return this->ChangeBatcher.GetMode();
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Set"
+		, meta = (CompactNodeTitle = "Flush Notifications"
+			, ToolTip = "Fires OnSetChangesFlushed with the changes collected so far instead of waiting for the next frame"))
+	FORCEINLINE void Set_FlushNotifications()
+	{
+		FContainerChangeBatch Batch;
+		if (this->ChangeBatcher.TakePending(Batch))
+			this->OnSetChangesFlushed_Delegate.Broadcast(Batch);
+	}
+#pragma endregion Notifications
+
 #pragma endregion Public Functions
 
 	UFUNCTION(BlueprintCallable, Category = "BA Container - Set"
 		, meta = (CompactNodeTitle = "Sort Set"
-			, ToolTip = "Sort the Values as FTSetTestStruct by Enum ETestStructSorting"))
-	FORCEINLINE void Set_Sort(ETestStructSorting Sort)
+			, ToolTip = "Sort the Values as FTSetTestStruct by Enum ETestStructSorting. The parallel backend radix sorts numbers and merge sorts names on all cores"))
+	FORCEINLINE void Set_Sort(ETestStructSorting Sort, EContainerSortBackend Backend = EContainerSortBackend::E_Default)
 	{
+		BA_CONTAINER_SCOPE("UTSet::Set_Sort");
 		// Sorting with Lambda
 		//this->BA_Set.Sort([](const FTSetTestStruct& A, const FTSetTestStruct& B) {
 		//	return A.Number > B.Number;
 		//	}
 		//);
 		
+		// sorting compacts the set and gives every element a new id
+		this->NameIndex.Invalidate();
+		if (Backend == EContainerSortBackend::E_Parallel)
+		{
+			// the set keeps insertion order, so it is rebuilt in sorted order
+			TArray<FTSetTestStruct> Values;
+			Values.Reserve(this->BA_Set.Num());
+			for (FTSetTestStruct& Value : this->BA_Set)
+				Values.Add(MoveTemp(Value));
+			TArray<int32> Order;
+			const bool bDescending = Sort == ETestStructSorting::E_NumberDesc || Sort == ETestStructSorting::E_NameDesc;
+			if (Sort == ETestStructSorting::E_NameAsc || Sort == ETestStructSorting::E_NameDesc)
+				FContainerSort::NameOrder(Values, [](const FTSetTestStruct& Value) -> const FString& { return Value.Name; }, bDescending, Order);
+			else
+				FContainerSort::NumberOrder(Values, [](const FTSetTestStruct& Value) { return Value.Number; }, bDescending, Order);
+			this->BA_Set.Empty(Values.Num());
+			for (int32 Index : Order)
+				this->BA_Set.Add(MoveTemp(Values[Index]));
+			return;
+		}
 		// Better to make the search logic part of your Struct class and reference this:
 		switch (Sort)
 		{
@@ -227,4 +637,155 @@ public:
 		}
 	}
 
+private:
+	/**
+	 * Adds Value and keeps the name index in sync.
+	 * Adding an equal element replaces the stored one, so its old name has to leave the index first.
+	 */
+	template <typename ValueType>
+	void Set_AddIndexed(ValueType&& Value)
+	{
+		// a replaced value counts twice, which only brings the next rebuild a little closer
+		this->BloomFilter.Add(FContainerBloomFilter::Hash(Value.Number));
+		if (!this->NameIndex.IsValid())
+		{
+			this->BA_Set.Add(Forward<ValueType>(Value));
+			return;
+		}
+		const FSetElementId Existing = this->BA_Set.FindId(Value);
+		if (Existing.IsValidId())
+			this->NameIndex.Remove(this->BA_Set[Existing].Name, Existing);
+		const FSetElementId Id = this->BA_Set.Add(Forward<ValueType>(Value));
+		this->NameIndex.Add(this->BA_Set[Id].Name, Id);
+	}
+
+	// Fires OnSetAdd or, in batched mode, records the Numbers of the added values
+	void Set_NotifyAdded(TConstArrayView<int32> Numbers)
+	{
+		if (!this->ChangeBatcher.IsBatched())
+		{
+			this->OnSetAdd_Delegate.Broadcast(true);
+			return;
+		}
+		if (Numbers.Num() > 0)
+			this->ChangeBatcher.Record([Numbers](FContainerChangeBatch& Batch)
+			{
+				Batch.NumAdded += Numbers.Num();
+				Batch.AddedNumbers.Append(Numbers.GetData(), Numbers.Num());
+			});
+	}
+
+	// Fires OnSetRemove or, in batched mode, records the Numbers of the removed values
+	void Set_NotifyRemoved(const TArray<int32>& Numbers)
+	{
+		if (!this->ChangeBatcher.IsBatched())
+			this->OnSetRemove_Delegate.Broadcast(true);
+		else
+			this->ChangeBatcher.Record([&Numbers](FContainerChangeBatch& Batch)
+			{
+				Batch.NumRemoved += Numbers.Num();
+				Batch.RemovedNumbers.Append(Numbers);
+			});
+	}
+
+	// Removes the values with the given ids, keeps the name index in sync
+	int32 Set_RemoveIds(TConstArrayView<FSetElementId> Ids, bool Broadcast)
+	{
+		TArray<int32> Numbers;
+		Numbers.Reserve(Ids.Num());
+		for (const FSetElementId Id : Ids)
+		{
+			Numbers.Add(this->BA_Set[Id].Number);
+			this->NameIndex.Remove(this->BA_Set[Id].Name, Id);
+			this->BA_Set.Remove(Id);
+		}
+		this->BloomFilter.Remove(Numbers.Num());
+		if (Broadcast && Numbers.Num() > 0)
+			Set_NotifyRemoved(Numbers);
+		return Numbers.Num();
+	}
+
+	// the set of Other, an empty one for null
+	const TSet<FTSetTestStruct>& Set_SetOf(const UTSet* Other) const
+	{
+		static const TSet<FTSetTestStruct> Empty;
+		return Other != nullptr ? Other->BA_Set : Empty;
+	}
+
+	const TSet<FTSetTestStruct>& Set_SmallerOf(const UTSet* Other) const
+	{
+		const TSet<FTSetTestStruct>& OtherSet = Set_SetOf(Other);
+		return OtherSet.Num() < this->BA_Set.Num() ? OtherSet : this->BA_Set;
+	}
+
+	/**
+	 * Calls Function(FSetElementId, Chunk) for every element of Source.
+	 * Above SetAlgebraParallelThreshold elements the id range is split into one chunk per worker.
+	 * Once Stop is set every worker returns before its next element.
+	 */
+	template <typename FunctionType>
+	static int32 Set_ParallelForEachId(const TSet<FTSetTestStruct>& Source, FunctionType&& Function, const std::atomic<bool>* Stop = nullptr)
+	{
+		const int32 MaxIndex = Source.GetMaxIndex();
+		const int32 Workers = FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+		const int32 NumChunks = FMath::Clamp(Source.Num() / SetAlgebraParallelThreshold, 1, Workers);
+		const int32 ChunkSize = FMath::DivideAndRoundUp(MaxIndex, NumChunks);
+		ParallelFor(NumChunks, [&](int32 Chunk)
+		{
+			const int32 End = FMath::Min((Chunk + 1) * ChunkSize, MaxIndex);
+			for (int32 i = Chunk * ChunkSize; i < End; ++i)
+			{
+				if (Stop != nullptr && Stop->load(std::memory_order_relaxed))
+					return;
+				const FSetElementId Id = FSetElementId::FromInteger(i);
+				if (Source.IsValidId(Id))
+					Function(Id, Chunk);
+			}
+		}, NumChunks > 1 ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+		return NumChunks;
+	}
+
+	// Ids of all elements of Source that Predicate(const FTSetTestStruct&) accepts, in id order
+	template <typename PredicateType>
+	static void Set_CollectIds(const TSet<FTSetTestStruct>& Source, PredicateType&& Predicate, TArray<FSetElementId>& OutIds)
+	{
+		const int32 Workers = FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+		TArray<TArray<FSetElementId>> ChunkIds;
+		ChunkIds.SetNum(Workers);
+		const int32 NumChunks = Set_ParallelForEachId(Source, [&](FSetElementId Id, int32 Chunk)
+		{
+			if (Predicate(Source[Id]))
+				ChunkIds[Chunk].Add(Id);
+		});
+		int32 NumIds = 0;
+		for (int32 Chunk = 0; Chunk < NumChunks; ++Chunk)
+			NumIds += ChunkIds[Chunk].Num();
+		OutIds.Reset(NumIds);
+		for (int32 Chunk = 0; Chunk < NumChunks; ++Chunk)
+			OutIds.Append(ChunkIds[Chunk]);
+	}
+
+	// Refills the Bloom filter if it is stale or too full
+	void Set_EnsureBloomFilter()
+	{
+		if (!this->BloomFilter.NeedsRebuild())
+			return;
+		this->BloomFilter.Rebuild(this->BA_Set.Num(), [this](FContainerBloomFilter& Filter)
+		{
+			for (const FTSetTestStruct& Value : this->BA_Set)
+				Filter.Add(FContainerBloomFilter::Hash(Value.Number));
+		});
+	}
+
+	// Builds the name index if an operation dropped it
+	void Set_EnsureNameIndex()
+	{
+		if (this->NameIndex.IsValid())
+			return;
+		this->NameIndex.Reset(this->BA_Set.Num());
+		for (auto It = this->BA_Set.CreateConstIterator(); It; ++It)
+		{
+			this->NameIndex.Add(It->Name, It.GetId());
+		}
+	}
 };
@@ -0,0 +1,431 @@
+// Developer Bastian © 2024
+// License Creative Commons DEED 4.0 (https://creativecommons.org/licenses/by-sa/4.0/deed.en)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "TSet.h"
+#include "SortedChunkArray.h"
+#include "ContainerProfiler.h"
+#include "ContainerChangeBatch.h"
+
+#include "TSortedSet.generated.h"
+
+/**
+ * Class to encapsulate an ordered set of FTSetTestStruct.
+ *
+ * UTSet::Set_Sort only reorders the hash set until the next change. This set keeps its values
+ * in a TSortedChunkArray, ordered by one of the FTSetTestStruct Compare statics, so the order
+ * survives every add and remove: inserts and removes are O(log n) plus a move inside one chunk,
+ * iteration is in order and ranges are found with two binary searches.
+ *
+ * Values are identified by their Number, like in UTSet - adding a value with a Number that is
+ * already in the set replaces the stored value.
+ */
+UCLASS(BlueprintType, Transient)
+class UTSortedSet : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	using FCompare = bool (*)(const FTSetTestStruct&, const FTSetTestStruct&);
+	using FSortedValues = TSortedChunkArray<FTSetTestStruct, FCompare>;
+
+	UTSortedSet()
+		: Values(&FTSetTestStruct::CompareNumberAscending)
+	{}
+
+	#pragma region Delegates
+
+	UPROPERTY(BlueprintAssignable, Category = "BA Container - Sorted Set"
+		, meta = (ToolTip = "Delegate to indicate values were added to the sorted set"))
+	FOnSetChanged OnSortedSetAdd_Delegate;
+
+	UPROPERTY(BlueprintAssignable, Category = "BA Container - Sorted Set"
+		, meta = (ToolTip = "Delegate to indicate values were removed from the sorted set"))
+	FOnSetChanged OnSortedSetRemove_Delegate;
+
+	UPROPERTY(BlueprintAssignable, Category = "BA Container - Sorted Set"
+		, meta = (ToolTip = "Delegate with the changes of the last frame, only fired in batched notify mode. AddedNumbers and RemovedNumbers hold the Number of the changed values"))
+	FOnContainerChangesFlushed OnSortedSetChangesFlushed_Delegate;
+
+#pragma endregion Delegates
+
+private:
+	FSortedValues Values;
+	ETestStructSorting Order = ETestStructSorting::E_NumberAsc;
+
+	// Number -> stored Name, identifies values like UTSet does and lets a name ordered set find a value by its Number
+	TMap<int32, FString> Members;
+
+	// pending changes while in batched notify mode
+	FContainerChangeBatcher ChangeBatcher;
+
+public:
+
+	#pragma region Public Functions
+
+	#pragma region Order
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Sorted Set"
+		, meta = (CompactNodeTitle = "Set Order"
+			, ToolTip = "Sets the order the values are kept in. Changing it re-sorts the set once"))
+	FORCEINLINE void SortedSet_SetOrder(ETestStructSorting NewOrder)
+	{
+		BA_CONTAINER_SCOPE("UTSortedSet::SortedSet_SetOrder");
+		if (NewOrder == this->Order)
+			return;
+		TArray<FTSetTestStruct> All;
+		All.Reserve(this->Values.Num());
+		this->Values.ForEach([&All](const FTSetTestStruct& Value) { All.Add(Value); });
+		this->Order = NewOrder;
+		this->Values = FSortedValues(GetCompare(NewOrder));
+		this->Values.Build(MoveTemp(All));
+	}
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "BA Container - Sorted Set"
+		, meta = (CompactNodeTitle = "Order"
+			, ToolTip = "Returns the order the values are kept in"))
+	FORCEINLINE ETestStructSorting SortedSet_GetOrder()
+	{
+		return this->Order;
+	}
+#pragma endregion Order
+
+	#pragma region Add and Remove
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Sorted Set"
+		, meta = (CompactNodeTitle = "Add"
+			, ToolTip = "Adds a value at its place in the order. A value with the same Number is replaced"))
+	FORCEINLINE void SortedSet_Add(UPARAM(ref) FTSetTestStruct& Value)
+	{
+		BA_CONTAINER_SCOPE("UTSortedSet::SortedSet_Add");
+		SortedSet_Insert(Value);
+		SortedSet_NotifyAdded(MakeArrayView(&Value.Number, 1));
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Sorted Set"
+		, meta = (CompactNodeTitle = "Append"
+			, ToolTip = "Moves all Values into the sorted set with one notification. Large batches are sorted once instead of inserted one by one. Values is empty afterwards"))
+	FORCEINLINE void SortedSet_Append(UPARAM(ref) TArray<FTSetTestStruct>& NewValues, bool Broadcast)
+	{
+		BA_CONTAINER_SCOPE("UTSortedSet::SortedSet_Append");
+		TArray<int32> Numbers;
+		if (Broadcast && this->ChangeBatcher.IsBatched())
+		{
+			Numbers.Reserve(NewValues.Num());
+			for (const FTSetTestStruct& Value : NewValues)
+				Numbers.Add(Value.Number);
+		}
+		// more than an eighth of the set - one sort of everything beats that many single inserts
+		if (NewValues.Num() > this->Values.Num() / 8)
+		{
+			TArray<FTSetTestStruct> All;
+			All.Reserve(this->Values.Num() + NewValues.Num());
+			TSet<int32> BatchNumbers;
+			BatchNumbers.Reserve(NewValues.Num());
+			// newest first, so a Number given twice in the batch keeps its last value
+			for (int32 i = NewValues.Num() - 1; i >= 0; --i)
+			{
+				bool bInBatch = false;
+				BatchNumbers.Add(NewValues[i].Number, &bInBatch);
+				if (bInBatch)
+					continue;
+				SortedSet_RemoveNumber(NewValues[i].Number);
+				this->Members.Add(NewValues[i].Number, NewValues[i].Name);
+				All.Add(MoveTemp(NewValues[i]));
+			}
+			this->Values.ForEach([&All](const FTSetTestStruct& Value) { All.Add(Value); });
+			this->Values.Build(MoveTemp(All));
+		}
+		else
+		{
+			for (const FTSetTestStruct& Value : NewValues)
+				SortedSet_Insert(Value);
+		}
+		NewValues.Reset();
+		if (Broadcast)
+			SortedSet_NotifyAdded(Numbers);
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Sorted Set"
+		, meta = (CompactNodeTitle = "Remove"
+			, ToolTip = "Removes the value with the Number of Value. Returns false if there is none"))
+	FORCEINLINE bool SortedSet_Remove(UPARAM(ref) FTSetTestStruct& Value)
+	{
+		BA_CONTAINER_SCOPE("UTSortedSet::SortedSet_Remove");
+		if (!SortedSet_RemoveNumber(Value.Number))
+			return false;
+		if (!this->ChangeBatcher.IsBatched())
+			this->OnSortedSetRemove_Delegate.Broadcast(true);
+		else
+			this->ChangeBatcher.Record([&Value](FContainerChangeBatch& Batch)
+			{
+				++Batch.NumRemoved;
+				Batch.RemovedNumbers.Add(Value.Number);
+			});
+		return true;
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Sorted Set"
+		, meta = (CompactNodeTitle = "Empty"
+			, ToolTip = "Empties the sorted set"))
+	FORCEINLINE void SortedSet_Empty()
+	{
+		BA_CONTAINER_SCOPE("UTSortedSet::SortedSet_Empty");
+		this->Values.Reset();
+		this->Members.Reset();
+	}
+#pragma endregion Add and Remove
+
+	#pragma region Find and Count
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "BA Container - Sorted Set"
+		, meta = (CompactNodeTitle = "Number of values"
+			, ToolTip = "Returns the number of values within this sorted set"))
+	FORCEINLINE int32 SortedSet_NumberOfValues()
+	{
+		return this->Values.Num();
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Sorted Set"
+		, meta = (CompactNodeTitle = "Value Exists"
+			, ToolTip = "Check if a value with the Number of Value exists"))
+	FORCEINLINE bool SortedSet_ItemExists(UPARAM(ref) FTSetTestStruct& Value)
+	{
+		BA_CONTAINER_SCOPE("UTSortedSet::SortedSet_ItemExists");
+		return this->Members.Contains(Value.Number);
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Sorted Set"
+		, meta = (CompactNodeTitle = "First"
+			, ToolTip = "Gets the first value in order. Returns false if the set is empty"))
+	FORCEINLINE bool SortedSet_First(FTSetTestStruct& Value)
+	{
+		if (this->Values.Num() == 0)
+			return false;
+		Value = this->Values.Get(this->Values.Begin());
+		return true;
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Sorted Set"
+		, meta = (CompactNodeTitle = "Last"
+			, ToolTip = "Gets the last value in order. Returns false if the set is empty"))
+	FORCEINLINE bool SortedSet_Last(FTSetTestStruct& Value)
+	{
+		if (this->Values.Num() == 0)
+			return false;
+		Value = this->Values.Get(this->Values.Prev(this->Values.End()));
+		return true;
+	}
+
+	/**
+	 * The bound and range functions compare by the field of the current order only -
+	 * Key needs the Number for a number order and the Name for a name order.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Sorted Set"
+		, meta = (CompactNodeTitle = "Lower Bound"
+			, ToolTip = "Gets the first value that does not come before Key in the current order. Returns false if there is none"))
+	FORCEINLINE bool SortedSet_LowerBound(const FTSetTestStruct& Key, FTSetTestStruct& Value)
+	{
+		BA_CONTAINER_SCOPE("UTSortedSet::SortedSet_LowerBound");
+		const FSortedValues::FPosition Position = this->Values.LowerBound(Key);
+		if (Position == this->Values.End())
+			return false;
+		Value = this->Values.Get(Position);
+		return true;
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Sorted Set"
+		, meta = (CompactNodeTitle = "Upper Bound"
+			, ToolTip = "Gets the first value that comes after Key in the current order. Returns false if there is none"))
+	FORCEINLINE bool SortedSet_UpperBound(const FTSetTestStruct& Key, FTSetTestStruct& Value)
+	{
+		BA_CONTAINER_SCOPE("UTSortedSet::SortedSet_UpperBound");
+		const FSortedValues::FPosition Position = this->Values.UpperBound(Key);
+		if (Position == this->Values.End())
+			return false;
+		Value = this->Values.Get(Position);
+		return true;
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Sorted Set"
+		, meta = (CompactNodeTitle = "Count Range"
+			, ToolTip = "Returns the number of values from From to To, both included, in the current order"))
+	FORCEINLINE int32 SortedSet_CountRange(const FTSetTestStruct& From, const FTSetTestStruct& To)
+	{
+		BA_CONTAINER_SCOPE("UTSortedSet::SortedSet_CountRange");
+		FSortedValues::FPosition First, Last;
+		if (!SortedSet_FindRange(From, To, First, Last))
+			return 0;
+		return this->Values.CountInRange(First, Last);
+	}
+#pragma endregion Find and Count
+
+	#pragma region Get Values
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Sorted Set"
+		, meta = (CompactNodeTitle = "Get All Values"
+			, ToolTip = "Gets all values in order"))
+	FORCEINLINE TArray<FTSetTestStruct> SortedSet_GetAllValues()
+	{
+		BA_CONTAINER_SCOPE("UTSortedSet::SortedSet_GetAllValues");
+		TArray<FTSetTestStruct> All;
+		All.Reserve(this->Values.Num());
+		this->Values.ForEach([&All](const FTSetTestStruct& Value) { All.Add(Value); });
+		return All;
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Sorted Set"
+		, meta = (CompactNodeTitle = "Get Range"
+			, ToolTip = "Gets the values from From to To, both included, in the current order"))
+	FORCEINLINE TArray<FTSetTestStruct> SortedSet_GetRange(const FTSetTestStruct& From, const FTSetTestStruct& To)
+	{
+		BA_CONTAINER_SCOPE("UTSortedSet::SortedSet_GetRange");
+		TArray<FTSetTestStruct> Range;
+		FSortedValues::FPosition First, Last;
+		if (!SortedSet_FindRange(From, To, First, Last))
+			return Range;
+		Range.Reserve(this->Values.CountInRange(First, Last));
+		this->Values.ForEachInRange(First, Last, [&Range](const FTSetTestStruct& Value) { Range.Add(Value); });
+		return Range;
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Sorted Set"
+		, meta = (CompactNodeTitle = "Number Range"
+			, ToolTip = "Gets the values with Min <= Number <= Max in the current order. Uses the order if the set is ordered by Number, otherwise scans all values"))
+	FORCEINLINE TArray<FTSetTestStruct> SortedSet_GetNumberRange(int32 Min, int32 Max)
+	{
+		BA_CONTAINER_SCOPE("UTSortedSet::SortedSet_GetNumberRange");
+		if (this->Order == ETestStructSorting::E_NumberAsc || this->Order == ETestStructSorting::E_NumberDesc)
+		{
+			FTSetTestStruct From, To;
+			From.Number = this->Order == ETestStructSorting::E_NumberAsc ? Min : Max;
+			To.Number = this->Order == ETestStructSorting::E_NumberAsc ? Max : Min;
+			return SortedSet_GetRange(From, To);
+		}
+		TArray<FTSetTestStruct> Range;
+		this->Values.ForEach([&Range, Min, Max](const FTSetTestStruct& Value)
+		{
+			if (Value.Number >= Min && Value.Number <= Max)
+				Range.Add(Value);
+		});
+		return Range;
+	}
+
+	// Read-only access to the ordered values, valid until the set is changed
+	FORCEINLINE const FSortedValues& SortedSet_View() const
+	{
+		return this->Values;
+	}
+
+	// Calls Visitor(const FTSetTestStruct&) for every value in order, without copying
+	template <typename VisitorType>
+	void SortedSet_ForEach(VisitorType&& Visitor) const
+	{
+		this->Values.ForEach(Forward<VisitorType>(Visitor));
+	}
+
+	// Calls Visitor(const FTSetTestStruct&) for the values from From to To, both included, without copying
+	template <typename VisitorType>
+	void SortedSet_ForEachInRange(const FTSetTestStruct& From, const FTSetTestStruct& To, VisitorType&& Visitor) const
+	{
+		FSortedValues::FPosition First, Last;
+		if (SortedSet_FindRange(From, To, First, Last))
+			this->Values.ForEachInRange(First, Last, Forward<VisitorType>(Visitor));
+	}
+#pragma endregion Get Values
+
+	#pragma region Notifications
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Sorted Set"
+		, meta = (CompactNodeTitle = "Set Notify Mode"
+			, ToolTip = "Immediate fires the add and remove delegates on every change. Batched collects the changes and fires OnSortedSetChangesFlushed once per frame"))
+	FORCEINLINE void SortedSet_SetNotifyMode(EContainerNotifyMode Mode)
+	{
+		// leaving batched mode flushes what was recorded so far
+		this->ChangeBatcher.SetMode(Mode, this, [this]() { SortedSet_FlushNotifications(); });
+	}
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "BA Container - Sorted Set"
+		, meta = (CompactNodeTitle = "Notify Mode"
+			, ToolTip = "Returns how changes are reported"))
+	FORCEINLINE EContainerNotifyMode SortedSet_GetNotifyMode()
+	{
+		return this->ChangeBatcher.GetMode();
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Sorted Set"
+		, meta = (CompactNodeTitle = "Flush Notifications"
+			, ToolTip = "Fires OnSortedSetChangesFlushed with the changes collected so far instead of waiting for the next frame"))
+	FORCEINLINE void SortedSet_FlushNotifications()
+	{
+		FContainerChangeBatch Batch;
+		if (this->ChangeBatcher.TakePending(Batch))
+			this->OnSortedSetChangesFlushed_Delegate.Broadcast(Batch);
+	}
+#pragma endregion Notifications
+
+#pragma endregion Public Functions
+
+private:
+	static FCompare GetCompare(ETestStructSorting Sorting)
+	{
+		switch (Sorting)
+		{
+		case ETestStructSorting::E_NumberDesc:
+			return &FTSetTestStruct::CompareNumberDescending;
+		case ETestStructSorting::E_NameAsc:
+			return &FTSetTestStruct::CompareNameAscending;
+		case ETestStructSorting::E_NameDesc:
+			return &FTSetTestStruct::CompareNameDescending;
+		default:
+			return &FTSetTestStruct::CompareNumberAscending;
+		}
+	}
+
+	// Inserts Value, a stored value with the same Number is replaced
+	void SortedSet_Insert(const FTSetTestStruct& Value)
+	{
+		if (this->Members.Contains(Value.Number))
+			SortedSet_RemoveNumber(Value.Number);
+		this->Members.Add(Value.Number, Value.Name);
+		this->Values.Insert(Value);
+	}
+
+	// Removes the value with Number, found through its stored Name as a name order needs it
+	bool SortedSet_RemoveNumber(int32 Number)
+	{
+		FString Name;
+		if (!this->Members.RemoveAndCopyValue(Number, Name))
+			return false;
+		FTSetTestStruct Key;
+		Key.Name = MoveTemp(Name);
+		Key.Number = Number;
+		// several names or numbers can compare equivalent, the Number picks the right one
+		return this->Values.Remove(Key, [Number](const FTSetTestStruct& Candidate) { return Candidate.Number == Number; });
+	}
+
+	// [First, Last) of the values from From to To, false if the range is empty
+	bool SortedSet_FindRange(const FTSetTestStruct& From, const FTSetTestStruct& To, FSortedValues::FPosition& First, FSortedValues::FPosition& Last) const
+	{
+		const FCompare Compare = GetCompare(this->Order);
+		if (Compare(To, From))
+			return false;
+		First = this->Values.LowerBound(From);
+		Last = this->Values.UpperBound(To);
+		return First != Last;
+	}
+
+	// Fires OnSortedSetAdd or, in batched mode, records the Numbers of the added values
+	void SortedSet_NotifyAdded(TConstArrayView<int32> Numbers)
+	{
+		if (!this->ChangeBatcher.IsBatched())
+		{
+			this->OnSortedSetAdd_Delegate.Broadcast(true);
+			return;
+		}
+		if (Numbers.Num() > 0)
+			this->ChangeBatcher.Record([Numbers](FContainerChangeBatch& Batch)
+			{
+				Batch.NumAdded += Numbers.Num();
+				Batch.AddedNumbers.Append(Numbers.GetData(), Numbers.Num());
+			});
+	}
+};
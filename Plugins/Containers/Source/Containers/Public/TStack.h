@@ -0,0 +1,243 @@
+// Developer Bastian © 2024
+// License Creative Commons DEED 4.0 (https://creativecommons.org/licenses/by-sa/4.0/deed.en)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "LockFreePeekableStack.h"
+#include "ContainerProfiler.h"
+#include "ContainerChangeBatch.h"
+#include <atomic>
+
+#include "TStack.generated.h"
+
+/**
+ * Struct to showcase the TStack.
+ */
+USTRUCT(BlueprintType)
+struct FStackTestStruct
+{
+public:
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Test Struct")
+	FString Name;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Test Struct")
+	int32 Number;
+
+	FStackTestStruct() : Name(""), Number(0)
+	{
+	}
+};
+
+/**
+ * Delegates to indicate stack changes
+ */
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnStackChanged, bool, changed);
+
+
+/**
+ * Class to encapsulate a lock-free stack (first in, last out).
+ * TLockFreePeekableStack keeps the items in pooled nodes, so a steady push/pop workload does not
+ * allocate, and reads the top in place for Peek.
+ * All functions are safe to call from any number of threads and none of them waits for another.
+ */
+UCLASS(BlueprintType, Transient)
+class UTStack : public UObject
+{
+	GENERATED_BODY()
+
+public:
+
+	UTStack()
+	{}
+
+	#pragma region Delegates
+
+	UPROPERTY(BlueprintAssignable, Category = "BA Container - Stack"
+		, meta = (ToolTip = "Delegate to indicate push event on stack"))
+	FOnStackChanged OnStack_Push_Delegate;
+
+	UPROPERTY(BlueprintAssignable, Category = "BA Container - Stack"
+		, meta = (ToolTip = "Delegate to indicate pop event on stack"))
+	FOnStackChanged OnStack_Pop_Delegate;
+
+	UPROPERTY(BlueprintAssignable, Category = "BA Container - Stack"
+		, meta = (ToolTip = "Delegate with the number of pushed and popped items of the last frame, only fired in batched notify mode"))
+	FOnContainerChangesFlushed OnStackChangesFlushed_Delegate;
+
+#pragma endregion Delegates
+
+private:
+	TLockFreePeekableStack<FStackTestStruct> BA_Stack;
+	std::atomic<int32> Size{ 0 };
+
+	// pending changes while in batched notify mode
+	FContainerChangeBatcher ChangeBatcher;
+
+public:
+
+	#pragma region Public Functions
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Stack"
+		, meta = (CompactNodeTitle = "Push to Stack"
+			, ToolTip = "Adds an item on top of the stack"))
+	FORCEINLINE void Push(UPARAM(ref) FStackTestStruct& Item)
+	{
+		BA_CONTAINER_SCOPE("UTStack::Push");
+		Stack_PushNode(Item);
+		Stack_NotifyPushed(1);
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Stack"
+		, meta = (CompactNodeTitle = "Pop from Stack"
+			, ToolTip = "Removes the top item of the stack. Returns false if the stack was empty"))
+	FORCEINLINE bool Pop(FStackTestStruct& Item)
+	{
+		BA_CONTAINER_SCOPE("UTStack::Pop");
+		if (!Stack_PopNode(Item))
+			return false;
+		Stack_NotifyPopped(1);
+		return true;
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Stack"
+		, meta = (CompactNodeTitle = "Peek Stack"
+			, ToolTip = "Returns the top item without removing it. Pushes and pops on other threads go on meanwhile"))
+	FORCEINLINE FStackTestStruct Peek()
+	{
+		BA_CONTAINER_SCOPE("UTStack::Peek");
+		FStackTestStruct Item;
+		this->BA_Stack.Peek(Item);
+		return Item;
+	}
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "BA Container - Stack"
+		, meta = (CompactNodeTitle = "Stack Empty?"
+			, ToolTip = "Checks whether the stack is empty"))
+	FORCEINLINE bool IsEmpty()
+	{
+		BA_CONTAINER_SCOPE("UTStack::IsEmpty");
+		return this->BA_Stack.IsEmpty();
+	}
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "BA Container - Stack"
+		, meta = (CompactNodeTitle = "Number of items"
+			, ToolTip = "Returns the number of items on the stack - a snapshot while other threads push or pop"))
+	FORCEINLINE int32 Stack_Num()
+	{
+		return FMath::Max(this->Size.load(std::memory_order_relaxed), 0);
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Stack"
+		, meta = (CompactNodeTitle = "Push Batch"
+			, ToolTip = "Pushes all Items in order - the last one ends up on top - with one notification. Items is empty afterwards"))
+	FORCEINLINE int32 PushBatch(UPARAM(ref) TArray<FStackTestStruct>& Items)
+	{
+		BA_CONTAINER_SCOPE("UTStack::PushBatch");
+		const int32 NumPushed = Items.Num();
+		for (FStackTestStruct& Item : Items)
+			Stack_PushNode(MoveTemp(Item));
+		Items.Reset();
+		Stack_NotifyPushed(NumPushed);
+		return NumPushed;
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Stack"
+		, meta = (CompactNodeTitle = "Pop Batch"
+			, ToolTip = "Pops up to MaxItems items, top first, with one notification"))
+	FORCEINLINE TArray<FStackTestStruct> PopBatch(int32 MaxItems)
+	{
+		BA_CONTAINER_SCOPE("UTStack::PopBatch");
+		TArray<FStackTestStruct> Items;
+		Items.Reserve(FMath::Clamp(MaxItems, 0, Stack_Num()));
+		FStackTestStruct Item;
+		while (Items.Num() < MaxItems && Stack_PopNode(Item))
+			Items.Add(MoveTemp(Item));
+		Stack_NotifyPopped(Items.Num());
+		return Items;
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Stack"
+		, meta = (CompactNodeTitle = "Pop All"
+			, ToolTip = "Takes the whole stack in one atomic step and returns its items, top first"))
+	FORCEINLINE TArray<FStackTestStruct> PopAll()
+	{
+		BA_CONTAINER_SCOPE("UTStack::PopAll");
+		TArray<FStackTestStruct> Items;
+		Items.Reserve(Stack_Num());
+		this->Size.fetch_sub(this->BA_Stack.PopAll(Items), std::memory_order_relaxed);
+		Stack_NotifyPopped(Items.Num());
+		return Items;
+	}
+
+	#pragma region Notifications
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Stack"
+		, meta = (CompactNodeTitle = "Set Notify Mode"
+			, ToolTip = "Immediate fires the push and pop delegates on every call. Batched counts them and fires OnStackChangesFlushed once per frame on the game thread"))
+	FORCEINLINE void SetNotifyMode(EContainerNotifyMode Mode)
+	{
+		// leaving batched mode flushes what was recorded so far
+		this->ChangeBatcher.SetMode(Mode, this, [this]() { FlushNotifications(); });
+	}
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "BA Container - Stack"
+		, meta = (CompactNodeTitle = "Notify Mode"
+			, ToolTip = "Returns how changes are reported"))
+	FORCEINLINE EContainerNotifyMode GetNotifyMode()
+	{
+		return this->ChangeBatcher.GetMode();
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "BA Container - Stack"
+		, meta = (CompactNodeTitle = "Flush Notifications"
+			, ToolTip = "Fires OnStackChangesFlushed with the changes counted so far instead of waiting for the next frame"))
+	FORCEINLINE void FlushNotifications()
+	{
+		FContainerChangeBatch Batch;
+		if (this->ChangeBatcher.TakePending(Batch))
+			this->OnStackChangesFlushed_Delegate.Broadcast(Batch);
+	}
+#pragma endregion Notifications
+
+#pragma endregion Public Functions
+
+private:
+	// Push and pop on the lock-free stack, keeping Size in step
+	template <typename ItemType>
+	void Stack_PushNode(ItemType&& Item)
+	{
+		this->BA_Stack.Push(Forward<ItemType>(Item));
+		this->Size.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	bool Stack_PopNode(FStackTestStruct& OutItem)
+	{
+		if (!this->BA_Stack.Pop(OutItem))
+			return false;
+		this->Size.fetch_sub(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	void Stack_NotifyPushed(int32 Count)
+	{
+		if (Count <= 0)
+			return;
+		if (!this->ChangeBatcher.IsBatched())
+			this->OnStack_Push_Delegate.Broadcast(true);
+		else
+			this->ChangeBatcher.Record([Count](FContainerChangeBatch& Batch) { Batch.NumAdded += Count; });
+	}
+
+	void Stack_NotifyPopped(int32 Count)
+	{
+		if (Count <= 0)
+			return;
+		if (!this->ChangeBatcher.IsBatched())
+			this->OnStack_Pop_Delegate.Broadcast(true);
+		else
+			this->ChangeBatcher.Record([Count](FContainerChangeBatch& Batch) { Batch.NumRemoved += Count; });
+	}
+};
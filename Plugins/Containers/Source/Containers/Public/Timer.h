@@ -3,16 +3,31 @@
 
 #pragma once
 #include <chrono>
-using namespace std::chrono;
 
+/**
+ * Small stop watch for a single start/stop pair.
+ * Uses steady_clock, which never jumps with wall clock changes and ticks in nanoseconds.
+ * For accumulated, nested measurements use BA_CONTAINER_SCOPE from ContainerProfiler.h.
+ */
 class Timer {
-  time_point<high_resolution_clock> t1;
+  std::chrono::steady_clock::time_point t1;
 
 public:
-  void Start() { t1 = high_resolution_clock::now(); }
+  static uint64 NowNanoseconds() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
 
+  void Start() { t1 = std::chrono::steady_clock::now(); }
+
+  // elapsed nanoseconds since Start()
+  uint64 StopNanoseconds() {
+    auto t2 = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count();
+  }
+
+  // elapsed microseconds since Start(), keeps the sub-microsecond fraction
   float Stop() {
-    auto t2 = high_resolution_clock::now();
-    return duration_cast<microseconds>(t2 - t1).count();
-}
-};
\ No newline at end of file
+    return StopNanoseconds() / 1000.0;
+  }
+};